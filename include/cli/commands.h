@@ -3,6 +3,7 @@
 #include <stddef.h>     // size_t
 
 #include "core/ds/strings.h"    // string_t
+#include "core/ds/vector.h"     // VECTOR_DEFINE
 #include "cli/args.h"   // cli_option_set_t
 
 typedef int (*command_handler_t)(int argc, char** argv, void* userdata);
@@ -16,10 +17,7 @@ typedef struct {
     void* userdata;
 } command_t;
 
-typedef struct {
-    command_t* items;
-    size_t count;
-} command_list_t;
+VECTOR_DEFINE(command_list, command_t)
 
 command_t* new_command(
     char* name,
@@ -8,6 +8,7 @@
 #include "core/lang/source.h"       // source_manager_t
 
 #include "compiler/frontend/ast.h" // ast_t
+#include "compiler/frontend/lexer/literals.h"   // literal_table_t
 
 typedef struct compiler_context compiler_context_t;
 
@@ -29,6 +30,7 @@ typedef struct {
     bool debug;
     bool verbose;
     bool repl;
+    bool dump_tokens;   // DEBUG builds print every token the lexer returns
     enum {NONE, SOFT, HARD} optimization;
 } compiler_option_t;
 
@@ -52,6 +54,7 @@ struct compiler_context {
     compiler_memory_t memory;
 
     report_table_t* reports;
+    literal_table_t literals;   // numeric literal values, tokens and literal nodes refer to them by id
 
     ast_t* ast;
     symbol_table_t* symbols;
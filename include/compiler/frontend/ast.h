@@ -1,173 +1,177 @@
 #pragma once
 
 #include <stddef.h>     // size_t
+#include <stdint.h>     // uint8_t, uint16_t, uint32_t
 #include <stdbool.h>    // bool
 
 #include "core/ds/arena.h"      // arena_t
-#include "core/ds/strings.h"    // string_t
+#include "core/ds/vector.h"     // VECTOR_DEFINE
+#include "core/ds/strings.h"    // atom_t, string_pool_t
 #include "core/lang/source.h"   // location_t
 
-typedef struct node node_t;
+#include "compiler/frontend/lexer/literals.h"   // const_id_t
 
+#define AST_DEF_CAPACITY 256    // nodes allocated up front, the extra array starts at the same size
+
+#define NODE_NONE 0
+
+// node id: index + 1 in the node array of the ast that produced it
+typedef uint32_t node_id_t;
+
+// `count` items of the ast's extra array starting at `start`, node ids
+// or, for imports, atoms
 typedef struct {
-    node_t** elems;
-    size_t count;
-    size_t capacity;
-} nodes_t;
+    uint32_t start;
+    uint32_t count;
+} node_list_t;
+
+// list items are collected here while they are parsed
+VECTOR_DEFINE(nodes, node_id_t)
 
 struct node_binop {
-    node_t* left;
-    node_t* right;
-    int operator;
-#ifdef DEBUG
-    const char* lit;
-#endif
+    node_id_t left;
+    node_id_t right;
+    uint16_t operator;
 };
 
 struct node_unaryop {
-    node_t* right;
-    int operator;
+    node_id_t right;
+    uint16_t operator;
     bool is_postfix;
-#ifdef DEBUG
-    const char* lit;
-#endif
 };
 
 struct node_var_assign {
-    string_t name;
-    node_t* value;
+    atom_t name;
+    node_id_t value;
 };
 
 struct node_var_ref {
-    string_t name;
+    atom_t name;
 };
 
 struct node_block {
-    nodes_t statement;
+    node_list_t statement;
 };
 
 struct node_func_call {
-    string_t name;
-    nodes_t args;
+    atom_t name;
+    node_list_t args;
 };
 
 struct node_return {
-    node_t* body;
+    node_id_t body;
 };
 
 struct node_literal {
-    int type;
-    string_t value;
+    uint16_t type;
+    atom_t value;
+    const_id_t constant;    // decoded value of numbers, CONST_NONE for the other literals
 };
 
 struct node_range {
-    node_t* start;
-    node_t* end;
+    node_id_t start;
+    node_id_t end;
 };
 
 struct node_variable {
-    int modif;
-    string_t name;
-    int dtype;
-    node_t* value;
+    uint16_t modif;
+    uint16_t dtype;
+    atom_t name;
+    node_id_t value;
 };
 
 struct node_array {
-    node_t** elements;
-    size_t count;
-    size_t capacity;
+    node_list_t elements;
 };
 
 struct node_if {
-    node_t* condition;
-    node_t* then_block;
-    node_t* elif_blocks;
-    node_t* else_block;
+    node_id_t condition;
+    node_id_t then_block;
+    node_id_t elif_blocks;
+    node_id_t else_block;
 };
 
 struct node_while {
-    node_t* condition;
-    node_t* body;
+    node_id_t condition;
+    node_id_t body;
 };
 
 struct node_for {
-    node_t* init;
-    node_t* condition;
-    node_t* update;
-    node_t* body;
+    node_id_t init;
+    node_id_t condition;
+    node_id_t update;
+    node_id_t body;
 };
 
 struct node_param {
-    string_t name;
+    atom_t name;
     bool is_variadic;
-    int dtype;
+    uint16_t dtype;
 };
 
 struct node_func {
-    string_t name;
-    nodes_t param_decl;
-    int return_type;
-    node_t* body;
+    atom_t name;
+    node_list_t param_decl;
+    uint16_t return_type;
+    node_id_t body;
 };
 
 struct node_case {
-    node_t* condition;
-    node_t* body;
+    node_id_t condition;
+    node_id_t body;
 };
 
 struct node_match {
-    node_t* target;
-    nodes_t block;
+    node_id_t target;
+    node_list_t block;
 };
 
 struct node_struct {
-    string_t name;
-    nodes_t member;
+    atom_t name;
+    node_list_t member;
 };
 
 struct node_variant {
-    string_t name;
-    node_t* value;
+    atom_t name;
+    node_id_t value;
 };
 
 struct node_enum {
-    string_t name;
-    nodes_t member;
+    atom_t name;
+    node_list_t member;
 };
 
 struct node_trait {
-    string_t name;
-    node_t* body;
+    atom_t name;
+    node_id_t body;
 };
 
 struct node_impl {
-    string_t trait_name;
-    string_t struct_name;
-    node_t* body;
+    atom_t trait_name;
+    atom_t struct_name;
+    node_id_t body;
 };
 
 struct node_try {
-    node_t* try_block;
+    node_id_t try_block;
 };
 
 struct node_catch {
-    node_t* catch_block;
+    node_id_t catch_block;
 };
 
 struct node_type {
-    string_t name;
-    node_t* body;
+    atom_t name;
+    node_id_t body;
 };
 
 struct node_module {
-    string_t name;
-    node_t* body;
+    atom_t name;
+    node_id_t body;
 };
 
 struct node_import {
-    string_t* modules;
-    size_t count;
-    size_t capacity;
+    node_list_t modules;
 };
 
 enum node_kind {
@@ -183,53 +187,81 @@ enum node_kind {
 
     NODE_TYPE,    NODE_IMPORT,  NODE_MODULE,
     NODE_TRAIT,   NODE_IMPL,    NODE_TRY,
-    NODE_CATCH
+    NODE_CATCH,
+
+    NUM_NODE_KINDS
 };
 
-struct node {
-    enum node_kind kind;
+// payloads are stored inline, children are ids, so a node is 32 bytes and
+// a whole tree is one array
+typedef struct node {
+    uint8_t kind;   // enum node_kind
     location_t loc;
 
     union {
-        struct node_binop*      binop;
-        struct node_unaryop*    unaryop;
-        struct node_var_assign* var_assign;
-        struct node_var_ref*    var_ref;
-        struct node_block*      block;
-        struct node_func_call*  func_call;
-        struct node_literal*    lit;
-        struct node_range*      range;
-
-        struct node_variable* var_decl;
-        struct node_array*    array_decl;
-        struct node_param*    param_decl;
-        struct node_variant*  variant_decl;
-        struct node_func*     func_decl;
-        struct node_type*     type_decl;
-        struct node_struct*   struct_decl;
-        struct node_enum*     enum_decl;
-        struct node_trait*    trait_decl;
-        struct node_module*   module_decl;
-        struct node_import*   import_decl;
-        struct node_impl*     impl_decl;
-
-        struct node_if*     if_stmt;
-        struct node_while*  while_stmt;
-        struct node_for*    for_stmt;
-        struct node_case*   case_stmt;
-        struct node_match*  match_stmt;
-        struct node_try*    try_stmt;
-        struct node_catch*  catch_stmt;
-        struct node_return* return_stmt;
+        struct node_binop      binop;
+        struct node_unaryop    unaryop;
+        struct node_var_assign var_assign;
+        struct node_var_ref    var_ref;
+        struct node_block      block;
+        struct node_func_call  func_call;
+        struct node_literal    lit;
+        struct node_range      range;
+
+        struct node_variable var_decl;
+        struct node_array    array_decl;
+        struct node_param    param_decl;
+        struct node_variant  variant_decl;
+        struct node_func     func_decl;
+        struct node_type     type_decl;
+        struct node_struct   struct_decl;
+        struct node_enum     enum_decl;
+        struct node_trait    trait_decl;
+        struct node_module   module_decl;
+        struct node_import   import_decl;
+        struct node_impl     impl_decl;
+
+        struct node_if     if_stmt;
+        struct node_while  while_stmt;
+        struct node_for    for_stmt;
+        struct node_case   case_stmt;
+        struct node_match  match_stmt;
+        struct node_try    try_stmt;
+        struct node_catch  catch_stmt;
+        struct node_return return_stmt;
     };
-};
+} node_t;
 
 typedef struct {
     node_t* nodes;
+    uint32_t count;
+    uint32_t capacity;
+
+    uint32_t* extra;    // items of every node_list_t
+    uint32_t extra_count;
+    uint32_t extra_capacity;
+
+    node_id_t root;     // block of the top-level statements
+    nodes_t kinds[NUM_NODE_KINDS];  // ids of each kind in the order they were created, only nodes the root reaches once parsing is done
+    const string_pool_t* names; // the atoms in the nodes
     arena_t* arena;
-    size_t count;
 } ast_t;
 
-ast_t* new_ast(arena_t* arena);
+ast_t* new_ast(arena_t* arena, const string_pool_t* names);
 void free_ast(ast_t* ast);
-node_t* new_node(arena_t* arena, enum node_kind kind);
+
+// the new node is zeroed except for the defaults of its kind and is added
+// to the list of its kind. Growing the array moves it, so node pointers
+// are only good until the next new_node.
+node_id_t new_node(ast_t* ast, enum node_kind kind);
+bool new_node_list(ast_t* ast, const uint32_t* items, const size_t count, node_list_t* list);
+
+static inline node_t* ast_node(const ast_t* ast, const node_id_t id)
+{
+    return &ast->nodes[id - 1];
+}
+
+static inline const uint32_t* ast_list(const ast_t* ast, const node_list_t list)
+{
+    return ast->extra + list.start;
+}
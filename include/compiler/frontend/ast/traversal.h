@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>     // uint32_t
+#include <stdbool.h>    // bool
+
+#include "compiler/frontend/ast.h"  // ast_t, node_id_t
+
+#define ENTRY_NONE UINT32_MAX
+
+// a node in post-order, its subtree is entries[first..] up to and including
+// the node itself, children come before their parent in source order
+typedef struct {
+    node_id_t node;
+    uint32_t first;
+} ast_entry_t;
+
+// the tree flattened once, passes loop over it instead of recursing
+typedef struct {
+    ast_entry_t* entries;
+    uint32_t count;
+
+    uint32_t* position;     // entry of every node by id - 1, ENTRY_NONE if the root doesn't reach it
+    uint32_t node_count;    // nodes in the ast when it was flattened
+} ast_order_t;
+
+typedef struct {
+    const ast_entry_t* next;
+    const ast_entry_t* end;
+} ast_iter_t;
+
+// children in source order, optional children that are missing are NODE_NONE
+uint32_t node_child_count(const ast_t* ast, const node_id_t id);
+node_id_t node_child(const ast_t* ast, const node_id_t id, const uint32_t index);
+
+bool linearize_ast(const ast_t* ast, const node_id_t root, ast_order_t* order);
+void free_ast_order(ast_order_t* order);
+
+// drops the nodes of failed statements, which nothing refers to, from the
+// kind lists. The tree is only walked if there are any.
+bool prune_node_kinds(ast_t* ast);
+
+// the subtree of `id` in post-order, empty if `id` wasn't flattened
+ast_iter_t ast_subtree(const ast_order_t* order, const node_id_t id);
+
+static inline const ast_entry_t* ast_iter_next(ast_iter_t* iter)
+{
+    return iter->next < iter->end ? iter->next++ : NULL;
+}
@@ -1,21 +1,50 @@
 #pragma once
 
+#include <stdint.h>     // uint32_t
+#include <stdbool.h>    // bool
+
 #include "core/ds/arena.h"          // arena_t
-#include "core/ds/hashmap.h"        // hashmap_t
-#include "compiler/frontend/ast.h"  // ast_t, node_t
+#include "core/ds/vector.h"         // VECTOR_DEFINE
+#include "compiler/frontend/ast.h"  // ast_t, node_id_t, NUM_NODE_KINDS
 
-#define NUM_NODE_KINDS 24
+enum visit_action {
+    VISIT_CONTINUE, // go on with the children
+    VISIT_SKIP,     // leave out the children, the post hook of the node still runs
+    VISIT_STOP      // end the visit
+};
 
 typedef struct ast_visitor ast_visitor_t;
 
-typedef void (*visit_func_t)(ast_visitor_t* visitor, node_t* node);
+typedef enum visit_action (*visit_func_t)(ast_visitor_t* visitor, const ast_t* ast, node_id_t node);
+
+// a node whose children are being visited
+typedef struct {
+    node_id_t node;
+    uint32_t next;
+    uint32_t children;
+} visit_frame_t;
+
+VECTOR_DEFINE(visit_frames, visit_frame_t)
 
 typedef struct ast_visitor {
     arena_t* arena;
-    hashmap_t* string_table;
-    visit_func_t visit_table[NUM_NODE_KINDS];
+    void* state;    // the pass's own data
+
+    // hooks by node kind, called before and after the children. A missing
+    // hook continues.
+    visit_func_t pre[NUM_NODE_KINDS];
+    visit_func_t post[NUM_NODE_KINDS];
+
+    visit_frames_t stack;   // reused by every visit
 } ast_visitor_t;
 
-ast_visitor_t* new_ast_visitor(arena_t* arena);
+ast_visitor_t* new_ast_visitor(arena_t* arena, void* state);
 void free_ast_visitor(ast_visitor_t* visitor);
-void ast_visit(ast_visitor_t* visitor, ast_t* ast);
+
+// walks the subtree of `root` without recursing. Returns false if a hook
+// stopped it or the stack couldn't grow.
+bool ast_visit(ast_visitor_t* visitor, const ast_t* ast, const node_id_t root);
+
+// calls the hooks of `kind` on every node of that kind without walking the
+// tree, in the order the nodes were created. The children aren't visited.
+bool ast_visit_kind(ast_visitor_t* visitor, const ast_t* ast, const enum node_kind kind);
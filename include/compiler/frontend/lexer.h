@@ -1,18 +1,95 @@
 #pragma once
 
 #include <stddef.h>     // size_t
+#include <stdbool.h>    // bool
+#include <stdint.h>     // uint8_t, uint16_t, uint32_t
 
 #include "compiler/context.h"   // compiler_context_t
 #include "core/lang/source.h"   // location_t
 #include "compiler/frontend/lexer/tokens.h" // token_t
 
+// bytes past the end of a token its scan may look at ("1." is only a float if a digit follows)
+#define LEXER_LOOKAHEAD 2
+
+// scans the source content in place, the content must be NUL-terminated
+// (pool strings always are, loaded sources are padded) so the terminator
+// can stop every loop
 typedef struct {
-    char ch;
-    location_t loc;
+    const char* start;      // first byte of the source
+    const char* cursor;     // next byte to scan
+    const char* end;        // the terminating NUL
+
+    location_t loc;     // last token
     size_t balance;
+    bool streaming;     // the source has input left to read, see src_refill
 
     compiler_context_t* ctx;
 } lexer_t;
 
 lexer_t* new_lexer(compiler_context_t* ctx);
 token_t next_token(lexer_t* lexer);
+
+// every token of a source in structure-of-arrays form, lexed in one loop by
+// new_token_buffer(). Entry i of each array belongs to token i, the last
+// token is always EOF. The buffer doesn't point back into the lexer.
+typedef struct {
+    uint8_t* categories;
+    uint16_t* types;
+    atom_t* atoms;
+    uint32_t* offsets;
+    uint32_t* lengths;
+
+    size_t count;
+    size_t capacity;
+
+    // paren balance before token balance_index, kept by relex_token_buffer()
+    size_t balance_index;
+    size_t balance;
+} token_buffer_t;
+
+token_buffer_t* new_token_buffer(lexer_t* lexer);
+void free_token_buffer(token_buffer_t* buffer);
+
+#define LEXER_CHUNK_MIN (256 * 1024)    // smaller slices aren't worth a thread
+#define LEXER_MAX_THREADS 64
+
+// Lexes the current source of `ctx` on up to `threads` threads, one chunk
+// of whole lines each, and joins the chunks into one buffer with the same
+// tokens and reports, in the same order, as new_token_buffer(). Sources
+// under two chunks are lexed on the calling thread.
+token_buffer_t* new_token_buffer_parallel(compiler_context_t* ctx, size_t threads);
+
+// tokens [first, first + removed) of the buffer before an edit became
+// [first, first + inserted) after it, everything else only moved
+typedef struct {
+    size_t first;
+    size_t removed;
+    size_t inserted;
+} token_span_t;
+
+// Brings the buffer up to date after `removed` bytes at `offset` were
+// replaced by `inserted` bytes. The current source must already hold the
+// new content. Rescanning starts at a token boundary before the edit and
+// stops as soon as the new tokens line up with the old ones again.
+bool relex_token_buffer(token_buffer_t* buffer, lexer_t* lexer, const uint32_t offset,
+                        const uint32_t removed, const uint32_t inserted, token_span_t* span);
+
+// indices past the end read the EOF token
+static inline token_t buffer_token(const token_buffer_t* buffer, size_t index)
+{
+    if(index >= buffer->count) index = buffer->count - 1;
+    return (token_t){
+        .category = buffer->categories[index],
+        .type = buffer->types[index],
+        .atom = buffer->atoms[index],
+        .offset = buffer->offsets[index],
+        .length = buffer->lengths[index],
+    };
+}
+
+// the location the lexer reported right after scanning token `index`
+static inline location_t buffer_loc(const token_buffer_t* buffer, size_t index)
+{
+    if(index >= buffer->count) index = buffer->count - 1;
+    return (location_t){buffer->offsets[index], buffer->lengths[index]};
+}
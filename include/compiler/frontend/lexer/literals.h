@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t, uint64_t
+#include <stdbool.h>    // bool
+
+#define LT_DEF_CAPACITY 16
+#define LT_INDEX_CAPACITY 32    // initial slots of the dedup index, always a power of two
+
+#define CONST_NONE 0
+
+// constant id: element number + 1 in the table that produced it
+typedef uint32_t const_id_t;
+
+enum constant_kind {
+    CONST_INT,      // decimal, hex, binary and octal literals
+    CONST_FLOAT,
+};
+
+typedef struct {
+    uint32_t kind;  // enum constant_kind
+    union {
+        uint64_t integer;
+        double real;
+    };
+} constant_t;
+
+// numeric literals decoded by the lexer, each distinct value is stored once
+typedef struct {
+    constant_t* elements;
+    size_t count;
+    size_t capacity;
+
+    uint32_t* index;    // open-addressed element numbers + 1, zero marks an empty slot
+    size_t index_capacity;
+} literal_table_t;
+
+literal_table_t new_literal_table(void);
+void free_literal_table(literal_table_t* table);
+
+const_id_t add_constant(literal_table_t* table, const constant_t constant);
+constant_t get_constant(const literal_table_t* table, const const_id_t id);
+
+// `digits` holds only digits of `base`, prefixes are stripped by the caller.
+// Returns false if the value doesn't fit in 64 bits.
+bool decode_integer(const char* digits, const size_t length, const unsigned base, uint64_t* value);
+
+// `text` is a decimal literal with at most one dot, rounded to the nearest double
+// whatever the locale. Returns false if it doesn't fit in a double.
+bool decode_float(const char* text, const size_t length, double* value);
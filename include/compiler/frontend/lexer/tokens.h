@@ -1,6 +1,11 @@
 #pragma once
 
 #include <stddef.h> // size_t
+#include <stdint.h> // uint32_t
+#include <stdbool.h> // bool
+
+#include "core/ds/strings.h"    // string_t, atom_t
+#include "compiler/frontend/lexer/literals.h"  // const_id_t
 
 enum category_service {
 	SERV_ILLEGAL, SERV_COMMENT, SERV_EOF
@@ -103,13 +108,26 @@ enum category_tag {
     CAT_LITERAL,   CAT_MODIFIER,
 };
 
+// 16 bytes, tokens are passed and buffered by value. Fixed tokens are spelled
+// by token_literal(), identifiers and strings by their atom, numbers by the
+// source slice and valued through the literal table.
 typedef struct {
-	const char* literal;
-    int type;
-    enum category_tag category;
+    uint8_t category;   // enum category_tag
+    uint8_t reserved;
+    uint16_t type;      // enum of the category
+    union {
+        atom_t atom;            // perm pool atom of identifiers and strings, ATOM_NONE otherwise
+        const_id_t constant;    // literal table entry of numbers
+    };
+
+    // slice of the source the token was scanned from
+    uint32_t offset;
+    uint32_t length;
 } token_t;
 
-void init_tokens(void);
-token_t new_token(const enum category_tag category, const int type, const char* literal);
-token_t* find_token(const char* potential);
-void free_tokens(void);
+_Static_assert(sizeof(token_t) == 16, "token_t is expected to stay 16 bytes");
+
+token_t new_token(const enum category_tag category, const int type);
+const char* token_literal(const token_t token);
+bool is_number_literal(const token_t token);   // true for the tokens valued through the literal table
+const token_t* find_keyword(const char* begin, const size_t length);
@@ -7,31 +7,82 @@
 #include "compiler/context.h"           // compiler_context_t
 #include "compiler/frontend/lexer.h"    // lexer_t
 
+#define PARSER_MAX_DEPTH 256    // statements and expressions nested deeper end the parse instead of overflowing the stack
+#define PARSER_SPAN_MIN (64 * 1024) // tokens, smaller spans aren't worth a thread
+#define PARSER_MAX_THREADS 64
+
 typedef struct parser parser_t;
-typedef node_t* (*parse_func_t)(parser_t*);
+typedef node_id_t (*parse_func_t)(parser_t*);
 
 struct parser {
+    // tokens come from the lexer one at a time, or from a buffer lexed up front
     lexer_t* lexer;
+    const token_buffer_t* buffer;
+    size_t index;   // buffer index of token.next
+    bool in_span;   // parsing one span of parse_program_parallel, see token_atom
 
     struct {
         token_t current;
         token_t next;
     } token;
+    location_t loc; // as reported by the lexer after token.next
+
+    // items of the lists being parsed, a nested list stacks above its parent
+    nodes_t scratch;
+
+    // statements and expressions being parsed inside each other. Past
+    // PARSER_MAX_DEPTH the rest of the input is skipped, and the reports
+    // the open levels add while they unwind are dropped again.
+    size_t depth;
+    bool too_deep;
+    arena_mark_t reports_mark;
+    size_t reports_count;
 
     compiler_context_t* ctx;
 };
 
+// a list in progress, its items are scratch[base..base + count)
+typedef struct {
+    size_t base;
+    size_t count;
+} list_builder_t;
+
 extern parse_func_t parse_table[];
 extern const size_t PARSE_TABLE_LENGTH;
 
 parser_t* new_parser(compiler_context_t* ctx, lexer_t* lexer);
+parser_t* new_buffered_parser(compiler_context_t* ctx, const token_buffer_t* buffer);
 ast_t* parse_program(parser_t* parser);
 
+// Parses the rest of a buffered parser's tokens on up to `threads` threads.
+// The buffer is cut before top-level func, struct, enum and module
+// declarations, each span is parsed with a private context and the spans
+// are joined into the same tree and reports as parse_program() builds.
+// Streaming parsers, inputs under two spans and spans that don't end where
+// the next one begins are parsed on the calling thread instead.
+ast_t* parse_program_parallel(parser_t* parser, size_t threads);
+
 void advance_token(parser_t* parser);
-bool consume_token(parser_t* parser, node_t* node, const enum category_tag expec_category, const int expec_type, const enum report_code err);
+token_t peek_token(parser_t* parser, size_t ahead);
+bool consume_token(parser_t* parser, const node_id_t node, const enum category_tag expec_category, const int expec_type, const enum report_code err);
 bool check_token(parser_t* parser, enum category_tag category, int type);
 bool is_eof(const token_t token);
+atom_t token_atom(parser_t* parser, const token_t token);
 
-void set_node_loc(node_t* node, parser_t* parser);
-void set_node_len(node_t* node, parser_t* parser, size_t start_pos);
+void set_node_loc(const node_id_t node, parser_t* parser);
+void set_node_len(const node_id_t node, parser_t* parser, size_t start_pos);
 size_t get_lexer_pos(parser_t* parser);
+
+bool enter_nesting(parser_t* parser);
+void leave_nesting(parser_t* parser);
+
+// only good until the next node is created, store the results of nested
+// parses in a local before writing them through it
+static inline node_t* parser_node(parser_t* parser, const node_id_t node)
+{
+    return ast_node(parser->ctx->ast, node);
+}
+
+list_builder_t begin_list(parser_t* parser);
+bool push_list(parser_t* parser, list_builder_t* list, const uint32_t item);
+bool end_list(parser_t* parser, list_builder_t* list, node_list_t* out);
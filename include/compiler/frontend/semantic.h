@@ -4,8 +4,10 @@
 #include <stddef.h>     // size_t
 
 #include "compiler/context.h"       // compiler_context_t
-#include "compiler/frontend/ast.h"  // node_t
+#include "compiler/frontend/ast.h"  // ast_t, node_id_t
+#include "compiler/frontend/ast/traversal.h"    // ast_order_t
 #include "compiler/frontend/semantic/symbol.h"  // symbol_table_t, symbol_t
+#include "compiler/frontend/semantic/types.h"   // type_pool_t
 
 enum semantic_phase {
     PHASE_DECLARE, // register symbols
@@ -16,12 +18,15 @@ enum semantic_phase {
 typedef struct {
     enum semantic_phase phase;
     symbol_table_t* symbols;
+    type_pool_t types;
     symbol_t* current_function;
     int loop_depth;
 
+    const ast_t* ast;   // the tree being analyzed
+    ast_order_t order;  // the tree in post-order, expressions are checked in a loop over it
     compiler_context_t* ctx;
 } semantic_t;
 
 semantic_t* new_semantic(compiler_context_t* ctx);
-bool analyze_ast(semantic_t* ctx, node_t* ast);
+bool analyze_ast(semantic_t* ctx, const ast_t* ast);
 void free_semantic(semantic_t* ctx);
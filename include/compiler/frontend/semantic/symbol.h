@@ -6,8 +6,9 @@
 typedef struct symbol_table symbol_table_t;
 
 #include "compiler/context.h"       // compiler_context_t
-#include "compiler/frontend/ast.h"  // node_t
+#include "compiler/frontend/ast.h"  // node_id_t
 #include "compiler/frontend/semantic/types.h"   // type_t
+#include "core/ds/pool.h"   // POOL_DEFINE
 
 enum symbol_kind {
     SYMBOL_VAR,
@@ -55,7 +56,7 @@ struct scope {
     scope_t* next_sibling;
 
     enum scope_kind kind;
-    node_t* owner;
+    node_id_t owner;
     int depth;
 
     hashmap_t* symbols;
@@ -63,7 +64,7 @@ struct scope {
 };
 
 struct symbol {
-    char* name;
+    atom_t name;    // perm string pool atom
     location_t loc;
 
     enum symbol_kind kind;
@@ -72,8 +73,8 @@ struct symbol {
     struct type* type;
     struct type* declared_type;
 
-    node_t* decl_node;
-    node_t* init_node;
+    node_id_t decl_node;
+    node_id_t init_node;
 
     symbol_t* next_in_scope;
     symbol_t* shadowed_symbol;
@@ -82,23 +83,33 @@ struct symbol {
     scope_t* scope;
 };
 
+POOL_DEFINE(symbol, symbol_t)
+POOL_DEFINE(scope, scope_t)
+
 struct symbol_table {
     scope_t* global;
     scope_t* current;
     size_t scope_count;
     size_t scope_capacity;
 
+    // records are recycled, the incremental and repl paths release and redefine them
+    symbol_pool_t symbol_pool;
+    scope_pool_t scope_pool;
+
     compiler_context_t* ctx;
 };
 
 symbol_table_t* new_symbol_table(compiler_context_t* ctx);
-symbol_t* lookup_symbol(symbol_table_t* st, const char* name);
-symbol_t* define_symbol(symbol_table_t* st, const char* name, const enum symbol_kind kind, struct type* type, node_t* decl_node);
-scope_t* push_scope(symbol_table_t* st, int scope_kind, node_t* owner);
-scope_t* new_scope(arena_t* arena, int kind, node_t* owner);
+symbol_t* lookup_symbol(symbol_table_t* st, const atom_t name);
+symbol_t* define_symbol(symbol_table_t* st, const atom_t name, const enum symbol_kind kind, struct type* type, const node_id_t decl_node);
+scope_t* push_scope(symbol_table_t* st, int scope_kind, const node_id_t owner);
+scope_t* new_scope(scope_pool_t* pool, int kind, const node_id_t owner);
 void pop_scope(symbol_table_t* st);
 
-bool is_scope_symbol_exist(symbol_table_t* st, const char* name);
+bool is_scope_symbol_exist(symbol_table_t* st, const atom_t name);
+
+void release_symbol(symbol_table_t* st, symbol_t* sym);
+void release_scope(symbol_table_t* st, scope_t* scope);
 
 void free_scope(scope_t* scope);
 void free_symbol_table(symbol_table_t* st);
@@ -4,6 +4,7 @@
 #include <stdbool.h>    // bool
 
 #include "core/ds/arena.h"      // arena_t
+#include "core/ds/pool.h"       // POOL_DEFINE
 #include "compiler/frontend/semantic/symbol.h"  // symbol_t
 
 enum type_kind {
@@ -59,6 +60,8 @@ struct type {
     };
 };
 
+POOL_DEFINE(type, type_t)
+
 extern type_t* type_unknown;
 extern type_t* type_error;
 extern type_t* type_void;
@@ -75,12 +78,12 @@ extern type_t* type_decimal;
 extern type_t* type_str;
 extern type_t* type_char;
 
-void init_types(arena_t* arena);
-void free_type(type_t* type);
+void init_types(type_pool_t* pool);
+void free_type(type_pool_t* pool, type_t* type);
 
-type_t* new_type(arena_t* arena, enum type_kind kind, size_t size, size_t align);
-type_t* new_type_array(arena_t* arena, type_t* elem_type, const size_t length);
-type_t* new_type_function(arena_t* arena, type_t* return_type, type_t** param_types, const size_t param_count);
-type_t* new_type_compound(arena_t* arena, enum type_kind kind, struct symbol* scope, const size_t member_count);
+type_t* new_type(type_pool_t* pool, enum type_kind kind, size_t size, size_t align);
+type_t* new_type_array(type_pool_t* pool, type_t* elem_type, const size_t length);
+type_t* new_type_function(type_pool_t* pool, type_t* return_type, type_t** param_types, const size_t param_count);
+type_t* new_type_compound(type_pool_t* pool, enum type_kind kind, struct symbol* scope, const size_t member_count);
 
 bool types_compatible(const type_t* a, const type_t* b);
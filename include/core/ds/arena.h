@@ -10,6 +10,12 @@
 #define ARENA_TEMP_SIZE  (32 * 1024)    // 32KB for transient allocations
 #define ARENA_PHASE_SIZE (16 * 1024)    // 16KB for phase-specific allocations
 
+#define ARENA_VM_RESERVE ((size_t)1 << 30)  // 1GB of address space per virtual memory arena
+#define ARENA_VM_COMMIT  (64 * 1024)        // 64KB commit step
+#define ARENA_VM_HUGE    (2 * 1024 * 1024)  // 2MB commit step with huge pages
+
+#define ARENA_CACHE_SIZE (64 * 1024 * 1024) // at most 64MB of freed blocks are kept for reuse
+
 typedef struct arena_block {
     unsigned char* data;
     size_t offset;
@@ -20,18 +26,53 @@ typedef struct arena_block {
 typedef struct {
     arena_block_t* head;
     arena_block_t* current;
+
+    // virtual memory arenas keep a single block over a reserved range,
+    // the block capacity is the committed part of it
+    size_t reserved;    // 0 for chained arenas
+    size_t commit_step;
 } arena_t;
 
+// savepoint, everything allocated after it is released by arena_rewind
+typedef struct {
+    arena_block_t* block;
+    size_t offset;
+} arena_mark_t;
+
+typedef struct {
+    arena_t* arena;
+    arena_mark_t mark;
+} arena_scratch_t;
+
 arena_t* new_arena(size_t size);
+arena_t* new_vm_arena(size_t reserve, bool huge_pages);
 void free_arena(arena_t* arena);
 bool arena_expand(arena_t* arena, size_t capacity);
 
 bool arena_has_space(arena_t* arena, size_t size, size_t align);
 
+// allocations are not zeroed unless requested
 void* arena_alloc(arena_t* arena, size_t size, size_t align);
+void* arena_alloc_uninit(arena_t* arena, size_t size, size_t align);
+void* arena_alloc_zeroed(arena_t* arena, size_t size, size_t align);
 void* arena_alloc_default(arena_t* arena, size_t size);
 void* arena_alloc_array(arena_t* arena, size_t element_size, size_t count, size_t align);
+void* arena_push_bytes(arena_t* arena, const void* src, size_t length);
+
+// the most recent allocation is resized in place, anything else is copied
+bool arena_is_top(const arena_t* arena, const void* ptr, size_t size);
+void* arena_resize(arena_t* arena, void* ptr, size_t old_size, size_t new_size, size_t align);
 
 void arena_clear(arena_t* arena);
+arena_mark_t arena_mark(arena_t* arena);
+void arena_rewind(arena_t* arena, arena_mark_t mark);
+
+arena_scratch_t arena_scratch_begin(const arena_t* conflict);
+void arena_scratch_end(arena_scratch_t scratch);
+void free_scratch_arenas(void);
+
+size_t arena_cache_size(void);
+void free_arena_cache(void);
+
 size_t arena_used(arena_t* arena);
 size_t arena_capacity(arena_t* arena);
@@ -2,18 +2,47 @@
 
 #include <stdint.h>     // uint32_t
 #include <stddef.h>     // size_t
+#include <stdbool.h>    // bool
 
-#include "core/ds/strings.h"    // string_t
+#include "core/ds/strings.h"    // string_t, atom_t
 
-typedef struct hashmap {
-    string_t key;
+#define HM_DEF_CAPACITY 16  // slots allocated on the first insert, always a power of two
+#define HM_MAX_LOAD     7   // grow once count exceeds 7/8 of the capacity
+
+typedef struct {
+    string_t key;   // borrowed, the map never copies key bytes
     void* value;
-    struct hashmap* next;
+    uint32_t dist;  // probe distance + 1, zero marks an empty slot
+} hm_slot_t;
+
+typedef struct {
+    hm_slot_t* slots;
+    size_t capacity;
+    size_t count;
 } hashmap_t;
 
+typedef struct {
+    const hashmap_t* map;
+    size_t index;
+} hm_iter_t;
+
 uint32_t hm_hash(const char* str);
+uint32_t hm_hash_n(const char* str, size_t length);
+
 hashmap_t* new_hashmap(void);
+void free_hashmap(hashmap_t* map);
+
 void hm_insert(hashmap_t* map, const char* key, void* value);
 void* hm_lookup(hashmap_t* map, const char* key);
 void hm_delete(hashmap_t* map, const char* key);
-void free_hashmap(hashmap_t* map);
+
+void hm_insert_str(hashmap_t* map, string_t key, void* value);
+void* hm_lookup_str(hashmap_t* map, string_t key);
+bool hm_delete_str(hashmap_t* map, string_t key);
+
+void hm_insert_atom(hashmap_t* map, atom_t key, void* value);
+void* hm_lookup_atom(hashmap_t* map, atom_t key);
+bool hm_delete_atom(hashmap_t* map, atom_t key);
+
+hm_iter_t hm_iter(const hashmap_t* map);
+bool hm_next(hm_iter_t* it, string_t* key, void** value);
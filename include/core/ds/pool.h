@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>     // size_t, NULL
+#include <stdalign.h>   // alignof
+
+#include "core/ds/arena.h"  // arena_t
+
+#define POOL_SLAB_COUNT 64  // records carved from the arena at once
+
+// POOL_DEFINE(name, type) generates a fixed-size record pool for `type`:
+//   name##_pool_t                              the pool, embed it by value
+//   new_##name##_pool(arena)                   empty pool backed by `arena`
+//   name##_pool_alloc(pool)                    uninitialized record
+//   name##_pool_release(pool, record)          hands a record back for reuse
+//
+// Records are taken from slabs of POOL_SLAB_COUNT allocated in the arena,
+// released ones are threaded through their own storage into a free list and
+// handed out again first. The memory itself goes back with the arena.
+#define POOL_DEFINE(name, type)                                                 \
+    typedef union name##_slot {                                                 \
+        type value;                                                             \
+        union name##_slot* next;                                                \
+    } name##_slot_t;                                                            \
+                                                                                \
+    typedef struct {                                                            \
+        arena_t* arena;                                                         \
+        name##_slot_t* free_list;                                               \
+        name##_slot_t* slab;    /* unused tail of the current slab */           \
+        size_t slab_left;                                                       \
+        size_t live;            /* records handed out and not released */       \
+    } name##_pool_t;                                                            \
+                                                                                \
+    static inline name##_pool_t new_##name##_pool(arena_t* arena)               \
+    {                                                                           \
+        return (name##_pool_t){arena, NULL, NULL, 0, 0};                        \
+    }                                                                           \
+                                                                                \
+    static inline type* name##_pool_alloc(name##_pool_t* pool)                  \
+    {                                                                           \
+        if(!pool) return NULL;                                                  \
+                                                                                \
+        name##_slot_t* slot = pool->free_list;                                  \
+        if(slot){                                                               \
+            pool->free_list = slot->next;                                       \
+        }                                                                       \
+        else {                                                                  \
+            if(pool->slab_left == 0){                                           \
+                pool->slab = arena_alloc_uninit(pool->arena,                    \
+                    sizeof(name##_slot_t) * POOL_SLAB_COUNT,                    \
+                    alignof(name##_slot_t));                                    \
+                if(!pool->slab) return NULL;                                    \
+                pool->slab_left = POOL_SLAB_COUNT;                              \
+            }                                                                   \
+            slot = pool->slab++;                                                \
+            pool->slab_left--;                                                  \
+        }                                                                       \
+                                                                                \
+        pool->live++;                                                           \
+        return &slot->value;                                                    \
+    }                                                                           \
+                                                                                \
+    static inline void name##_pool_release(name##_pool_t* pool, type* record)   \
+    {                                                                           \
+        if(!pool || !record) return;                                            \
+                                                                                \
+        name##_slot_t* slot = (name##_slot_t*)record;                           \
+        slot->next = pool->free_list;                                           \
+        pool->free_list = slot;                                                 \
+        pool->live--;                                                           \
+    }
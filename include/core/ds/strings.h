@@ -2,15 +2,24 @@
 
 #include <stddef.h>     // size_t
 #include <stdint.h>     // uint32_t
+#include <stdbool.h>    // bool
+#include <string.h>     // memcmp
 
 #include "core/ds/arena.h"  // arena_t
 
 #define SP_DEF_CAPACITY 64
+#define SP_INDEX_CAPACITY 32    // initial slots of the dedup index, always a power of two
+
+#define ATOM_NONE 0
+
+// interned string id: element number + 1 in the pool that produced it
+typedef uint32_t atom_t;
 
 typedef struct {
     const char* data;
     size_t length;
     uint32_t hash;
+    atom_t atom;    // ATOM_NONE unless the string came from a pool
 } string_t;
 
 typedef struct {
@@ -18,10 +27,23 @@ typedef struct {
     string_t* elements;
     size_t count;
     size_t capacity;
+
+    uint32_t* index;    // open-addressed element numbers + 1, zero marks an empty slot
+    size_t index_capacity;
 } string_pool_t;
 
+// length and hash first, the bytes are only compared when both match
+static inline bool string_equal(const string_t a, const string_t b)
+{
+    if(a.length != b.length || a.hash != b.hash) return false;
+    return a.data == b.data || a.length == 0 || memcmp(a.data, b.data, a.length) == 0;
+}
+
 string_pool_t new_string_pool(const size_t capacity);
 void free_string_pool(string_pool_t* pool);
 
 string_t new_string_n(string_pool_t* pool, const char* str, const size_t length);
 string_t new_string(string_pool_t* pool, const char* str);
+
+atom_t sp_lookup_n(const string_pool_t* pool, const char* str, const size_t length);
+string_t sp_atom_str(const string_pool_t* pool, const atom_t atom);
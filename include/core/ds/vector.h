@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdlib.h>     // realloc, free
+#include <stdint.h>     // SIZE_MAX
+#include <stddef.h>     // size_t, NULL
+#include <stdbool.h>    // bool
+#include <string.h>     // memcpy
+#include <stdalign.h>   // alignof
+
+#include "core/ds/arena.h"  // arena_t
+
+#define VECTOR_DEF_CAPACITY 4   // capacity of the first allocation
+
+// VECTOR_DEFINE(name, type) generates a growable array of `type`:
+//   name##_t                                   {elems, count, capacity}, zero is empty
+//   name##_reserve(arena, vec, capacity)       makes room for `capacity` elements
+//   name##_push(arena, vec, value)             appends, doubling the capacity when full
+//   name##_shrink_to_fit(arena, vec)           moves the elements into `arena` at their exact size
+//   name##_free(arena, vec)                    drops the elements
+//
+// The vector doesn't remember where its storage lives, every call gets the
+// same arena, or NULL for malloc. Arena storage grows in place while it is
+// the arena's last allocation and is copied otherwise.
+#define VECTOR_DEFINE(name, type)                                               \
+    typedef struct {                                                            \
+        type* elems;                                                            \
+        size_t count;                                                           \
+        size_t capacity;                                                        \
+    } name##_t;                                                                 \
+                                                                                \
+    static inline bool name##_reserve(arena_t* arena, name##_t* vec, size_t capacity) \
+    {                                                                           \
+        if(!vec) return false;                                                  \
+        if(capacity <= vec->capacity) return true;                              \
+        if(capacity > SIZE_MAX / sizeof(type)) return false;                    \
+                                                                                \
+        type* elems = arena                                                     \
+            ? arena_resize(arena, vec->elems, vec->capacity * sizeof(type),     \
+                           capacity * sizeof(type), alignof(type))              \
+            : realloc(vec->elems, capacity * sizeof(type));                     \
+        if(!elems) return false;                                                \
+                                                                                \
+        vec->elems = elems;                                                     \
+        vec->capacity = capacity;                                               \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_push(arena_t* arena, name##_t* vec, type value)   \
+    {                                                                           \
+        if(!vec) return false;                                                  \
+        if(vec->count >= vec->capacity){                                        \
+            size_t capacity = vec->capacity ? vec->capacity * 2 : VECTOR_DEF_CAPACITY; \
+            if(!name##_reserve(arena, vec, capacity)) return false;             \
+        }                                                                       \
+        vec->elems[vec->count++] = value;                                       \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_shrink_to_fit(arena_t* arena, name##_t* vec)      \
+    {                                                                           \
+        if(!vec || vec->count == vec->capacity) return true;                    \
+                                                                                \
+        type* elems;                                                            \
+        if(!arena){                                                             \
+            if(vec->count == 0){                                                \
+                free(vec->elems);                                               \
+                elems = NULL;                                                   \
+            }                                                                   \
+            else {                                                              \
+                elems = realloc(vec->elems, vec->count * sizeof(type));         \
+                if(!elems) return false;                                        \
+            }                                                                   \
+        }                                                                       \
+        else if(arena_is_top(arena, vec->elems, vec->capacity * sizeof(type))){ \
+            elems = arena_resize(arena, vec->elems, vec->capacity * sizeof(type), \
+                                 vec->count * sizeof(type), alignof(type));     \
+            if(vec->count == 0) elems = NULL;                                   \
+        }                                                                       \
+        else if(vec->count == 0){                                               \
+            elems = NULL;                                                       \
+        }                                                                       \
+        else {                                                                  \
+            elems = arena_alloc_uninit(arena, vec->count * sizeof(type), alignof(type)); \
+            if(!elems) return false;                                            \
+            memcpy(elems, vec->elems, vec->count * sizeof(type));               \
+        }                                                                       \
+                                                                                \
+        vec->elems = elems;                                                     \
+        vec->capacity = vec->count;                                             \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline void name##_free(arena_t* arena, name##_t* vec)               \
+    {                                                                           \
+        if(!vec) return;                                                        \
+        if(!arena) free(vec->elems);                                            \
+        else if(arena_is_top(arena, vec->elems, vec->capacity * sizeof(type))){ \
+            arena_resize(arena, vec->elems, vec->capacity * sizeof(type), 0, alignof(type)); \
+        }                                                                       \
+        vec->elems = NULL;                                                      \
+        vec->count = 0;                                                         \
+        vec->capacity = 0;                                                      \
+    }
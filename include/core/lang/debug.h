@@ -4,8 +4,10 @@
 
 #include <stdio.h>      // printf
 #include <stdbool.h>    // bool
+#include <string.h>     // strlen
 
 #include "core/ds/hashmap.h"            // hashmap_t
+#include "core/ds/vector.h"             // VECTOR_DEFINE
 #include "compiler/frontend/lexer.h"    // token_t
 #include "compiler/frontend/ast.h"      // node_t
 #include "compiler/frontend/semantic.h" // symbol_table_t
@@ -55,17 +57,38 @@ static inline const char* token_to_str(const token_t token)
     return NULL;
 }
 
-static inline void print_token(token_t token)
+// `source` is the content the token was scanned from, values are printed from their slice
+static inline void print_token(const token_t token, const char* source)
 {
     const char* str_type = token_to_str(token);
-    const char* literal = token.literal ? token.literal : "(null)";
-    printf("\033[1m%-12s\033[0m%-10s  \033[0m%-5d%d\033[0m\n", str_type, literal, token.category, token.type);
+    const char* literal = token_literal(token);
+    int length = literal ? (int)strlen(literal) : (int)token.length;
+    if(!literal) literal = source ? source + token.offset : "(null)";
+    printf("\033[1m%-12s\033[0m%-10.*s  \033[0m%-5d%d\033[0m\n", str_type, length, literal, token.category, token.type);
 }
 
 //
 // PARSER
 //
-static inline void print_node(node_t* node, int indent);
+// a node to print, or a label line when `label` is set
+typedef struct {
+    node_id_t node;
+    const char* label;
+    int indent;
+} print_item_t;
+
+VECTOR_DEFINE(print_items, print_item_t)
+
+typedef struct {
+    print_items_t stack;
+    print_items_t pending; // what the current node printed below it, in order
+    bool failed;
+} ast_printer_t;
+
+static inline void print_later(ast_printer_t* printer, const node_id_t node, const char* label, int indent)
+{
+    if(!print_items_push(NULL, &printer->pending, (print_item_t){node, label, indent})) printer->failed = true;
+}
 
 static inline void print_indent(int indent, const char* prefix)
 {
@@ -82,9 +105,21 @@ static inline void print_node_type(const char* type, const char* name, const cha
     printf("\n");
 }
 
-static inline void print_node(node_t* node, int indent)
+// NULL for ATOM_NONE, printf spells that "(null)"
+static inline const char* node_name(const ast_t* ast, const atom_t atom)
 {
-    if(!node) return;
+    return sp_atom_str(ast->names, atom).data;
+}
+
+static inline const char* node_operator(const int type)
+{
+    return token_literal(new_token(CAT_OPERATOR, type));
+}
+
+// prints the line of one node and queues what goes below it
+static inline void print_node_line(ast_printer_t* printer, const ast_t* ast, const node_id_t id, int indent)
+{
+    const node_t* node = ast_node(ast, id);
 
     print_indent(indent, NULL);
 
@@ -93,101 +128,93 @@ static inline void print_node(node_t* node, int indent)
             printf("\033[90mEXPRESSION/ASSIGN\033[0m (unhandled display)\033[0m\n");
             break;
         case NODE_LITERAL:
-            if(node->lit && node->lit->value.data){
+            if(node_name(ast, node->lit.value)){
                 printf("\033[1mLITERAL\033[0m ");
-                printf("\"%s\"\033[0m \033[90m[type:%d]\033[0m\n", node->lit->value.data, node->lit->type);
+                printf("\"%s\"\033[0m \033[90m[type:%d]\033[0m\n", node_name(ast, node->lit.value), node->lit.type);
             }
             else {
                 printf("\033[1mLITERAL\033[0m (null)\033[0m\n");
             }
             break;
         case NODE_REFERENCE:
-            if(node->var_ref && node->var_ref->name.data){
+            if(node_name(ast, node->var_ref.name)){
                 printf("\033[1mREFERENCE\033[0m ");
-                printf("%s\033[0m\n", node->var_ref->name.data);
+                printf("%s\033[0m\n", node_name(ast, node->var_ref.name));
             }
             else {
                 printf("\033[1mREFERENCE\033[0m (null)\033[0m\n");
             }
             break;
         case NODE_BINOP:
-            if(node->binop && node->binop->lit){
+            if(node_operator(node->binop.operator)){
                 printf("\033[1mBINARY_OP\033[0m ");
-                printf("%s\033[0m\n", node->binop->lit);
+                printf("%s\033[0m\n", node_operator(node->binop.operator));
             }
             else {
                 printf("\033[1mBINARY_OP\033[0m (null)\033[0m\n");
             }
-            if(node->binop->left)  print_node(node->binop->left, indent + 1);
-            if(node->binop->right) print_node(node->binop->right, indent + 1);
+            if(node->binop.left)  print_later(printer, node->binop.left, NULL, indent + 1);
+            if(node->binop.right) print_later(printer, node->binop.right, NULL, indent + 1);
             break;
         case NODE_RANGE:
-            if(node->range) printf("\033[1mRANGE\033[0m ");
-            if(node->range->start) print_node(node->range->start, indent + 1);
-            if(node->range->end)   print_node(node->range->end, indent + 1);
+            printf("\033[1mRANGE\033[0m ");
+            if(node->range.start) print_later(printer, node->range.start, NULL, indent + 1);
+            if(node->range.end)   print_later(printer, node->range.end, NULL, indent + 1);
             break;
         case NODE_VARIABLE:
-            if(node->var_decl && node->var_decl->name.data){
+            if(node_name(ast, node->var_decl.name)){
                 printf("\033[1mVARIABLE\033[0m ");
                 printf("%s\033[0m \033[90m[modif:%d, type:%d]\033[0m\n",
-                       node->var_decl->name.data, node->var_decl->modif, node->var_decl->dtype);
+                       node_name(ast, node->var_decl.name), node->var_decl.modif, node->var_decl.dtype);
             }
             else {
                 printf("\033[1mVARIABLE\033[0m (null)\033[0m\n");
             }
-            if(node->var_decl->value) print_node(node->var_decl->value, indent + 1);
+            if(node->var_decl.value) print_later(printer, node->var_decl.value, NULL, indent + 1);
             break;
         case NODE_BLOCK:
-            printf("\033[1mBLOCK\033[0m \033[90m(%zu statements)\033[0m\n",
-                   node->block ? node->block->statement.count : 0);
-            if(node->block && node->block->statement.elems){
-                for(size_t i = 0; i < node->block->statement.count; i++){
-                    if(node->block->statement.elems[i]){
-                        print_node(node->block->statement.elems[i], indent + 1);
-                    }
-                }
+            printf("\033[1mBLOCK\033[0m \033[90m(%u statements)\033[0m\n",
+                   node->block.statement.count);
+            for(uint32_t i = 0; i < node->block.statement.count; i++){
+                print_later(printer, ast_list(ast, node->block.statement)[i], NULL, indent + 1);
             }
             break;
         case NODE_UNARYOP:
             printf("\033[1mUNARY_OP\033[0m ");
             printf("%s\033[0m \033[90m[postfix:%s]\033[0m\n",
-                   node->unaryop->lit ? node->unaryop->lit : "(null)",
-                   node->unaryop->is_postfix ? "true" : "false");
-            print_node(node->unaryop->right, indent + 1);
+                   node_operator(node->unaryop.operator) ? node_operator(node->unaryop.operator) : "(null)",
+                   node->unaryop.is_postfix ? "true" : "false");
+            print_later(printer, node->unaryop.right, NULL, indent + 1);
             break;
         case NODE_CALL:
-            if(node->func_call && node->func_call->name.data){
+            if(node_name(ast, node->func_call.name)){
                 printf("\033[1mCALL\033[0m ");
-                printf("%s\033[0m \033[90m(%zu args)\033[0m\n",
-                       node->func_call->name.data, node->func_call->args.count);
+                printf("%s\033[0m \033[90m(%u args)\033[0m\n",
+                       node_name(ast, node->func_call.name), node->func_call.args.count);
             }
             else {
                 printf("\033[1mCALL\033[0m (null)\033[0m\n");
             }
-            if(node->func_call && node->func_call->args.elems){
-                for(size_t i = 0; i < node->func_call->args.count; i++){
-                    if(node->func_call->args.elems[i]){
-                        print_node(node->func_call->args.elems[i], indent + 1);
-                    }
-                }
+            for(uint32_t i = 0; i < node->func_call.args.count; i++){
+                print_later(printer, ast_list(ast, node->func_call.args)[i], NULL, indent + 1);
             }
             break;
         case NODE_VARIANT:
-            if(node->variant_decl && node->variant_decl->name.data){
+            if(node_name(ast, node->variant_decl.name)){
                 printf("\033[1mMEMBER\033[0m ");
-                printf("%s\033[0m\n", node->variant_decl->name.data);
+                printf("%s\033[0m\n", node_name(ast, node->variant_decl.name));
             }
             else {
                 printf("\033[1mMEMBER\033[0m (null)\033[0m\n");
             }
-            if(node->variant_decl && node->variant_decl->value){
-                print_node(node->variant_decl->value, indent + 1);
+            if(node->variant_decl.value){
+                print_later(printer, node->variant_decl.value, NULL, indent + 1);
             }
             break;
         case NODE_RETURN:
             printf("\033[1mRETURN\033[0m\n");
-            if(node->return_stmt && node->return_stmt->body){
-                print_node(node->return_stmt->body, indent + 1);
+            if(node->return_stmt.body){
+                print_later(printer, node->return_stmt.body, NULL, indent + 1);
             }
             break;
         case NODE_BREAK:
@@ -197,255 +224,248 @@ static inline void print_node(node_t* node, int indent)
             printf("\033[1mCONTINUE\033[0m\n");
             break;
         case NODE_ARRAY:
-            printf("\033[1mARRAY\033[0m (%zu elements)\033[0m\n",
-                   node->array_decl ? node->array_decl->count : 0);
-            if(node->array_decl && node->array_decl->elements){
-                for(size_t i = 0; i < node->array_decl->count; i++){
-                    if(node->array_decl->elements[i]){
-                        print_node(node->array_decl->elements[i], indent + 1);
-                    }
-                }
+            printf("\033[1mARRAY\033[0m (%u elements)\033[0m\n",
+                   node->array_decl.elements.count);
+            for(uint32_t i = 0; i < node->array_decl.elements.count; i++){
+                print_later(printer, ast_list(ast, node->array_decl.elements)[i], NULL, indent + 1);
             }
             break;
         case NODE_IF:
             printf("\033[1mIF_STATEMENT\033[0m\n");
-            if(node->if_stmt){
-                if(node->if_stmt->condition){
-                    print_indent(indent + 1, "\033[90mCONDITION:\033[0m\n");
-                    print_node(node->if_stmt->condition, indent + 2);
-                }
-                if(node->if_stmt->then_block){
-                    print_indent(indent + 1, "\033[90mTHEN:\033[0m\n");
-                    print_node(node->if_stmt->then_block, indent + 2);
-                }
-                if(node->if_stmt->elif_blocks){
-                    print_indent(indent + 1, "\033[90mELSEIF:\033[0m\n");
-                    print_node(node->if_stmt->elif_blocks, indent + 2);
-                }
-                if(node->if_stmt->else_block){
-                    print_indent(indent + 1, "\033[90mELSE:\033[0m\n");
-                    print_node(node->if_stmt->else_block, indent + 2);
-                }
+            if(node->if_stmt.condition){
+                print_later(printer, NODE_NONE, "\033[90mCONDITION:\033[0m\n", indent + 1);
+                print_later(printer, node->if_stmt.condition, NULL, indent + 2);
+            }
+            if(node->if_stmt.then_block){
+                print_later(printer, NODE_NONE, "\033[90mTHEN:\033[0m\n", indent + 1);
+                print_later(printer, node->if_stmt.then_block, NULL, indent + 2);
+            }
+            if(node->if_stmt.elif_blocks){
+                print_later(printer, NODE_NONE, "\033[90mELSEIF:\033[0m\n", indent + 1);
+                print_later(printer, node->if_stmt.elif_blocks, NULL, indent + 2);
+            }
+            if(node->if_stmt.else_block){
+                print_later(printer, NODE_NONE, "\033[90mELSE:\033[0m\n", indent + 1);
+                print_later(printer, node->if_stmt.else_block, NULL, indent + 2);
             }
             break;
         case NODE_WHILE:
             printf("\033[1mWHILE_LOOP\033[0m\n");
-            if(node->while_stmt){
-                if(node->while_stmt->condition){
-                    print_indent(indent + 1, "\033[90mCONDITION:\033[0m\n");
-                    print_node(node->while_stmt->condition, indent + 2);
-                }
-                if(node->while_stmt->body){
-                    print_indent(indent + 1, "\033[90mBODY:\033[0m\n");
-                    print_node(node->while_stmt->body, indent + 2);
-                }
+            if(node->while_stmt.condition){
+                print_later(printer, NODE_NONE, "\033[90mCONDITION:\033[0m\n", indent + 1);
+                print_later(printer, node->while_stmt.condition, NULL, indent + 2);
+            }
+            if(node->while_stmt.body){
+                print_later(printer, NODE_NONE, "\033[90mBODY:\033[0m\n", indent + 1);
+                print_later(printer, node->while_stmt.body, NULL, indent + 2);
             }
             break;
         case NODE_FOR:
             printf("\033[1mFOR_LOOP\033[0m\n");
-            if(node->for_stmt){
-                if(node->for_stmt->init){
-                    print_indent(indent + 1, "\033[90mINIT:\033[0m\n");
-                    print_node(node->for_stmt->init, indent + 2);
-                }
-                if(node->for_stmt->condition){
-                    print_indent(indent + 1, "\033[90mCONDITION:\033[0m\n");
-                    print_node(node->for_stmt->condition, indent + 2);
-                }
-                if(node->for_stmt->update){
-                    print_indent(indent + 1, "\033[90mUPDATE:\033[0m\n");
-                    print_node(node->for_stmt->update, indent + 2);
-                }
-                if(node->for_stmt->body){
-                    print_indent(indent + 1, "\033[90mBODY:\033[0m\n");
-                    print_node(node->for_stmt->body, indent + 2);
-                }
+            if(node->for_stmt.init){
+                print_later(printer, NODE_NONE, "\033[90mINIT:\033[0m\n", indent + 1);
+                print_later(printer, node->for_stmt.init, NULL, indent + 2);
+            }
+            if(node->for_stmt.condition){
+                print_later(printer, NODE_NONE, "\033[90mCONDITION:\033[0m\n", indent + 1);
+                print_later(printer, node->for_stmt.condition, NULL, indent + 2);
+            }
+            if(node->for_stmt.update){
+                print_later(printer, NODE_NONE, "\033[90mUPDATE:\033[0m\n", indent + 1);
+                print_later(printer, node->for_stmt.update, NULL, indent + 2);
+            }
+            if(node->for_stmt.body){
+                print_later(printer, NODE_NONE, "\033[90mBODY:\033[0m\n", indent + 1);
+                print_later(printer, node->for_stmt.body, NULL, indent + 2);
             }
             break;
         case NODE_PARAM:
-            if(node->param_decl && node->param_decl->name.data){
+            if(node_name(ast, node->param_decl.name)){
                 printf("\033[1mPARAMETER\033[0m ");
                 printf("%s\033[0m \033[90m[variadic:%s, type:%d]\033[0m\n",
-                       node->param_decl->name.data,
-                       node->param_decl->is_variadic ? "true" : "false",
-                       node->param_decl->dtype);
+                       node_name(ast, node->param_decl.name),
+                       node->param_decl.is_variadic ? "true" : "false",
+                       node->param_decl.dtype);
             }
             else {
                 printf("\033[1mPARAMETER\033[0m (null)\033[0m\n");
             }
             break;
         case NODE_FUNC:
-            if(node->func_decl && node->func_decl->name.data){
+            if(node_name(ast, node->func_decl.name)){
                 printf("\033[1mFUNCTION\033[0m ");
-                printf("%s\033[0m \033[90m(%zu params, return_type:%d)\033[0m\n",
-                       node->func_decl->name.data,
-                       node->func_decl->param_decl.count,
-                       node->func_decl->return_type);
+                printf("%s\033[0m \033[90m(%u params, return_type:%d)\033[0m\n",
+                       node_name(ast, node->func_decl.name),
+                       node->func_decl.param_decl.count,
+                       node->func_decl.return_type);
             }
             else {
                 printf("\033[1mFUNCTION\033[0m (null)\033[0m\n");
             }
-            if(node->func_decl && node->func_decl->param_decl.elems){
-                print_indent(indent + 1, "\033[90mPARAMETERS:\033[0m\n");
-                for(size_t i = 0; i < node->func_decl->param_decl.count; i++){
-                    if(node->func_decl->param_decl.elems[i]){
-                        print_node(node->func_decl->param_decl.elems[i], indent + 2);
-                    }
+            if(node->func_decl.param_decl.count){
+                print_later(printer, NODE_NONE, "\033[90mPARAMETERS:\033[0m\n", indent + 1);
+                for(uint32_t i = 0; i < node->func_decl.param_decl.count; i++){
+                    print_later(printer, ast_list(ast, node->func_decl.param_decl)[i], NULL, indent + 2);
                 }
             }
-            if(node->func_decl && node->func_decl->body){
-                print_indent(indent + 1, "\033[90mBODY:\033[0m\n");
-                print_node(node->func_decl->body, indent + 2);
+            if(node->func_decl.body){
+                print_later(printer, NODE_NONE, "\033[90mBODY:\033[0m\n", indent + 1);
+                print_later(printer, node->func_decl.body, NULL, indent + 2);
             }
             break;
         case NODE_STRUCT:
-            if(node->struct_decl && node->struct_decl->name.data){
+            if(node_name(ast, node->struct_decl.name)){
                 printf("\033[1mSTRUCT\033[0m ");
-                printf("%s\033[0m \033[90m(%zu members)\033[0m\n",
-                       node->struct_decl->name.data,
-                       node->struct_decl->member.count);
+                printf("%s\033[0m \033[90m(%u members)\033[0m\n",
+                       node_name(ast, node->struct_decl.name),
+                       node->struct_decl.member.count);
             }
             else {
                 printf("\033[1mSTRUCT\033[0m (anonymous)\033[0m\n");
             }
-            if(node->struct_decl && node->struct_decl->member.elems){
-                for(size_t i = 0; i < node->struct_decl->member.count; i++){
-                    if(node->struct_decl->member.elems[i]){
-                        print_node(node->struct_decl->member.elems[i], indent + 1);
-                    }
-                }
+            for(uint32_t i = 0; i < node->struct_decl.member.count; i++){
+                print_later(printer, ast_list(ast, node->struct_decl.member)[i], NULL, indent + 1);
             }
             break;
         case NODE_ENUM:
-            if(node->enum_decl && node->enum_decl->name.data){
+            if(node_name(ast, node->enum_decl.name)){
                 printf("\033[1mENUM\033[0m ");
-                printf("%s\033[0m \033[90m(%zu members)\033[0m\n",
-                       node->enum_decl->name.data,
-                       node->enum_decl->member.count);
+                printf("%s\033[0m \033[90m(%u members)\033[0m\n",
+                       node_name(ast, node->enum_decl.name),
+                       node->enum_decl.member.count);
             }
             else {
                 printf("\033[1mENUM\033[0m (anonymous)\033[0m\n");
             }
-            if(node->enum_decl && node->enum_decl->member.elems){
-                for(size_t i = 0; i < node->enum_decl->member.count; i++){
-                    if(node->enum_decl->member.elems[i] &&
-                       node->enum_decl->member.elems[i]->lit &&
-                       node->enum_decl->member.elems[i]->lit->value.data){
-                        print_indent(indent + 1, "");
-                        printf("%s\033[0m\n", node->enum_decl->member.elems[i]->lit->value.data);
-                    }
-                }
+            for(uint32_t i = 0; i < node->enum_decl.member.count; i++){
+                print_later(printer, ast_list(ast, node->enum_decl.member)[i], NULL, indent + 1);
             }
             break;
         case NODE_MATCH:
             printf("\033[1mMATCH\033[0m\n");
-            if(node->match_stmt){
-                if(node->match_stmt->target){
-                    print_indent(indent + 1, "\033[90mTARGET:\033[0m\n");
-                    print_node(node->match_stmt->target, indent + 2);
-                }
-                print_indent(indent + 1, "\033[90mCASES (%zu):\033[0m\n");
-                for(size_t i = 0; i < node->match_stmt->block.count; i++){
-                    if(node->match_stmt->block.elems[i]){
-                        print_node(node->match_stmt->block.elems[i], indent + 2);
-                    }
-                }
+            if(node->match_stmt.target){
+                print_later(printer, NODE_NONE, "\033[90mTARGET:\033[0m\n", indent + 1);
+                print_later(printer, node->match_stmt.target, NULL, indent + 2);
+            }
+            print_later(printer, NODE_NONE, "\033[90mCASES (%zu):\033[0m\n", indent + 1);
+            for(uint32_t i = 0; i < node->match_stmt.block.count; i++){
+                print_later(printer, ast_list(ast, node->match_stmt.block)[i], NULL, indent + 2);
             }
             break;
         case NODE_CASE:
             printf("\033[1mCASE\033[0m\n");
-            if(node->case_stmt){
-                if(node->case_stmt->condition){
-                    print_indent(indent + 1, "\033[90mPATTERN:\033[0m\n");
-                    print_node(node->case_stmt->condition, indent + 2);
-                }
-                if(node->case_stmt->body){
-                    print_indent(indent + 1, "\033[90mBODY:\033[0m\n");
-                    print_node(node->case_stmt->body, indent + 2);
-                }
+            if(node->case_stmt.condition){
+                print_later(printer, NODE_NONE, "\033[90mPATTERN:\033[0m\n", indent + 1);
+                print_later(printer, node->case_stmt.condition, NULL, indent + 2);
+            }
+            if(node->case_stmt.body){
+                print_later(printer, NODE_NONE, "\033[90mBODY:\033[0m\n", indent + 1);
+                print_later(printer, node->case_stmt.body, NULL, indent + 2);
             }
             break;
         case NODE_TRAIT:
-            if(node->trait_decl && node->trait_decl->name.data){
+            if(node_name(ast, node->trait_decl.name)){
                 printf("\033[1mTRAIT\033[0m ");
-                printf("%s\033[0m\n", node->trait_decl->name.data);
+                printf("%s\033[0m\n", node_name(ast, node->trait_decl.name));
             }
             else {
                 printf("\033[1mTRAIT\033[0m (null)\033[0m\n");
             }
-            if(node->trait_decl && node->trait_decl->body){
-                print_node(node->trait_decl->body, indent + 1);
+            if(node->trait_decl.body){
+                print_later(printer, node->trait_decl.body, NULL, indent + 1);
             }
             break;
         case NODE_IMPL:
-            if(node->impl_decl && node->impl_decl->trait_name.data){
+            if(node_name(ast, node->impl_decl.trait_name)){
                 printf("\033[1mIMPL\033[0m ");
                 printf("%s for %s\033[0m\n",
-                       node->impl_decl->trait_name.data,
-                       node->impl_decl->struct_name.data);
+                       node_name(ast, node->impl_decl.trait_name),
+                       node_name(ast, node->impl_decl.struct_name));
             }
             else {
                 printf("\033[1mIMPL\033[0m (null)\033[0m\n");
             }
-            if(node->impl_decl && node->impl_decl->body){
-                print_node(node->impl_decl->body, indent + 1);
+            if(node->impl_decl.body){
+                print_later(printer, node->impl_decl.body, NULL, indent + 1);
             }
             break;
         case NODE_TRY:
             printf("\033[1mTRY\033[0m\n");
-            if(node->try_stmt){
-                if(node->try_stmt->try_block){
-                    print_indent(indent + 1, "\033[90mTRY_BLOCK:\033[0m\n");
-                    print_node(node->try_stmt->try_block, indent + 2);
-                }
+            if(node->try_stmt.try_block){
+                print_later(printer, NODE_NONE, "\033[90mTRY_BLOCK:\033[0m\n", indent + 1);
+                print_later(printer, node->try_stmt.try_block, NULL, indent + 2);
             }
             break;
         case NODE_CATCH:
             printf("\033[1mCATCH\033[0m\n");
-            if(node->catch_stmt){
-                if(node->catch_stmt->catch_block){
-                    print_indent(indent + 1, "\033[90mCATCH_BLOCK:\033[0m\n");
-                    print_node(node->catch_stmt->catch_block, indent + 2);
-                }
+            if(node->catch_stmt.catch_block){
+                print_later(printer, NODE_NONE, "\033[90mCATCH_BLOCK:\033[0m\n", indent + 1);
+                print_later(printer, node->catch_stmt.catch_block, NULL, indent + 2);
             }
             break;
         case NODE_TYPE:
-            if(node->type_decl && node->type_decl->name.data){
+            if(node_name(ast, node->type_decl.name)){
                 printf("\033[1mTYPE_ALIAS\033[0m ");
-                printf("%s\033[0m\n", node->type_decl->name.data);
+                printf("%s\033[0m\n", node_name(ast, node->type_decl.name));
             }
             else {
                 printf("\033[1mTYPE_ALIAS\033[0m (null)\033[0m\n");
             }
-            if(node->type_decl && node->type_decl->body){
-                print_node(node->type_decl->body, indent + 1);
+            if(node->type_decl.body){
+                print_later(printer, node->type_decl.body, NULL, indent + 1);
             }
             break;
         case NODE_IMPORT:
-            printf("\033[1mIMPORT\033[0m (%zu modules)\033[0m\n",
-                   node->import_decl ? node->import_decl->count : 0);
-            if(node->import_decl){
-                for(size_t i = 0; i < node->import_decl->count; ++i){
-                    print_indent(indent + 1, "");
-                    printf("%s\033[0m\n", node->import_decl->modules[i].data);
-                }
+            printf("\033[1mIMPORT\033[0m (%u modules)\033[0m\n",
+                   node->import_decl.modules.count);
+            for(uint32_t i = 0; i < node->import_decl.modules.count; ++i){
+                print_indent(indent + 1, "");
+                printf("%s\033[0m\n", node_name(ast, ast_list(ast, node->import_decl.modules)[i]));
             }
             break;
         case NODE_MODULE:
-            if(node->module_decl && node->module_decl->name.data){
+            if(node_name(ast, node->module_decl.name)){
                 printf("\033[1mMODULE\033[0m ");
-                printf("%s\033[0m\n", node->module_decl->name.data);
+                printf("%s\033[0m\n", node_name(ast, node->module_decl.name));
             }
             else {
                 printf("\033[1mMODULE\033[0m (null)\033[0m\n");
             }
-            if(node->module_decl && node->module_decl->body){
-                print_node(node->module_decl->body, indent + 1);
+            if(node->module_decl.body){
+                print_later(printer, node->module_decl.body, NULL, indent + 1);
             }
             break;
     }
 }
 
+// walks the tree with an explicit stack, a long operator chain is as deep as it is long
+static inline void print_node(const ast_t* ast, const node_id_t root, int indent)
+{
+    if(!ast || root == NODE_NONE) return;
+
+    ast_printer_t printer = {0};
+    print_later(&printer, root, NULL, indent);
+    print_items_t* stack = &printer.stack;
+
+    while(!printer.failed){
+        // the queue is in print order, the stack pops it back to front
+        while(printer.pending.count > 0){
+            if(!print_items_push(NULL, stack, printer.pending.elems[--printer.pending.count])){
+                printer.failed = true;
+                break;
+            }
+        }
+        if(printer.failed || stack->count == 0) break;
+
+        const print_item_t item = stack->elems[--stack->count];
+        if(item.label) print_indent(item.indent, item.label);
+        else if(item.node != NODE_NONE) print_node_line(&printer, ast, item.node, item.indent);
+    }
+
+    print_items_free(NULL, &printer.stack);
+    print_items_free(NULL, &printer.pending);
+}
+
 //
 // SEMANTIC
 //
@@ -524,17 +544,17 @@ static inline void print_symbol_flags(enum symbol_flags flags)
     if(flags & SYM_FLAG_PUBLIC) { printf("%sPUBLIC",  first ? "" : "|"); first = false; }
 }
 
-static inline void print_symbol(symbol_t* sym, int indent)
+static inline void print_symbol(const string_pool_t* names, const source_t* src, symbol_t* sym, int indent)
 {
     if(!sym) return;
 
     for(int i = 0; i < indent; i++) printf("  ");
 
-    printf("\033[33m%s\033[0m \033[1m%s\033[0m", symbol_kind_to_str(sym->kind), sym->name);
+    printf("\033[33m%s\033[0m \033[1m%s\033[0m", symbol_kind_to_str(sym->kind), sp_atom_str(names, sym->name).data);
 
     printf(" [flags: ");
     print_symbol_flags(sym->flags);
-    printf("] [loc: %ld:%ld]", sym->loc.line, sym->loc.column);
+    printf("] [loc: %zu:%zu]", src_get_line(src, sym->loc.offset), src_get_column(src, sym->loc.offset));
 
     if(sym->type)  printf(" [type: %s]", type_kind_to_str(sym->type->kind));
     if(sym->scope) printf(" [scope: %s depth:%d]", scope_kind_to_str(sym->scope->kind), sym->scope->depth);
@@ -543,40 +563,37 @@ static inline void print_symbol(symbol_t* sym, int indent)
 
     if(sym->shadowed_symbol){
         for(int i = 0; i < indent + 1; i++) printf("  ");
-        printf("  \033[31mshadows:\033[0m %s\n", sym->shadowed_symbol->name);
+        printf("  \033[31mshadows:\033[0m %s\n", sp_atom_str(names, sym->shadowed_symbol->name).data);
     }
 
     if(sym->overload_next){
         for(int i = 0; i < indent + 1; i++) printf("  ");
-        printf("  \033[36moverload:\033[0m %s\n", sym->overload_next->name);
+        printf("  \033[36moverload:\033[0m %s\n", sp_atom_str(names, sym->overload_next->name).data);
     }
 }
 
-static inline void print_scope_symbols(scope_t* scope, int indent)
+static inline void print_scope_symbols(const string_pool_t* names, const source_t* src, scope_t* scope, int indent)
 {
     if(!scope || !scope->symbols) return;
 
     for(int i = 0; i < indent; i++) printf("  ");
     printf("\033[32mSymbols (%zu):\033[0m\n", scope->count);
 
-    hashmap_t* entry = scope->symbols;
-    while(scope->symbols->next){
-        if(entry->key.data && entry->value){
-            symbol_t* sym = entry->value;
-            print_symbol(sym, indent + 1);
-        }
-        entry = scope->symbols->next;
+    void* value = NULL;
+    hm_iter_t it = hm_iter(scope->symbols);
+    while(hm_next(&it, NULL, &value)){
+        print_symbol(names, src, value, indent + 1);
     }
 }
 
-static inline void print_scope(scope_t* scope, int indent)
+static inline void print_scope(const string_pool_t* names, const source_t* src, scope_t* scope, int indent)
 {
     if(!scope) return;
 
     for(int i = 0; i < indent; i++) printf("  ");
     printf("\033[34mScope\033[0m \033[1m%s\033[0m\n", scope_kind_to_str(scope->kind));
 
-    print_scope_symbols(scope, indent + 1);
+    print_scope_symbols(names, src, scope, indent + 1);
 
     if(scope->first_child){
         for(int i = 0; i < indent; i++) printf("  ");
@@ -584,7 +601,7 @@ static inline void print_scope(scope_t* scope, int indent)
 
         scope_t* child = scope->first_child;
         while(child){
-            print_scope(child, indent + 1);
+            print_scope(names, src, child, indent + 1);
             child = child->next_sibling;
         }
     }
@@ -600,7 +617,7 @@ static inline void print_symbol_table(symbol_table_t* st)
     printf("Current scope depth: %d\n", st->current ? st->current->depth : -1);
     printf("\n");
 
-    if(st->global) print_scope(st->global, 0);
+    if(st->global) print_scope(&st->ctx->memory.perm_strings, st->ctx->src_manager.current, st->global, 0);
 }
 
 static inline void print_current_scope(symbol_table_t* st)
@@ -609,7 +626,7 @@ static inline void print_current_scope(symbol_table_t* st)
         printf("Current scope: (null)\n"); return;
     }
 
-    print_scope(st->current, 0);
+    print_scope(&st->ctx->memory.perm_strings, st->ctx->src_manager.current, st->current, 0);
 }
 
 static inline void print_symbol_lookup(symbol_table_t* st, const char* name)
@@ -618,21 +635,22 @@ static inline void print_symbol_lookup(symbol_table_t* st, const char* name)
         printf("Symbol lookup: invalid parameters\n"); return;
     }
 
-    symbol_t* sym = lookup_symbol(st, name);
+    const atom_t atom = sp_lookup_n(&st->ctx->memory.perm_strings, name, strlen(name));
+    symbol_t* sym = lookup_symbol(st, atom);
     if(sym){
-        print_symbol(sym, 0);
+        print_symbol(&st->ctx->memory.perm_strings, st->ctx->src_manager.current, sym, 0);
     }
     else {
         printf("\033[31mSymbol '%s' not found\033[0m\n", name);
     }
 }
 
-#define print_token(t) print_token(t)
+#define print_token(t, src) print_token(t, src)
 #define print_token_list(tokens, count) print_token_list(tokens, count)
-#define print_ast(n, i) print_node(n, i)
+#define print_ast(ast, n, i) print_node(ast, n, i)
 #define print_symbol_table(st) print_symbol_table(st)
 #define print_current_scope(st) print_current_scope(st)
 #define print_symbol_lookup(st, name) print_symbol_lookup(st, name)
-#define print_symbol(sym, indent) print_symbol(sym, indent)
+#define print_symbol(names, src, sym, indent) print_symbol(names, src, sym, indent)
 
 #endif
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdbool.h>    // bool
 #include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t, int64_t
 
 #include "core/ds/strings.h"    // string_pool_t
 #include "core/ds/arena.h"      // arena_t
@@ -19,6 +21,7 @@ enum report_code {
     ERR_UNEXP_EOF,
     ERR_INVAL_LIT,
     ERR_INVAL_NUM,
+    ERR_NUM_RANGE,
     ERR_INVAL_IDENT,
     ERR_INVAL_STR,
     ERR_UNCLO_STR,
@@ -37,6 +40,7 @@ enum report_code {
     ERR_EXPEC_KEYWORD,
     ERR_EXPEC_DELIM,
     ERR_EXPEC_PARAM,
+    ERR_NEST_DEPTH,
 
     // SEMANTIC
     ERR_TYPE_MISMATCH,
@@ -61,7 +65,7 @@ enum report_code {
 
 typedef struct {
     string_t* filename;
-    string_t* line;
+    const source_t* source; // line and column are looked up when the report is printed
 
     enum report_severity severity;
     enum report_code code;
@@ -75,6 +79,13 @@ typedef struct {
     size_t count;
 } report_table_t;
 
+typedef struct {
+    const report_table_t* table;
+    const arena_block_t* block;
+    size_t offset;  // into the block
+    size_t index;   // reports returned so far
+} report_iter_t;
+
 void add_report(
     report_table_t* table,
     const source_t* src,
@@ -83,5 +94,16 @@ void add_report(
     const location_t loc
 );
 report_table_t* new_report_table(arena_t* arena);
+
+// Updates the reports of `src` after its text [begin, end) was scanned again
+// and everything from `end` on moved by `delta` bytes. The reports from
+// index `fresh` on came from the new scan: they replace the old ones in the
+// range and keep their place in offset order. Reports of other sources
+// are left alone.
+bool replace_reports(report_table_t* table, const source_t* src, const size_t fresh,
+                     const uint32_t begin, const uint32_t end, const int64_t delta);
 void print_report_table(const report_table_t* table);
+
+report_iter_t report_iter(const report_table_t* table);
+const report_t* report_next(report_iter_t* it);   // NULL after the last report
 void free_report_table(report_table_t* table);
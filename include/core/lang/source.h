@@ -2,23 +2,39 @@
 
 #include <stdbool.h>    // bool
 #include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t
+#include <stdio.h>      // FILE
 
+#include "core/ds/arena.h"      // arena_t
 #include "core/ds/strings.h"    // string_pool_t
 
 #define SOURCE_EXTENSION ".brc"
 
+#define SRC_STREAM_CHUNK (64 * 1024)    // bytes read from a stream per refill
+#define SRC_PADDING 16                  // zero bytes that always follow the content
+
+// byte range in the source content, line and column are looked up on demand
 typedef struct {
-    size_t line;
-    size_t column;
-    size_t offset;
-    size_t length;
+    uint32_t offset;
+    uint32_t length;
 } location_t;
 
 typedef struct {
     string_t* filename;
     string_t* content;
+    uint32_t* line_starts;  // offset of the first byte of every line, see src_index_lines
     size_t line_count;
-    bool loaded;
+    size_t line_capacity;   // entries line_starts has room for, edits grow it in place
+    bool loaded;            // the whole input is in `content`
+
+    // storage of sources that own their content, see load_source_from_file
+    string_t name;
+    string_t text;
+    void* mapping;          // mapped file pages followed by zero pages
+    size_t mapping_size;
+    FILE* stream;           // input still to be read, NULL once it is drained
+    arena_t* stream_buffer; // reserved range the stream is read into, so the content never moves
+    size_t stream_size;     // bytes of it in use, content and padding
 } source_t;
 
 typedef struct {
@@ -29,20 +45,34 @@ typedef struct {
 } source_manager_t;
 
 source_t* new_source(const char* filename);
+void free_source(source_t* source);
 
 void new_source_manager(void);
 void free_source_manager(source_manager_t* manager);
 
+// Regular files are mapped, the content is the page cache itself. Anything
+// that can't be mapped (pipes, terminals) is read as a stream instead.
 source_t* load_source_from_file(const char* filepath);
+source_t* load_source_from_stream(FILE* file, const char* name);   // closes `file` once drained
+
+// appends up to SRC_STREAM_CHUNK more bytes of a stream, the content stays
+// at the same address. False once there is nothing left to read.
+bool src_refill(source_t* source);
 
 bool src_set_filename(source_t* source, const char* filename);
 bool src_set_content(source_t* source, const char* content, size_t length);
 
 int is_source_correct_extension(const char* filepath);
 
-size_t src_get_line(source_t* source, size_t offset);
-size_t src_get_column(source_t* source, size_t offset);
-bool src_get_line_range(source_t* source, size_t line, size_t* start, size_t* end);
+bool src_index_lines(source_t* source, arena_t* arena);
+
+// keeps the line index up to date after `removed` bytes at `offset` were
+// replaced by `inserted` bytes. Only the inserted text is scanned, the
+// starts past the edit are moved. A source without an index keeps none.
+bool src_update_lines(source_t* source, arena_t* arena, uint32_t offset, uint32_t removed, uint32_t inserted);
+size_t src_get_line(const source_t* source, size_t offset);
+size_t src_get_column(const source_t* source, size_t offset);
+bool src_get_line_range(const source_t* source, size_t line, size_t* start, size_t* end);
 
 location_t new_location(void);
 location_t loc_copy(location_t loc, size_t len);
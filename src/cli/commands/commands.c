@@ -6,17 +6,12 @@
 
 command_list_t new_command_list(void)
 {
-    return (command_list_t){.items = NULL, .count = 0};
+    return (command_list_t){.elems = NULL, .count = 0, .capacity = 0};
 }
 
 void free_command_list(command_list_t* list)
 {
-    if(!list) return;
-    if(list->items){
-        free(list->items);
-        list->items = NULL;
-    }
-    list->count = 0;
+    command_list_free(NULL, list);
 }
 
 void cmd_add(
@@ -29,7 +24,7 @@ void cmd_add(
     void* userdata)
 {
     command_t cmd = {
-        .name = {name, 0, hm_hash(name)},
+        .name = {name, strlen(name), hm_hash(name), ATOM_NONE},
         .description = description,
         .usage = usage,
         .options = options,
@@ -37,7 +32,5 @@ void cmd_add(
         .userdata = userdata
     };
 
-    list->items = realloc(list->items, sizeof(command_t) * (list->count + 1));
-    list->items[list->count] = cmd;
-    list->count++;
+    command_list_push(NULL, list, cmd);
 }
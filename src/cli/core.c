@@ -1,7 +1,7 @@
 #include <stdlib.h>     // malloc, free
-#include <string.h>     // strcmp
+#include <string.h>     // strlen
 
-#include "core/ds/hashmap.h"// hs_hash
+#include "core/ds/hashmap.h"// hm_hash_n
 #include "cli/core.h"       // cli_t, command_t
 #include "cli/commands.h"   // free_command
 
@@ -26,9 +26,13 @@ command_t find_command(cli_t* cli, const char* name)
 {
     if(!cli || !name) return (command_t){0};
 
+    // hash once, a matching hash alone could still be a different command
+    const size_t length = strlen(name);
+    const string_t key = {name, length, hm_hash_n(name, length), ATOM_NONE};
+
     for(size_t i = 0; i < cli->commands.count; ++i){
-        if(cli->commands.items[i].name.hash == hm_hash(name)){
-            return cli->commands.items[i];
+        if(string_equal(cli->commands.elems[i].name, key)){
+            return cli->commands.elems[i];
         }
     }
     return (command_t){0};
@@ -32,10 +32,8 @@ void free_codegen(codegen_t* codegen)
         codegen->string_table = NULL;
     }
 
-    if (codegen->arena) {
-        free_arena(codegen->arena);
-        codegen->arena = NULL;
-    }
+    // codegen itself lives in its arena
+    if (codegen->arena) free_arena(codegen->arena);
 }
 
 void cg_generate(codegen_t* codegen, ast_t* ast)
@@ -20,9 +20,12 @@ compiler_context_t* new_compiler_context(void)
     ctx->options.debug = false;
     ctx->options.verbose = false;
     ctx->options.repl = false;
+    ctx->options.dump_tokens = true;
     ctx->options.optimization = NONE;
 
-    arena_t* perm_arena  = new_arena(ARENA_PERM_SIZE);
+    // perm data lives for the whole compile, keep it in one contiguous range
+    arena_t* perm_arena  = new_vm_arena(ARENA_VM_RESERVE, true);
+    if(!perm_arena) perm_arena = new_arena(ARENA_PERM_SIZE);
     arena_t* temp_arena  = new_arena(ARENA_TEMP_SIZE);
     arena_t* phase_arena = new_arena(ARENA_PHASE_SIZE);
 
@@ -45,8 +48,9 @@ compiler_context_t* new_compiler_context(void)
     ctx->memory.local_idents = new_hashmap();
 
     ctx->reports = new_report_table(perm_arena);
+    ctx->literals = new_literal_table();
 
-    ctx->ast = new_ast(ctx->memory.perm_arena);
+    ctx->ast = new_ast(ctx->memory.perm_arena, &ctx->memory.perm_strings);
     ctx->symbols = new_symbol_table(ctx);
     ctx->ir = new_ir();
     ctx->codegen = new_codegen();
@@ -58,10 +62,12 @@ void free_compiler_context(compiler_context_t* ctx)
 {
     if(!ctx) return;
 
-    if(ctx->symbols) ctx->symbols = NULL;
-    if(ctx->ir->instrs) free_ir(ctx->ir);
-    if(ctx->codegen->arena || ctx->codegen->string_table) free_codegen(ctx->codegen);
-    if(ctx->reports->arena) free_report_table(ctx->reports);
+    if(ctx->ast) free_ast(ctx->ast);
+    if(ctx->symbols) free_symbol_table(ctx->symbols);
+    if(ctx->ir && ctx->ir->instrs) free_ir(ctx->ir);
+    if(ctx->codegen && (ctx->codegen->arena || ctx->codegen->string_table)) free_codegen(ctx->codegen);
+    if(ctx->reports && ctx->reports->arena) free_report_table(ctx->reports);
+    free_literal_table(&ctx->literals);
 
     free_hashmap(ctx->memory.global_idents);
     free_hashmap(ctx->memory.local_idents);
@@ -71,5 +77,9 @@ void free_compiler_context(compiler_context_t* ctx)
 
     if(ctx->src_manager.current) free_source_manager(&ctx->src_manager);
 
+    free_arena(ctx->memory.perm_arena);
+    free_arena(ctx->memory.temp_arena);
+    free_arena(ctx->memory.phase_arena);
+
     free(ctx);
 }
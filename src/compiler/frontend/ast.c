@@ -1,221 +1,94 @@
-#include "compiler/frontend/lexer/tokens.h" // token_t
-#include "compiler/frontend/ast.h"  // node_t, arena_t
+#include <stdlib.h>
+#include <string.h>
 
-ast_t* new_ast(arena_t* arena)
+#include "compiler/frontend/lexer/tokens.h" // DT_VOID
+#include "compiler/frontend/ast.h"  // ast_t, node_t
+
+ast_t* new_ast(arena_t* arena, const string_pool_t* names)
 {
-    ast_t* ast = arena_alloc_default(arena, sizeof(ast_t));
-    ast->arena = arena;
-    ast->nodes = NULL;
+    ast_t* ast = arena_alloc_uninit(arena, sizeof(ast_t), alignof(ast_t));
+    if(!ast) return NULL;
+
+    ast->nodes = malloc(AST_DEF_CAPACITY * sizeof(node_t));
+    ast->extra = malloc(AST_DEF_CAPACITY * sizeof(uint32_t));
+    if(!ast->nodes || !ast->extra){
+        free(ast->nodes);
+        free(ast->extra);
+        return NULL;
+    }
+
     ast->count = 0;
+    ast->capacity = AST_DEF_CAPACITY;
+    ast->extra_count = 0;
+    ast->extra_capacity = AST_DEF_CAPACITY;
+    ast->root = NODE_NONE;
+    for(size_t i = 0; i < NUM_NODE_KINDS; i++) ast->kinds[i] = (nodes_t){0};
+    ast->names = names;
+    ast->arena = arena;
     return ast;
 }
 
-node_t* new_node(arena_t* arena, enum node_kind kind)
+void free_ast(ast_t* ast)
+{
+    if(!ast) return;
+    free(ast->nodes);
+    ast->nodes = NULL;
+    free(ast->extra);
+    ast->extra = NULL;
+    ast->count = ast->capacity = 0;
+    ast->extra_count = ast->extra_capacity = 0;
+    ast->root = NODE_NONE;
+    for(size_t i = 0; i < NUM_NODE_KINDS; i++) nodes_free(NULL, &ast->kinds[i]);
+}
+
+node_id_t new_node(ast_t* ast, enum node_kind kind)
+{
+    if(!ast || (unsigned)kind >= NUM_NODE_KINDS) return NODE_NONE;
+
+    if(ast->count >= ast->capacity){
+        if(ast->capacity > UINT32_MAX / 2) return NODE_NONE;
+        uint32_t new_capacity = ast->capacity ? ast->capacity * 2 : AST_DEF_CAPACITY;
+        node_t* new_nodes = realloc(ast->nodes, sizeof(node_t) * new_capacity);
+        if(!new_nodes) return NODE_NONE;
+        ast->nodes = new_nodes;
+        ast->capacity = new_capacity;
+    }
+
+    if(!nodes_push(NULL, &ast->kinds[kind], ast->count + 1)) return NODE_NONE;
+
+    // payloads are zeroed, only non-zero defaults are set below
+    node_t* node = &ast->nodes[ast->count];
+    memset(node, 0, sizeof(node_t));
+    node->kind = (uint8_t)kind;
+    node->loc = new_location();
+
+    if(kind == NODE_FUNC) node->func_decl.return_type = DT_VOID;
+
+    return ++ast->count;
+}
+
+bool new_node_list(ast_t* ast, const uint32_t* items, const size_t count, node_list_t* list)
 {
-    node_t* node = arena_alloc_default(arena, sizeof(node_t));
-    if (!node) return NULL;
-
-    node->kind = kind;
-    node->loc = (location_t){1, 1, 0, 0};
-
-    switch(kind)
-    {
-        case NODE_BINOP:
-            node->binop = arena_alloc_default(arena, sizeof(struct node_binop));
-            if(!node->binop) return NULL;
-            node->binop->left = NULL;
-            node->binop->right = NULL;
-            node->binop->operator = 0;
-#ifdef DEBUG
-            node->binop->lit = NULL;
-#endif
-            break;
-        case NODE_UNARYOP:
-            node->unaryop = arena_alloc_default(arena, sizeof(struct node_unaryop));
-            if(!node->unaryop) return NULL;
-            node->unaryop->right = NULL;
-            node->unaryop->operator = 0;
-            node->unaryop->is_postfix = false;
-#ifdef DEBUG
-            node->unaryop->lit = NULL;
-#endif
-            break;
-        case NODE_ASSIGN:
-            node->var_assign = arena_alloc_default(arena, sizeof(struct node_var_assign));
-            if(!node->var_assign) return NULL;
-            node->var_assign->name = (string_t){0};
-            node->var_assign->value = NULL;
-            break;
-        case NODE_REFERENCE:
-            node->var_ref = arena_alloc_default(arena, sizeof(struct node_var_ref));
-            if(!node->var_ref) return NULL;
-            node->var_ref->name = (string_t){0};
-            break;
-        case NODE_BLOCK:
-            node->block = arena_alloc_default(arena, sizeof(struct node_block));
-            if(!node->block) return NULL;
-            node->block->statement.elems = NULL;
-            node->block->statement.count = 0;
-            node->block->statement.capacity = 0;
-            break;
-        case NODE_CALL:
-            node->func_call = arena_alloc_default(arena, sizeof(struct node_func_call));
-            if(!node->func_call) return NULL;
-            node->func_call->args.elems = NULL;
-            node->func_call->args.count = 0;
-            node->func_call->args.capacity = 0;
-            break;
-        case NODE_RETURN:
-            node->return_stmt = arena_alloc_default(arena, sizeof(struct node_return));
-            if(!node->return_stmt) return NULL;
-            node->return_stmt->body = NULL;
-            break;
-        case NODE_LITERAL:
-            node->lit = arena_alloc_default(arena, sizeof(struct node_literal));
-            if(!node->lit) return NULL;
-            node->lit->type = LIT_NULL;
-            node->lit->value = (string_t){0};
-            break;
-        case NODE_RANGE:
-            node->range = arena_alloc_default(arena, sizeof(struct node_range));
-            if(!node->range) return NULL;
-            node->range->start = NULL;
-            node->range->end = NULL;
-            break;
-        case NODE_FOR:
-            node->for_stmt = arena_alloc_default(arena, sizeof(struct node_for));
-            if(!node->for_stmt) return NULL;
-            node->for_stmt->init = NULL;
-            node->for_stmt->condition = NULL;
-            node->for_stmt->update = NULL;
-            node->for_stmt->body = NULL;
-            break;
-        case NODE_IF:
-            node->if_stmt = arena_alloc_default(arena, sizeof(struct node_if));
-            if(!node->if_stmt) return NULL;
-            node->if_stmt->condition = NULL;
-            node->if_stmt->then_block = NULL;
-            node->if_stmt->elif_blocks = NULL;
-            node->if_stmt->else_block = NULL;
-            break;
-        case NODE_WHILE:
-            node->while_stmt = arena_alloc_default(arena, sizeof(struct node_while));
-            if(!node->while_stmt) return NULL;
-            node->while_stmt->condition = NULL;
-            node->while_stmt->body = NULL;
-            break;
-        case NODE_MATCH:
-            node->match_stmt = arena_alloc_default(arena, sizeof(struct node_match));
-            if(!node->match_stmt) return NULL;
-            node->match_stmt->target = NULL;
-            node->match_stmt->block.elems = NULL;
-            node->match_stmt->block.count = 0;
-            node->match_stmt->block.capacity = 0;
-            break;
-        case NODE_CASE:
-            node->case_stmt = arena_alloc_default(arena, sizeof(struct node_case));
-            if(!node->case_stmt) return NULL;
-            node->case_stmt->condition = NULL;
-            node->case_stmt->body = NULL;
-            break;
-        case NODE_TRY:
-            node->try_stmt = arena_alloc_default(arena, sizeof(struct node_try));
-            if(!node->try_stmt) return NULL;
-            node->try_stmt->try_block = NULL;
-            break;
-        case NODE_CATCH:
-            node->catch_stmt = arena_alloc_default(arena, sizeof(struct node_catch));
-            if(!node->catch_stmt) return NULL;
-            node->catch_stmt->catch_block = NULL;
-            break;
-        case NODE_VARIABLE:
-            node->var_decl = arena_alloc_default(arena, sizeof(struct node_variable));
-            if(!node->var_decl) return NULL;
-            node->var_decl->modif = MOD_VAR;
-            node->var_decl->dtype = DT_INT;
-            node->var_decl->value = NULL;
-            node->var_decl->name = (string_t){0};
-            break;
-        case NODE_ARRAY:
-            node->array_decl = arena_alloc_default(arena, sizeof(struct node_array));
-            if(!node->array_decl) return NULL;
-            node->array_decl->elements = NULL;
-            node->array_decl->count = 0;
-            node->array_decl->capacity = 0;
-            break;
-        case NODE_PARAM:
-            node->param_decl = arena_alloc_default(arena, sizeof(struct node_param));
-            if(!node->param_decl) return NULL;
-            node->param_decl->name = (string_t){0};
-            break;
-        case NODE_FUNC:
-            node->func_decl = arena_alloc_default(arena, sizeof(struct node_func));
-            if(!node->func_decl) return NULL;
-            node->func_decl->return_type = DT_VOID;
-            node->func_decl->body = NULL;
-            node->func_decl->name = (string_t){0};
-            node->func_decl->param_decl.count = 0;
-            node->func_decl->param_decl.capacity = 4;
-            node->func_decl->param_decl.elems = arena_alloc_default(arena, node->func_decl->param_decl.capacity * sizeof(node_t*));
-            if(!node->func_decl->param_decl.elems) return NULL;
-            break;
-        case NODE_STRUCT:
-            node->struct_decl = arena_alloc_default(arena, sizeof(struct node_struct));
-            if(!node->struct_decl) return NULL;
-            node->struct_decl->member.elems = NULL;
-            node->struct_decl->member.count = 0;
-            node->struct_decl->member.capacity = 0;
-            node->struct_decl->name = (string_t){0};
-            break;
-        case NODE_VARIANT:
-            node->variant_decl = arena_alloc_default(arena, sizeof(struct node_variant));
-            if(!node->variant_decl) return NULL;
-            node->variant_decl->name = (string_t){0};
-            node->variant_decl->value = NULL;
-            break;
-        case NODE_ENUM:
-            node->enum_decl = arena_alloc_default(arena, sizeof(struct node_enum));
-            if(!node->enum_decl) return NULL;
-            node->enum_decl->member.elems = NULL;
-            node->enum_decl->member.count = 0;
-            node->enum_decl->member.capacity = 0;
-            node->enum_decl->name = (string_t){0};
-            break;
-        case NODE_TRAIT:
-            node->trait_decl = arena_alloc_default(arena, sizeof(struct node_trait));
-            if(!node->trait_decl) return NULL;
-            node->trait_decl->body = NULL;
-            node->trait_decl->name = (string_t){0};
-            break;
-        case NODE_IMPL:
-            node->impl_decl = arena_alloc_default(arena, sizeof(struct node_impl));
-            if(!node->impl_decl) return NULL;
-            node->impl_decl->body = NULL;
-            node->impl_decl->trait_name = (string_t){0};
-            node->impl_decl->struct_name = (string_t){0};
-            break;
-        case NODE_TYPE:
-            node->type_decl = arena_alloc_default(arena, sizeof(struct node_type));
-            if(!node->type_decl) return NULL;
-            node->type_decl->body = NULL;
-            node->type_decl->name = (string_t){0};
-            break;
-        case NODE_IMPORT:
-            node->import_decl = arena_alloc_default(arena, sizeof(struct node_import));
-            if(!node->import_decl) return NULL;
-            node->import_decl->count = 0;
-            node->import_decl->capacity = 16;
-            node->import_decl->modules = arena_alloc_array(arena, sizeof(string_t), node->import_decl->capacity, alignof(string_t));
-            if(!node->import_decl->modules) return NULL;
-            break;
-        case NODE_MODULE:
-            node->module_decl = arena_alloc_default(arena, sizeof(struct node_module));
-            if(!node->module_decl) return NULL;
-            node->module_decl->body = NULL;
-            node->module_decl->name = (string_t){0};
-            break;
-        default:
-            break;
+    if(!ast || !list) return false;
+
+    *list = (node_list_t){0};
+    if(count == 0) return true;
+
+    if(count > UINT32_MAX - ast->extra_count) return false;
+    if(ast->extra_count + count > ast->extra_capacity){
+        size_t new_capacity = ast->extra_capacity ? ast->extra_capacity : AST_DEF_CAPACITY;
+        while(new_capacity < ast->extra_count + count) new_capacity *= 2;
+        if(new_capacity > UINT32_MAX) new_capacity = UINT32_MAX;
+
+        uint32_t* new_extra = realloc(ast->extra, sizeof(uint32_t) * new_capacity);
+        if(!new_extra) return false;
+        ast->extra = new_extra;
+        ast->extra_capacity = (uint32_t)new_capacity;
     }
-    return node;
+
+    memcpy(ast->extra + ast->extra_count, items, count * sizeof(uint32_t));
+    list->start = ast->extra_count;
+    list->count = (uint32_t)count;
+    ast->extra_count += (uint32_t)count;
+    return true;
 }
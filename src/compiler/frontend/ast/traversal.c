@@ -0,0 +1,219 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/ds/vector.h"                     // VECTOR_DEFINE
+#include "compiler/frontend/ast/traversal.h"    // ast_order_t, ast_entry_t, ast_iter_t
+
+// a node whose children are being flattened
+typedef struct {
+    node_id_t node;
+    uint32_t next;      // child to descend into next
+    uint32_t children;
+    uint32_t first;     // entry its first descendant will get
+} frame_t;
+
+VECTOR_DEFINE(frames, frame_t)
+
+uint32_t node_child_count(const ast_t* ast, const node_id_t id)
+{
+    const node_t* node = ast_node(ast, id);
+
+    switch(node->kind){
+        case NODE_BINOP:
+        case NODE_RANGE:
+        case NODE_WHILE:
+        case NODE_CASE:
+            return 2;
+
+        case NODE_IF:
+        case NODE_FOR:
+            return 4;
+
+        case NODE_UNARYOP:
+        case NODE_ASSIGN:
+        case NODE_VARIABLE:
+        case NODE_VARIANT:
+        case NODE_RETURN:
+        case NODE_TYPE:
+        case NODE_MODULE:
+        case NODE_TRAIT:
+        case NODE_IMPL:
+        case NODE_TRY:
+        case NODE_CATCH:
+            return 1;
+
+        case NODE_BLOCK:  return node->block.statement.count;
+        case NODE_CALL:   return node->func_call.args.count;
+        case NODE_ARRAY:  return node->array_decl.elements.count;
+        case NODE_STRUCT: return node->struct_decl.member.count;
+        case NODE_ENUM:   return node->enum_decl.member.count;
+        case NODE_FUNC:   return node->func_decl.param_decl.count + 1;
+        case NODE_MATCH:  return node->match_stmt.block.count + 1;
+
+        // imports list atoms, not nodes
+        default: return 0;
+    }
+}
+
+node_id_t node_child(const ast_t* ast, const node_id_t id, const uint32_t index)
+{
+    const node_t* node = ast_node(ast, id);
+
+    switch(node->kind){
+        case NODE_BINOP: return index == 0 ? node->binop.left : node->binop.right;
+        case NODE_RANGE: return index == 0 ? node->range.start : node->range.end;
+        case NODE_WHILE: return index == 0 ? node->while_stmt.condition : node->while_stmt.body;
+        case NODE_CASE:  return index == 0 ? node->case_stmt.condition : node->case_stmt.body;
+
+        case NODE_IF:
+            switch(index){
+                case 0:  return node->if_stmt.condition;
+                case 1:  return node->if_stmt.then_block;
+                case 2:  return node->if_stmt.elif_blocks;
+                default: return node->if_stmt.else_block;
+            }
+        case NODE_FOR:
+            switch(index){
+                case 0:  return node->for_stmt.init;
+                case 1:  return node->for_stmt.condition;
+                case 2:  return node->for_stmt.update;
+                default: return node->for_stmt.body;
+            }
+
+        case NODE_UNARYOP:  return node->unaryop.right;
+        case NODE_ASSIGN:   return node->var_assign.value;
+        case NODE_VARIABLE: return node->var_decl.value;
+        case NODE_VARIANT:  return node->variant_decl.value;
+        case NODE_RETURN:   return node->return_stmt.body;
+        case NODE_TYPE:     return node->type_decl.body;
+        case NODE_MODULE:   return node->module_decl.body;
+        case NODE_TRAIT:    return node->trait_decl.body;
+        case NODE_IMPL:     return node->impl_decl.body;
+        case NODE_TRY:      return node->try_stmt.try_block;
+        case NODE_CATCH:    return node->catch_stmt.catch_block;
+
+        case NODE_BLOCK:  return ast_list(ast, node->block.statement)[index];
+        case NODE_CALL:   return ast_list(ast, node->func_call.args)[index];
+        case NODE_ARRAY:  return ast_list(ast, node->array_decl.elements)[index];
+        case NODE_STRUCT: return ast_list(ast, node->struct_decl.member)[index];
+        case NODE_ENUM:   return ast_list(ast, node->enum_decl.member)[index];
+
+        // parameters, then the body
+        case NODE_FUNC:
+            if(index == node->func_decl.param_decl.count) return node->func_decl.body;
+            return ast_list(ast, node->func_decl.param_decl)[index];
+
+        // the target, then the cases
+        case NODE_MATCH:
+            if(index == 0) return node->match_stmt.target;
+            return ast_list(ast, node->match_stmt.block)[index - 1];
+
+        default: return NODE_NONE;
+    }
+}
+
+bool linearize_ast(const ast_t* ast, const node_id_t root, ast_order_t* order)
+{
+    if(!ast || !order || root == NODE_NONE || root > ast->count) return false;
+
+    free_ast_order(order);
+
+    // every node appears at most once, so the entries never outgrow the node count
+    order->entries = malloc(ast->count * sizeof(ast_entry_t));
+    order->position = malloc(ast->count * sizeof(uint32_t));
+    if(!order->entries || !order->position){
+        free_ast_order(order);
+        return false;
+    }
+    memset(order->position, 0xFF, ast->count * sizeof(uint32_t));
+    order->node_count = ast->count;
+
+    // an explicit stack, a long operator chain is as deep as it is long
+    frames_t stack = {0};
+    if(!frames_push(NULL, &stack, (frame_t){root, 0, node_child_count(ast, root), 0})){
+        free_ast_order(order);
+        return false;
+    }
+
+    while(stack.count > 0){
+        frame_t* top = &stack.elems[stack.count - 1];
+
+        if(top->next < top->children){
+            const node_id_t child = node_child(ast, top->node, top->next++);
+            if(child == NODE_NONE) continue;
+
+            if(!frames_push(NULL, &stack, (frame_t){child, 0, node_child_count(ast, child), order->count})){
+                frames_free(NULL, &stack);
+                free_ast_order(order);
+                return false;
+            }
+            continue;
+        }
+
+        // a node shared by two parents would be flattened twice
+        if(order->count == ast->count){
+            frames_free(NULL, &stack);
+            free_ast_order(order);
+            return false;
+        }
+
+        order->position[top->node - 1] = order->count;
+        order->entries[order->count++] = (ast_entry_t){top->node, top->first};
+        stack.count--;
+    }
+
+    frames_free(NULL, &stack);
+    return true;
+}
+
+void free_ast_order(ast_order_t* order)
+{
+    if(!order) return;
+    free(order->entries);
+    free(order->position);
+    *order = (ast_order_t){0};
+}
+
+bool prune_node_kinds(ast_t* ast)
+{
+    if(!ast || ast->root == NODE_NONE) return false;
+
+    // without shared nodes every node but the root is referred to once,
+    // unless it is the top of a failed statement
+    uint32_t refs = 0;
+    for(node_id_t id = 1; id <= ast->count; id++){
+        const uint32_t children = node_child_count(ast, id);
+        for(uint32_t i = 0; i < children; i++){
+            refs += node_child(ast, id, i) != NODE_NONE;
+        }
+    }
+    if(refs == ast->count - 1) return true;
+
+    ast_order_t order = {0};
+    if(!linearize_ast(ast, ast->root, &order)) return false;
+
+    for(size_t kind = 0; kind < NUM_NODE_KINDS; kind++){
+        nodes_t* list = &ast->kinds[kind];
+        size_t kept = 0;
+        for(size_t i = 0; i < list->count; i++){
+            if(order.position[list->elems[i] - 1] != ENTRY_NONE) list->elems[kept++] = list->elems[i];
+        }
+        list->count = kept;
+    }
+
+    free_ast_order(&order);
+    return true;
+}
+
+ast_iter_t ast_subtree(const ast_order_t* order, const node_id_t id)
+{
+    if(!order || id == NODE_NONE || id > order->node_count) return (ast_iter_t){0};
+
+    const uint32_t last = order->position[id - 1];
+    if(last == ENTRY_NONE) return (ast_iter_t){0};
+
+    return (ast_iter_t){
+        .next = order->entries + order->entries[last].first,
+        .end  = order->entries + last + 1,
+    };
+}
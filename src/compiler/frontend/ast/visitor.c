@@ -1,17 +1,88 @@
-#include "compiler/frontend/ast/visitor.h"  // ast_visitor_t, new_ast_visitor, free_ast_visitor, ast_visit
+#include <string.h>
 
-ast_visitor_t* new_ast_visitor(void)
+#include "compiler/frontend/ast/traversal.h"    // node_child_count, node_child
+#include "compiler/frontend/ast/visitor.h"      // ast_visitor_t, new_ast_visitor, free_ast_visitor, ast_visit
+
+ast_visitor_t* new_ast_visitor(arena_t* arena, void* state)
 {
-    // TODO: implement
+    if(!arena) return NULL;
+
+    ast_visitor_t* visitor = arena_alloc(arena, sizeof(ast_visitor_t), alignof(ast_visitor_t));
+    if(!visitor) return NULL;
+
+    visitor->arena = arena;
+    visitor->state = state;
+    memset(visitor->pre, 0, sizeof(visitor->pre));
+    memset(visitor->post, 0, sizeof(visitor->post));
+    visitor->stack = (visit_frames_t){0};
+    return visitor;
 }
 
 void free_ast_visitor(ast_visitor_t* visitor)
 {
-    // TODO: implement
+    if(!visitor) return;
+    visit_frames_free(NULL, &visitor->stack);
+}
+
+static inline enum visit_action call_hook(ast_visitor_t* visitor, const visit_func_t* hooks, const ast_t* ast, const node_id_t node)
+{
+    const visit_func_t hook = hooks[ast_node(ast, node)->kind];
+    return hook ? hook(visitor, ast, node) : VISIT_CONTINUE;
+}
+
+static bool enter_node(ast_visitor_t* visitor, const ast_t* ast, const node_id_t node, bool* stopped)
+{
+    const enum visit_action action = call_hook(visitor, visitor->pre, ast, node);
+    if(action == VISIT_STOP){
+        *stopped = true;
+        return true;
+    }
+
+    const uint32_t children = action == VISIT_SKIP ? 0 : node_child_count(ast, node);
+    return visit_frames_push(NULL, &visitor->stack, (visit_frame_t){node, 0, children});
 }
 
-void ast_visit(ast_visitor_t* visitor, ast_t* ast)
+bool ast_visit(ast_visitor_t* visitor, const ast_t* ast, const node_id_t root)
 {
-    // TODO: implement
+    if(!visitor || !ast || root == NODE_NONE || root > ast->count) return false;
+
+    // a hook may visit another subtree, its frames go above ours
+    const size_t base = visitor->stack.count;
+    bool stopped = false;
+
+    if(!enter_node(visitor, ast, root, &stopped)) return false;
+
+    while(!stopped && visitor->stack.count > base){
+        visit_frame_t* top = &visitor->stack.elems[visitor->stack.count - 1];
+
+        if(top->next < top->children){
+            const node_id_t child = node_child(ast, top->node, top->next++);
+            if(child == NODE_NONE) continue;
+            if(!enter_node(visitor, ast, child, &stopped)) break;
+            continue;
+        }
+
+        const node_id_t node = top->node;
+        visitor->stack.count--;
+        if(call_hook(visitor, visitor->post, ast, node) == VISIT_STOP) stopped = true;
+    }
+
+    const bool done = !stopped && visitor->stack.count == base;
+    visitor->stack.count = base;
+    return done;
 }
 
+bool ast_visit_kind(ast_visitor_t* visitor, const ast_t* ast, const enum node_kind kind)
+{
+    if(!visitor || !ast || (unsigned)kind >= NUM_NODE_KINDS) return false;
+
+    const visit_func_t pre = visitor->pre[kind];
+    const visit_func_t post = visitor->post[kind];
+    const nodes_t* nodes = &ast->kinds[kind];
+
+    for(size_t i = 0; i < nodes->count; i++){
+        if(pre && pre(visitor, ast, nodes->elems[i]) == VISIT_STOP) return false;
+        if(post && post(visitor, ast, nodes->elems[i]) == VISIT_STOP) return false;
+    }
+    return true;
+}
@@ -1,17 +1,23 @@
-#include <ctype.h>   // isalpha, isdigit
 #include <stdbool.h> // bool
 #include <stddef.h>  // size_t
-#include <stdlib.h>  // realloc, free
-#include <string.h>  // strlen, strncmp
+#include <stdint.h>  // uint8_t
+#include <stdlib.h>  // malloc, realloc, free
+#include <string.h>  // memcpy, memchr
 
-#include "core/ds/arena.h"        // arena_t
+#include "core/ds/arena.h"        // arena_t, arena_scratch_begin, free_scratch_arenas
 #include "core/ds/strings.h"      // string_t
 #include "core/lang/diagnostic.h" // diagnostic_t
 #include "compiler/frontend/lexer.h" // lexer_t, token_t
-
-#define IDENT_SIZE 16
-#define NUM_SIZE 32
-#define STR_SIZE 64
+#include "compiler/frontend/lexer/literals.h" // decode_integer, decode_float, add_constant
+#include "core/platform/unix.h"    // pthread_create, pthread_join
+#include "core/platform/windows.h" // CreateThread, WaitForSingleObject
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>                // _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#define LEXER_SIMD 1                  // 16 bytes per step, needs __builtin_ctz/clz/popcount
+#endif
+#ifdef DEBUG
+#include "core/lang/debug.h"      // print_token
+#endif
 
 #define MAX_IDENT_SIZE 64
 #define MAX_NUM_SIZE 128
@@ -22,90 +28,803 @@ token_t handle_paren(lexer_t* lexer);
 token_t handle_number(lexer_t* lexer);
 token_t handle_ident(lexer_t* lexer);
 token_t handle_string(lexer_t* lexer);
+token_t handle_illegal(lexer_t* lexer);
 void handle_comment(lexer_t* lexer);
 
-string_t read_ident(lexer_t* lexer);
-string_t read_number(lexer_t* lexer, enum category_literal* lit);
-string_t read_string(lexer_t* lexer, char quote_char);
-char read_escseq(lexer_t* lexer);
-
-void read_ch(lexer_t* lexer)
+string_t read_string(lexer_t* lexer, const char* begin, size_t length);
+char read_escseq(lexer_t* lexer, const char** p);
+
+// character classes, a byte can be in several of them
+enum char_class {
+    CH_SPACE = 1 << 0,  // ' ', '\t', '\r', '\n'
+    CH_ALPHA = 1 << 1,  // letters and '_', starts an identifier
+    CH_DIGIT = 1 << 2,  // 0-9
+    CH_HEX   = 1 << 3,  // 0-9, a-f, A-F
+    CH_OPER  = 1 << 4,  // first byte of an operator
+    CH_PAREN = 1 << 5,  // ( ) { } [ ]
+    CH_QUOTE = 1 << 6,  // " '
+};
+
+#define CH_LETTER(c) [c] = CH_ALPHA
+#define CH_LHEX(c)  [c] = CH_ALPHA | CH_HEX
+
+// ASCII only, bytes above 0x7f and control characters have no class
+static const uint8_t char_class[256] = {
+    [' ']  = CH_SPACE, ['\t'] = CH_SPACE, ['\r'] = CH_SPACE, ['\n'] = CH_SPACE,
+
+    ['0'] = CH_DIGIT | CH_HEX, ['1'] = CH_DIGIT | CH_HEX, ['2'] = CH_DIGIT | CH_HEX,
+    ['3'] = CH_DIGIT | CH_HEX, ['4'] = CH_DIGIT | CH_HEX, ['5'] = CH_DIGIT | CH_HEX,
+    ['6'] = CH_DIGIT | CH_HEX, ['7'] = CH_DIGIT | CH_HEX, ['8'] = CH_DIGIT | CH_HEX,
+    ['9'] = CH_DIGIT | CH_HEX,
+
+    CH_LHEX('a'),  CH_LHEX('b'),  CH_LHEX('c'),  CH_LHEX('d'),  CH_LHEX('e'),  CH_LHEX('f'),
+    CH_LETTER('g'), CH_LETTER('h'), CH_LETTER('i'), CH_LETTER('j'), CH_LETTER('k'), CH_LETTER('l'),
+    CH_LETTER('m'), CH_LETTER('n'), CH_LETTER('o'), CH_LETTER('p'), CH_LETTER('q'), CH_LETTER('r'),
+    CH_LETTER('s'), CH_LETTER('t'), CH_LETTER('u'), CH_LETTER('v'), CH_LETTER('w'), CH_LETTER('x'),
+    CH_LETTER('y'), CH_LETTER('z'),
+
+    CH_LHEX('A'),  CH_LHEX('B'),  CH_LHEX('C'),  CH_LHEX('D'),  CH_LHEX('E'),  CH_LHEX('F'),
+    CH_LETTER('G'), CH_LETTER('H'), CH_LETTER('I'), CH_LETTER('J'), CH_LETTER('K'), CH_LETTER('L'),
+    CH_LETTER('M'), CH_LETTER('N'), CH_LETTER('O'), CH_LETTER('P'), CH_LETTER('Q'), CH_LETTER('R'),
+    CH_LETTER('S'), CH_LETTER('T'), CH_LETTER('U'), CH_LETTER('V'), CH_LETTER('W'), CH_LETTER('X'),
+    CH_LETTER('Y'), CH_LETTER('Z'),
+
+    ['_'] = CH_ALPHA,
+
+    ['+'] = CH_OPER, ['-'] = CH_OPER, ['*'] = CH_OPER, ['/'] = CH_OPER,
+    ['='] = CH_OPER, ['!'] = CH_OPER, ['<'] = CH_OPER, ['>'] = CH_OPER,
+    ['&'] = CH_OPER, ['|'] = CH_OPER, ['.'] = CH_OPER, [','] = CH_OPER,
+    [':'] = CH_OPER, [';'] = CH_OPER, ['?'] = CH_OPER, ['%'] = CH_OPER,
+
+    ['('] = CH_PAREN, [')'] = CH_PAREN, ['{'] = CH_PAREN,
+    ['}'] = CH_PAREN, ['['] = CH_PAREN, [']'] = CH_PAREN,
+
+    ['"'] = CH_QUOTE, ['\''] = CH_QUOTE,
+};
+
+#undef CH_LETTER
+#undef CH_LHEX
+
+static inline bool is_class(const char ch, const enum char_class class)
 {
-    if(!lexer || !lexer->ctx->src_manager.current) return;
+    return (char_class[(unsigned char)ch] & class) != 0;
+}
 
-    if(lexer->loc.offset++ >= lexer->ctx->src_manager.current->content->length){
-        lexer->ch = 0;
-    }
-    else {
-        lexer->ch = lexer->ctx->src_manager.current->content->data[lexer->loc.offset];
-        lexer->loc.column++;
-    }
+// location of the bytes from `at`, for reports raised in the middle of a token
+static inline location_t loc_at(const lexer_t* lexer, const char* at, size_t length)
+{
+    return (location_t){(uint32_t)(at - lexer->start), (uint32_t)length};
 }
 
 void skip_whitespace(lexer_t* lexer)
 {
-    while(true){
-        switch(lexer->ch){
-            case ' ': case '\t': case '\r':
-                read_ch(lexer);
-                break;
+    const char* p = lexer->cursor;
 
-            case '\n':
-                read_ch(lexer);
-                lexer->loc.line++;
-                lexer->loc.column = 1;
-                break;
+    // most tokens follow another token or a single space
+    if(!is_class(*p, CH_SPACE)) return;
+    if(!is_class(p[1], CH_SPACE)){
+        lexer->cursor = p + 1;
+        return;
+    }
 
-            default: return;
+#ifdef LEXER_SIMD
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab   = _mm_set1_epi8('\t');
+    const __m128i cr    = _mm_set1_epi8('\r');
+    const __m128i lf    = _mm_set1_epi8('\n');
+
+    while(p + 16 <= lexer->end){
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        const __m128i blank = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+
+        const unsigned blanks = (unsigned)_mm_movemask_epi8(blank);
+        if(blanks != 0xFFFF){
+            // the run of whitespace ends inside this chunk
+            lexer->cursor = p + __builtin_ctz(~blanks);
+            return;
         }
+        p += 16;
     }
+#endif
+
+    while(is_class(*p, CH_SPACE)) p++;
+    lexer->cursor = p;
 }
 
-char peek_ch(const lexer_t* lexer)
+// first byte in [p, end) that is `a`, `b` or NUL, or `end`
+static const char* find_special(const char* p, const char* end, const char a, const char b)
 {
-    if(!lexer || !lexer->ctx->src_manager.current){
-        return '\0';
+#ifdef LEXER_SIMD
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i nul = _mm_setzero_si128();
+
+    while(p + 16 <= end){
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        const __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+            _mm_cmpeq_epi8(chunk, nul));
+
+        const unsigned hits = (unsigned)_mm_movemask_epi8(hit);
+        if(hits) return p + __builtin_ctz(hits);
+        p += 16;
     }
+#endif
 
-    size_t npos = lexer->loc.offset + 1;
-    if(npos < lexer->ctx->src_manager.current->content->length){
-        return lexer->ctx->src_manager.current->content->data[npos];
-    }
-    return '\0';
+    while(p < end && *p != a && *p != b && *p != '\0') p++;
+    return p;
 }
 
 lexer_t* new_lexer(compiler_context_t* ctx)
 {
-    if(!ctx->src_manager.current) return NULL;
+    source_t* src = ctx->src_manager.current;
+    if(!src || !src->content || !src->content->data) return NULL;
+
+    // offsets are turned into lines only for diagnostics, a stream is
+    // indexed once it has been read to the end
+    if(!src->stream && !src_index_lines(src, ctx->memory.perm_arena)) return NULL;
 
     lexer_t* lexer = arena_alloc(ctx->memory.phase_arena, sizeof(lexer_t), alignof(lexer_t));
     if(!lexer) return NULL;
 
-    lexer->ch = ctx->src_manager.current->content->data[0];
+    lexer->start = src->content->data;
+    lexer->cursor = lexer->start;
+    lexer->end = lexer->start + src->content->length;
     lexer->loc = new_location();
     lexer->balance = 0;
+    lexer->streaming = src->stream != NULL;
     lexer->ctx = ctx;
 
     return lexer;
 }
 
-token_t next_token(lexer_t* lexer)
+static bool grow_token_buffer(token_buffer_t* buffer, const size_t capacity)
 {
-    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL, "NULL_LEXER");
+#define GROW(field)                                                             \
+    do {                                                                        \
+        void* grown = realloc(buffer->field, capacity * sizeof(*buffer->field)); \
+        if(!grown) return false;                                                \
+        buffer->field = grown;                                                  \
+    } while(0)
+
+    GROW(categories);
+    GROW(types);
+    GROW(atoms);
+    GROW(offsets);
+    GROW(lengths);
+#undef GROW
+
+    buffer->capacity = capacity;
+    return true;
+}
+
+static inline void store_token(token_buffer_t* buffer, const size_t i, const token_t token)
+{
+    buffer->categories[i] = token.category;
+    buffer->types[i] = token.type;
+    buffer->atoms[i] = token.atom;
+    buffer->offsets[i] = token.offset;
+    buffer->lengths[i] = token.length;
+}
+
+token_buffer_t* new_token_buffer(lexer_t* lexer)
+{
+    if(!lexer) return NULL;
+
+    token_buffer_t* buffer = calloc(1, sizeof(token_buffer_t));
+    if(!buffer) return NULL;
+
+    // about one token every four bytes of source
+    const size_t estimate = (size_t)(lexer->end - lexer->cursor) / 4 + 16;
+    if(!grow_token_buffer(buffer, estimate)){
+        free_token_buffer(buffer);
+        return NULL;
+    }
+
+    while(true){
+        if(buffer->count == buffer->capacity && !grow_token_buffer(buffer, buffer->capacity * 2)){
+            free_token_buffer(buffer);
+            return NULL;
+        }
+
+        const token_t token = next_token(lexer);
+        store_token(buffer, buffer->count++, token);
+
+        if(token.category == CAT_SERVICE && token.type == SERV_EOF) break;
+    }
+    return buffer;
+}
+
+void free_token_buffer(token_buffer_t* buffer)
+{
+    if(!buffer) return;
+    free(buffer->categories);
+    free(buffer->types);
+    free(buffer->atoms);
+    free(buffer->offsets);
+    free(buffer->lengths);
+    free(buffer);
+}
+
+// first token to rescan for an edit at `offset`. Scanning a token reads at
+// most one byte past its end ("1." is only a float if a digit follows), so
+// the last token ending before the edit is rescanned as well, and everything
+// before it is untouched.
+static size_t relex_restart(const token_buffer_t* buffer, const uint32_t offset)
+{
+    size_t low = 0;
+    size_t high = buffer->count;
+    while(low < high){
+        const size_t mid = low + (high - low) / 2;
+        if(buffer->offsets[mid] < offset) low = mid + 1;
+        else high = mid;
+    }
+    if(low == 0) return 0;
+
+    size_t last = low - 1;
+    if(last > 0 && buffer->offsets[last] + buffer->lengths[last] >= offset) last--;
+    return last;
+}
+
+// takes back the reports added since `mark`
+static void drop_reports(report_table_t* reports, const arena_mark_t mark, const size_t count)
+{
+    arena_rewind(reports->arena, mark);
+    reports->count = count;
+}
+
+bool relex_token_buffer(token_buffer_t* buffer, lexer_t* lexer, const uint32_t offset,
+                        const uint32_t removed, const uint32_t inserted, token_span_t* span)
+{
+    if(!buffer || !lexer || buffer->count == 0) return false;
+
+    source_t* src = lexer->ctx->src_manager.current;
+    if(!src || !src->content || !src->content->data) return false;
+    if((size_t)offset + inserted > src->content->length) return false;
+
+    // the content may have moved, and line starts past the edit moved with the text
+    lexer->start = src->content->data;
+    lexer->end = lexer->start + src->content->length;
+    if(!src_update_lines(src, lexer->ctx->memory.perm_arena, offset, removed, inserted)) return false;
+
+    const size_t first = relex_restart(buffer, offset);
+    const uint32_t rescan = first == 0 ? 0 : buffer->offsets[first];
+    lexer->cursor = lexer->start + rescan;
+    lexer->loc = new_location();
+
+    // paren balance as the lexer left it before the first rescanned token,
+    // replayed from the last relex when this edit comes after it
+    size_t from = 0;
+    lexer->balance = 0;
+    if(buffer->balance_index <= first){
+        from = buffer->balance_index;
+        lexer->balance = buffer->balance;
+    }
+    for(size_t i = from; i < first; i++){
+        if(buffer->categories[i] != CAT_PAREN) continue;
+        switch(buffer->types[i]){
+            case PAR_LPAREN: case PAR_LBRACE: case PAR_LBRACKET:
+                lexer->balance++;
+                break;
+            default:
+                if(lexer->balance > 0) lexer->balance--;
+                break;
+        }
+    }
+
+    buffer->balance_index = first;
+    buffer->balance = lexer->balance;
+
+    // old tokens past the edit sit `delta` bytes off their new position
+    const uint32_t edit_end = offset + removed;
+    const int64_t delta = (int64_t)inserted - (int64_t)removed;
+
+    token_t* scanned = NULL;
+    size_t scanned_count = 0;
+    size_t scanned_capacity = 0;
+    size_t old = first;
+
+    report_table_t* reports = lexer->ctx->reports;
+    const arena_mark_t start_mark = arena_mark(reports->arena);
+    const size_t fresh_reports = reports->count;
+
+    // scan until a new token lands on an identical old one past the edit, the
+    // lexer carries no state between tokens, so everything after it matches
+    while(true){
+        // the matching token is already reported, its reports are taken back
+        const arena_mark_t reports_mark = arena_mark(reports->arena);
+        const size_t reports_count = reports->count;
+        const token_t token = next_token(lexer);
+
+        while(old < buffer->count && (buffer->offsets[old] < edit_end ||
+              (int64_t)buffer->offsets[old] + delta < (int64_t)token.offset)){
+            old++;
+        }
+        if(old < buffer->count && (int64_t)buffer->offsets[old] + delta == (int64_t)token.offset){
+            const token_t stored = buffer_token(buffer, old);
+            if(stored.category == token.category && stored.type == token.type &&
+               stored.length == token.length && stored.atom == token.atom){
+                drop_reports(reports, reports_mark, reports_count);
+                break;
+            }
+        }
+
+        if(scanned_count == scanned_capacity){
+            scanned_capacity = scanned_capacity ? scanned_capacity * 2 : 64;
+            token_t* grown = realloc(scanned, scanned_capacity * sizeof(token_t));
+            if(!grown){
+                drop_reports(reports, start_mark, fresh_reports);
+                free(scanned);
+                return false;
+            }
+            scanned = grown;
+        }
+        scanned[scanned_count++] = token;
+
+        // the old EOF always matches, this only stops on a broken buffer
+        if(token.category == CAT_SERVICE && token.type == SERV_EOF){
+            drop_reports(reports, start_mark, fresh_reports);
+            free(scanned);
+            return false;
+        }
+    }
+
+    // replace old tokens [first, old) with the scanned ones and shift the rest
+    const size_t tail = buffer->count - old;
+    const size_t count = first + scanned_count + tail;
+    if(count > buffer->capacity){
+        const size_t capacity = count > buffer->capacity * 2 ? count : buffer->capacity * 2;
+        if(!grow_token_buffer(buffer, capacity)){
+            drop_reports(reports, start_mark, fresh_reports);
+            free(scanned);
+            return false;
+        }
+    }
+
+    // reports about the old text of the rescanned tokens make way for the new ones
+    if(!replace_reports(reports, src, fresh_reports, rescan, buffer->offsets[old], delta)){
+        free(scanned);
+        return false;
+    }
 
+    // most keystrokes replace as many tokens as they remove
+    if(first + scanned_count != old){
+#define MOVE_TAIL(field)                                                        \
+        memmove(buffer->field + first + scanned_count, buffer->field + old, tail * sizeof(*buffer->field))
+
+        MOVE_TAIL(categories);
+        MOVE_TAIL(types);
+        MOVE_TAIL(atoms);
+        MOVE_TAIL(offsets);
+        MOVE_TAIL(lengths);
+#undef MOVE_TAIL
+    }
+
+    for(size_t i = 0; i < scanned_count; i++) store_token(buffer, first + i, scanned[i]);
+    // unsigned wraparound adds a negative delta too, and keeps the loop vectorizable
+    if(delta != 0){
+        const uint32_t shift = (uint32_t)delta;
+        for(size_t i = first + scanned_count; i < count; i++) buffer->offsets[i] += shift;
+    }
+    buffer->count = count;
+    free(scanned);
+
+    if(span){
+        span->first = first;
+        span->removed = old - first;
+        span->inserted = scanned_count;
+    }
+    return true;
+}
+
+// one slice of the content for new_token_buffer_parallel. The worker lexes
+// it with a private context, so interning and reports need no locks, and
+// its atoms, constant ids and reports are remapped into the real context
+// when the chunks are joined.
+typedef struct {
+    compiler_context_t local;   // own string pool, literal table and reports, the source is shared
+    token_buffer_t tokens;      // speculative tokens, lexed as if the chunk began at top level
+    token_buffer_t fixed;       // tokens relexed on the calling thread when that guess was wrong
+    size_t resync;              // first speculative token kept after `fixed`
+    uint32_t begin;             // [begin, end) of the content, both at line starts
+    uint32_t end;
+    uint32_t stop;              // offset of the first token past the chunk, UINT32_MAX once EOF was stored
+    bool ok;
+} lex_chunk_t;
+
+// Appends tokens until one starts at or past `limit`, which is left out and
+// its offset stored in `stop`, or EOF, which is kept. With `match` scanning
+// also stops on the first token starting where a token of `match` does, its
+// index goes to `matched`.
+static bool scan_tokens(token_buffer_t* tokens, lexer_t* lexer, const uint32_t limit,
+                        const token_buffer_t* match, size_t* matched, uint32_t* stop)
+{
+    size_t j = 0;
+    while(true){
+        const token_t token = next_token(lexer);
+
+        if(match){
+            while(j < match->count && match->offsets[j] < token.offset) j++;
+            if(j < match->count && match->offsets[j] == token.offset){
+                *matched = j;
+                return true;
+            }
+        }
+
+        const bool eof = token.category == CAT_SERVICE && token.type == SERV_EOF;
+        if(!eof && token.offset >= limit){
+            *stop = token.offset;
+            return true;
+        }
+
+        if(tokens->count == tokens->capacity){
+            const size_t capacity = tokens->capacity ? tokens->capacity * 2 : 64;
+            if(!grow_token_buffer(tokens, capacity)) return false;
+        }
+        store_token(tokens, tokens->count++, token);
+
+        if(eof){
+            *stop = UINT32_MAX;
+            return true;
+        }
+    }
+}
+
+static lexer_t chunk_lexer(lex_chunk_t* chunk, const uint32_t from)
+{
+    const source_t* src = chunk->local.src_manager.current;
+    return (lexer_t){
+        .start = src->content->data,
+        .cursor = src->content->data + from,
+        .end = src->content->data + src->content->length,
+        .loc = new_location(),
+        .balance = 0,
+        .ctx = &chunk->local,
+    };
+}
+
+// the last chunk runs to EOF, the others stop at their end
+static uint32_t chunk_limit(const lex_chunk_t* chunk)
+{
+    return chunk->end >= chunk->local.src_manager.current->content->length ? UINT32_MAX : chunk->end;
+}
+
+static void lex_chunk(lex_chunk_t* chunk)
+{
+    lexer_t lexer = chunk_lexer(chunk, chunk->begin);
+    const size_t estimate = (chunk->end - chunk->begin) / 4 + 16;
+    chunk->ok = grow_token_buffer(&chunk->tokens, estimate) &&
+                scan_tokens(&chunk->tokens, &lexer, chunk_limit(chunk), NULL, NULL, &chunk->stop);
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI lex_chunk_thread(LPVOID arg)
+{
+    lex_chunk(arg);
+    free_scratch_arenas(); // escaped strings made this thread's scratch arenas
+    return 0;
+}
+#else
+static void* lex_chunk_thread(void* arg)
+{
+    lex_chunk(arg);
+    free_scratch_arenas(); // escaped strings made this thread's scratch arenas
+    return NULL;
+}
+#endif
+
+// Fixes up a chunk whose first real token is at `resume`. If a speculative
+// token starts there the guess was right. Otherwise the chunk began inside a
+// string or comment, and it is relexed from `resume` until a token lands on a
+// speculative one again or the chunk ends.
+static bool resync_chunk(lex_chunk_t* chunk, const uint32_t resume)
+{
+    if(resume == chunk->begin){
+        chunk->resync = 0;
+        return true;
+    }
+
+    size_t low = 0;
+    size_t high = chunk->tokens.count;
+    while(low < high){
+        const size_t mid = low + (high - low) / 2;
+        if(chunk->tokens.offsets[mid] < resume) low = mid + 1;
+        else high = mid;
+    }
+    if(low < chunk->tokens.count && chunk->tokens.offsets[low] == resume){
+        chunk->resync = low;
+        return true;
+    }
+
+    lexer_t lexer = chunk_lexer(chunk, resume);
+    size_t matched = chunk->tokens.count;
+    uint32_t stop = chunk->stop;
+    if(!scan_tokens(&chunk->fixed, &lexer, chunk_limit(chunk), &chunk->tokens, &matched, &stop)) return false;
+
+    chunk->resync = matched;
+    chunk->stop = stop;
+    return true;
+}
+
+// joins the chunks in order, interning their atoms and constants in the real
+// context on first use, so ids come out as a sequential lex assigns them
+typedef struct {
+    compiler_context_t* ctx;
+    token_buffer_t* buffer;
+    size_t balance;
+    report_t* reports;          // kept reports of the current chunk, in the order they were added
+    size_t report_count;
+    size_t report_next;
+    atom_t* atoms;              // chunk atom -> context atom, ATOM_NONE until first use
+    const_id_t* constants;      // chunk constant -> context constant
+} lex_join_t;
+
+static void flush_reports(lex_join_t* join, const uint64_t before)
+{
+    source_t* src = join->ctx->src_manager.current;
+    while(join->report_next < join->report_count && join->reports[join->report_next].loc.offset < before){
+        const report_t* report = &join->reports[join->report_next++];
+        add_report(join->ctx->reports, src, report->severity, report->code, report->loc);
+    }
+}
+
+// appends tokens [first, count) of `from`, only literals need their ids
+// remapped and only parens and EOF their balance checked
+static void join_tokens(lex_join_t* join, lex_chunk_t* chunk, const token_buffer_t* from, const size_t first)
+{
+    token_buffer_t* buffer = join->buffer;
+    const size_t at = buffer->count;
+    const size_t count = from->count - first;
+    if(count == 0) return;
+
+    memcpy(buffer->categories + at, from->categories + first, count * sizeof(*buffer->categories));
+    memcpy(buffer->types + at, from->types + first, count * sizeof(*buffer->types));
+    memcpy(buffer->atoms + at, from->atoms + first, count * sizeof(*buffer->atoms));
+    memcpy(buffer->offsets + at, from->offsets + first, count * sizeof(*buffer->offsets));
+    memcpy(buffer->lengths + at, from->lengths + first, count * sizeof(*buffer->lengths));
+    buffer->count += count;
+
+    source_t* src = join->ctx->src_manager.current;
+    for(size_t i = at; i < at + count; i++){
+        const uint8_t category = buffer->categories[i];
+
+        if(category == CAT_LITERAL){
+            const token_t token = buffer_token(buffer, i);
+            if(is_number_literal(token)){
+                const const_id_t id = token.constant;
+                if(!join->constants[id]){
+                    join->constants[id] = add_constant(&join->ctx->literals, get_constant(&chunk->local.literals, id));
+                }
+                buffer->atoms[i] = join->constants[id];
+            }
+            else if(token.atom != ATOM_NONE){
+                const atom_t atom = token.atom;
+                if(!join->atoms[atom]){
+                    const string_t str = sp_atom_str(&chunk->local.memory.perm_strings, atom);
+                    join->atoms[atom] = new_string_n(&join->ctx->memory.perm_strings, str.data, str.length).atom;
+                }
+                buffer->atoms[i] = join->atoms[atom];
+            }
+        }
+        // chunks can't know the paren balance at their start, it is replayed here
+        else if(category == CAT_PAREN){
+            const uint16_t type = buffer->types[i];
+            if(type == PAR_LPAREN || type == PAR_LBRACE || type == PAR_LBRACKET){
+                join->balance++;
+            }
+            else if(join->balance == 0){
+                flush_reports(join, buffer->offsets[i]);
+                add_report(join->ctx->reports, src, SEV_ERR, ERR_UNMAT_PAREN, (location_t){buffer->offsets[i], 0});
+            }
+            else {
+                join->balance--;
+            }
+        }
+        else if(category == CAT_SERVICE && buffer->types[i] == SERV_EOF){
+            flush_reports(join, UINT64_MAX);
+            if(join->balance != 0){
+                add_report(join->ctx->reports, src, SEV_ERR, ERR_UNMAT_PAREN, (location_t){buffer->offsets[i], 0});
+            }
+        }
+    }
+}
+
+static bool join_chunk(lex_join_t* join, lex_chunk_t* chunk, const size_t speculative_reports)
+{
+    // reports of the relexed tokens come first, then the speculative ones of
+    // the kept tokens, and none of tokens past the chunk
+    const uint64_t kept_from = chunk->resync < chunk->tokens.count ? chunk->tokens.offsets[chunk->resync] : UINT64_MAX;
+    const uint64_t kept_to = chunk->stop == UINT32_MAX ? UINT64_MAX : chunk->stop;
+
+    join->reports = malloc((chunk->local.reports->count + 1) * sizeof(report_t));
+    join->atoms = calloc(chunk->local.memory.perm_strings.count + 1, sizeof(atom_t));
+    join->constants = calloc(chunk->local.literals.count + 1, sizeof(const_id_t));
+    if(!join->reports || !join->atoms || !join->constants) return false;
+
+    join->report_count = 0;
+    join->report_next = 0;
+    for(int pass = 0; pass < 2; pass++){
+        report_iter_t it = report_iter(chunk->local.reports);
+        size_t index = 0;
+        for(const report_t* report = report_next(&it); report; report = report_next(&it), index++){
+            if(report->code == ERR_UNMAT_PAREN) continue;
+            const bool fixed = index >= speculative_reports;
+            if(pass == 0 ? !fixed : (fixed || report->loc.offset < kept_from)) continue;
+            if(report->loc.offset >= kept_to) continue;
+            join->reports[join->report_count++] = *report;
+        }
+    }
+
+    join_tokens(join, chunk, &chunk->fixed, 0);
+    join_tokens(join, chunk, &chunk->tokens, chunk->resync);
+    flush_reports(join, UINT64_MAX);
+
+    free(join->reports);
+    free(join->atoms);
+    free(join->constants);
+    join->reports = NULL;
+    join->atoms = NULL;
+    join->constants = NULL;
+    return true;
+}
+
+token_buffer_t* new_token_buffer_parallel(compiler_context_t* ctx, size_t threads)
+{
+    source_t* src = ctx ? ctx->src_manager.current : NULL;
+    if(!src || !src->content || !src->content->data) return NULL;
+
+    // chunks are cut from the whole input
+    while(src_refill(src));
+    if(src->stream) return NULL;
+
+    const size_t length = src->content->length;
+    if(length > UINT32_MAX - 1) return NULL;
+    if(threads > LEXER_MAX_THREADS) threads = LEXER_MAX_THREADS;
+    if(threads > length / LEXER_CHUNK_MIN) threads = length / LEXER_CHUNK_MIN;
+    if(threads <= 1) return new_token_buffer(new_lexer(ctx));
+
+    // workers only read the line index, build it before they start
+    if(!src_index_lines(src, ctx->memory.perm_arena)) return NULL;
+
+    lex_chunk_t* chunks = calloc(threads, sizeof(lex_chunk_t));
+    if(!chunks) return NULL;
+
+    // split after the newline nearest to each even cut
+    const char* content = src->content->data;
+    size_t count = 0;
+    uint32_t begin = 0;
+    for(size_t i = 1; i <= threads && begin < length; i++){
+        uint32_t end = (uint32_t)length;
+        if(i < threads){
+            const char* newline = memchr(content + length * i / threads, '\n', length - length * i / threads);
+            if(newline) end = (uint32_t)(newline - content + 1);
+        }
+        if(end <= begin) continue;
+
+        lex_chunk_t* chunk = &chunks[count++];
+        chunk->begin = begin;
+        chunk->end = end;
+        chunk->local.src_manager.current = src;
+        chunk->local.memory.perm_arena = new_arena(ARENA_DEF_SIZE);
+        chunk->local.memory.perm_strings = new_string_pool(SP_DEF_CAPACITY);
+        chunk->local.literals = new_literal_table();
+        chunk->local.reports = chunk->local.memory.perm_arena ? new_report_table(chunk->local.memory.perm_arena) : NULL;
+        chunk->local.options.dump_tokens = false; // chunks lex speculatively, the joined tokens are dumped instead
+        begin = end;
+    }
+
+    // the first chunk is lexed on this thread, the rest on workers
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE workers[LEXER_MAX_THREADS];
+#else
+    pthread_t workers[LEXER_MAX_THREADS];
+#endif
+    bool started[LEXER_MAX_THREADS] = {false};
+
+    bool ok = true;
+    for(size_t i = 0; i < count; i++) ok = ok && chunks[i].local.reports;
+
+    if(ok){
+        for(size_t i = 1; i < count; i++){
+#if defined(_WIN32) || defined(_WIN64)
+            workers[i] = CreateThread(NULL, 0, lex_chunk_thread, &chunks[i], 0, NULL);
+            started[i] = workers[i] != NULL;
+#else
+            started[i] = pthread_create(&workers[i], NULL, lex_chunk_thread, &chunks[i]) == 0;
+#endif
+        }
+        lex_chunk(&chunks[0]);
+    }
+    for(size_t i = 1; i < count; i++){
+        if(!started[i]){
+            if(ok) lex_chunk(&chunks[i]);
+            continue;
+        }
+#if defined(_WIN32) || defined(_WIN64)
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
+#else
+        pthread_join(workers[i], NULL);
+#endif
+    }
+    for(size_t i = 0; i < count; i++) ok = ok && chunks[i].ok;
+
+    // every chunk resumes at the first token its predecessor didn't keep
+    size_t speculative_reports[LEXER_MAX_THREADS] = {0};
+    size_t total = 0;
+    size_t used = 0;
+    uint32_t resume = 0;
+    for(size_t i = 0; ok && i < count && resume != UINT32_MAX; i++, used++){
+        speculative_reports[i] = chunks[i].local.reports->count;
+        ok = resync_chunk(&chunks[i], resume);
+        total += chunks[i].fixed.count + chunks[i].tokens.count - chunks[i].resync;
+        resume = chunks[i].stop;
+    }
+
+    token_buffer_t* buffer = ok ? calloc(1, sizeof(token_buffer_t)) : NULL;
+    if(buffer && !grow_token_buffer(buffer, total)){
+        free_token_buffer(buffer);
+        buffer = NULL;
+    }
+
+    lex_join_t join = {.ctx = ctx, .buffer = buffer};
+    for(size_t i = 0; buffer && i < used; i++){
+        if(!join_chunk(&join, &chunks[i], speculative_reports[i])){
+            free(join.reports);
+            free(join.atoms);
+            free(join.constants);
+            free_token_buffer(buffer);
+            buffer = NULL;
+        }
+    }
+
+    for(size_t i = 0; i < count; i++){
+        lex_chunk_t* chunk = &chunks[i];
+        free(chunk->tokens.categories);
+        free(chunk->tokens.types);
+        free(chunk->tokens.atoms);
+        free(chunk->tokens.offsets);
+        free(chunk->tokens.lengths);
+        free(chunk->fixed.categories);
+        free(chunk->fixed.types);
+        free(chunk->fixed.atoms);
+        free(chunk->fixed.offsets);
+        free(chunk->fixed.lengths);
+        free_string_pool(&chunk->local.memory.perm_strings);
+        free_literal_table(&chunk->local.literals);
+        if(chunk->local.reports) free_report_table(chunk->local.reports);
+        if(chunk->local.memory.perm_arena) free_arena(chunk->local.memory.perm_arena);
+    }
+    free(chunks);
+
+#ifdef DEBUG
+    for(size_t i = 0; buffer && ctx->options.dump_tokens && i < buffer->count; i++){
+        print_token(buffer_token(buffer, i), content);
+    }
+#endif
+
+    return buffer;
+}
+
+static token_t scan_token(lexer_t* lexer)
+{
     while(true){
         skip_whitespace(lexer);
-        if(lexer->ch == '#'){
+        if(*lexer->cursor == '#'){
             handle_comment(lexer);
             continue;
         }
         break;
     }
 
-    const char ch_str[2] = {lexer->ch, '\0'};
+    const char* begin = lexer->cursor;
+    lexer->loc = loc_at(lexer, begin, 0);
+
     token_t token = {0};
 
-    switch(lexer->ch){
+    switch(*begin){
         case '+': case '-':
         case '*': case '/':
         case '=': case '!':
@@ -125,125 +844,260 @@ token_t next_token(lexer_t* lexer)
 
         case '"': case '\'':
             token = handle_string(lexer);
-            read_ch(lexer);
             break;
 
         case '\0':
+            // a NUL inside the content is just an illegal byte
+            if(begin < lexer->end){
+                token = handle_illegal(lexer);
+                break;
+            }
             if(lexer->balance != 0){
                 add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_UNMAT_PAREN, lexer->loc);
             }
-            token = new_token(CAT_SERVICE, SERV_EOF, "EOF");
+            token = new_token(CAT_SERVICE, SERV_EOF);
             break;
 
         default:
-            if(isalpha(lexer->ch) || lexer->ch == '_'){
+            if(is_class(*begin, CH_ALPHA)){
                 token = handle_ident(lexer);
             }
-            else if(isdigit(lexer->ch)){
+            else if(is_class(*begin, CH_DIGIT)){
                 token = handle_number(lexer);
             }
             else {
-                while(lexer->ch != '\0' && !isalnum(lexer->ch) && !isspace(lexer->ch)){
-                    read_ch(lexer);
-                    lexer->loc.length++;
-                }
-                token = new_token(CAT_SERVICE, SERV_ILLEGAL, ch_str);
-
-                add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_ILLEG_CHAR, loc_copy(lexer->loc, -lexer->loc.length));
-
-                read_ch(lexer);
+                token = handle_illegal(lexer);
             }
             break;
     }
+
+    token.offset = (uint32_t)(begin - lexer->start);
+    token.length = (uint32_t)(lexer->cursor - begin);
+
+    lexer->loc = (location_t){token.offset, token.length};
     return token;
 }
 
-token_t handle_operator(lexer_t* lexer)
+// reads the next chunk of a streamed source, the content doesn't move
+static void refill_lexer(lexer_t* lexer)
 {
-    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL, "NULL_LEXER");
+    source_t* src = lexer->ctx->src_manager.current;
+    src_refill(src);
 
-    const char current = lexer->ch;
-    const char next = peek_ch(lexer);
+    lexer->start = src->content->data;
+    lexer->end = lexer->start + src->content->length;
 
-    if(next != '\0'){
-        const char potential_op[3] = {current, next, '\0'};
-        const token_t* op = find_token(potential_op);
-        if(op){
-            read_ch(lexer);
-            read_ch(lexer);
-            return new_token(CAT_OPERATOR, op->type, op->literal);
-        }
+    if(!src->stream){
+        lexer->streaming = false;
+        src_index_lines(src, lexer->ctx->memory.perm_arena);
     }
-    read_ch(lexer);
+}
+
+// A token of a streamed source is final only if the bytes its scan may look
+// at are real input and not the padding after what was read so far.
+// Otherwise the token and its reports are taken back, the next chunk is
+// read and the token is scanned again.
+static token_t scan_streamed_token(lexer_t* lexer)
+{
+    report_table_t* reports = lexer->ctx->reports;
+    const size_t offset = (size_t)(lexer->cursor - lexer->start);
+    const size_t balance = lexer->balance;
+
+    while(true){
+        const arena_mark_t mark = arena_mark(reports->arena);
+        const size_t count = reports->count;
+
+        const token_t token = scan_token(lexer);
+        if(!lexer->streaming || lexer->end - lexer->cursor >= LEXER_LOOKAHEAD) return token;
+
+        arena_rewind(reports->arena, mark);
+        reports->count = count;
+        lexer->balance = balance;
+
+        // the input ahead of the token at least doubles, so a long token is rescanned only a few times
+        const size_t ahead = (size_t)(lexer->end - lexer->start) - offset;
+        do refill_lexer(lexer);
+        while(lexer->streaming && (size_t)(lexer->end - lexer->start) - offset < 2 * ahead);
+
+        lexer->cursor = lexer->start + offset;
+    }
+}
+
+token_t next_token(lexer_t* lexer)
+{
+    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL);
+
+    const token_t token = lexer->streaming ? scan_streamed_token(lexer) : scan_token(lexer);
+
+#ifdef DEBUG
+    if(lexer->ctx->options.dump_tokens) print_token(token, lexer->start);
+#endif
+    return token;
+}
+
+token_t handle_illegal(lexer_t* lexer)
+{
+    const char* begin = lexer->cursor;
+    const char* p = begin + 1;
+    while(*p != '\0' && !is_class(*p, CH_ALPHA | CH_DIGIT | CH_SPACE)) p++;
+    lexer->cursor = p;
+
+    add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_ILLEG_CHAR, loc_at(lexer, begin, (size_t)(p - begin)));
+
+    return new_token(CAT_SERVICE, SERV_ILLEGAL);
+}
+
+token_t handle_operator(lexer_t* lexer)
+{
+    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL);
+
+    // the current byte is an operator, so the next one is at most the terminator
+    const char current = lexer->cursor[0];
+    const char next = lexer->cursor[1];
 
     int op_type;
-    char op_char[2] = {current, '\0'};
     switch(current){
-        case '+': op_type = OPER_PLUS;      break;
-        case '-': op_type = OPER_MINUS;     break;
-        case '*': op_type = OPER_ASTERISK;  break;
-        case '/': op_type = OPER_SLASH;     break;
-        case '%': op_type = OPER_PERCENT;   break;
-        case '=': op_type = OPER_ASSIGN;    break;
-        case '!': op_type = OPER_NOT;       break;
-        case '<': op_type = OPER_LANGLE;    break;
-        case '>': op_type = OPER_RANGLE;    break;
-        case '.': op_type = OPER_DOT;       break;
+        case '+': op_type = next == '+' ? OPER_INCREM : next == '=' ? OPER_ADD : OPER_PLUS;  break;
+        case '-': op_type = next == '-' ? OPER_DECREM : next == '=' ? OPER_SUB : OPER_MINUS; break;
+        case '*': op_type = next == '=' ? OPER_MUL   : OPER_ASTERISK; break;
+        case '/': op_type = next == '=' ? OPER_DIV   : OPER_SLASH;    break;
+        case '%': op_type = next == '=' ? OPER_MOD   : OPER_PERCENT;  break;
+        case '=': op_type = next == '=' ? OPER_EQ    : OPER_ASSIGN;   break;
+        case '!': op_type = next == '=' ? OPER_NEQ   : OPER_NOT;      break;
+        case '<': op_type = next == '=' ? OPER_LTE   : OPER_LANGLE;   break;
+        case '>': op_type = next == '=' ? OPER_GTE   : OPER_RANGLE;   break;
+        case '.': op_type = next == '.' ? OPER_RANGE : OPER_DOT;      break;
+        case '&': op_type = next == '&' ? OPER_AND   : -1;            break;
+        case '|': op_type = next == '|' ? OPER_OR    : -1;            break;
         case ',': op_type = OPER_COMMA;     break;
         case ':': op_type = OPER_COLON;     break;
         case ';': op_type = OPER_SEMICOLON; break;
         case '?': op_type = OPER_QUESTION;  break;
-        default: {
-            string_t stored = new_string(&lexer->ctx->memory.temp_strings, op_char);
-            return new_token(CAT_SERVICE, SERV_ILLEGAL, stored.data ? stored.data : op_char);
-        }
+        default:  op_type = -1;             break;
     }
-    string_t stored = new_string(&lexer->ctx->memory.temp_strings, op_char);
-    return new_token(CAT_OPERATOR, op_type, stored.data ? stored.data : op_char);
+
+    if(op_type < 0){
+        lexer->cursor++;
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    }
+
+    // step over the spelling, one or two bytes
+    const token_t token = new_token(CAT_OPERATOR, op_type);
+    lexer->cursor += token_literal(token)[1] != '\0' ? 2 : 1;
+    return token;
 }
 
 token_t handle_ident(lexer_t* lexer)
 {
-    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL, "NULL_LEXER");
+    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL);
 
-    string_t ident = read_ident(lexer);
-    if(!ident.data){
-        while(isalnum(lexer->ch) || lexer->ch == '_') read_ch(lexer);
-        return new_token(CAT_SERVICE, SERV_ILLEGAL, "INVALID_IDENT");
+    const char* begin = lexer->cursor;
+    const char* p = begin;
+    while(is_class(*p, CH_ALPHA | CH_DIGIT)) p++;
+    lexer->cursor = p;
+
+    const size_t length = (size_t)(p - begin);
+    if(length > MAX_IDENT_SIZE){
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_IDENT, loc_at(lexer, begin, length));
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
     }
 
-    const token_t* kw = find_token(ident.data);
+    // keywords are matched on the source slice and never interned
+    const token_t* kw = find_keyword(begin, length);
+    if(kw) return *kw;
+
+    string_t ident = new_string_n(&lexer->ctx->memory.perm_strings, begin, length);
+    if(!ident.data) return new_token(CAT_SERVICE, SERV_ILLEGAL);
 
-    if(kw) return new_token(kw->category, kw->type, kw->literal);
-    else   return new_token(CAT_LITERAL, LIT_IDENT, ident.data);
+    token_t token = new_token(CAT_LITERAL, LIT_IDENT);
+    token.atom = ident.atom;
+    return token;
 }
 
 token_t handle_number(lexer_t* lexer)
 {
     enum category_literal lit = LIT_NUMBER;
 
-    if(lexer->ch == '0'){
-        switch(peek_ch(lexer)){
-            case 'x': lit = LIT_HEX; break;
-            case 'b': lit = LIT_BIN; break;
-            case 'o': lit = LIT_OCT; break;
+    const char* begin = lexer->cursor;
+    const char* p = begin;
+
+    if(p[0] == '0'){
+        switch(p[1]){
+            case 'x': lit = LIT_HEX; p += 2; break;
+            case 'b': lit = LIT_BIN; p += 2; break;
+            case 'o': lit = LIT_OCT; p += 2; break;
         }
     }
 
-    string_t num_str = read_number(lexer, &lit);
-    if(!num_str.data) return new_token(CAT_SERVICE, SERV_ILLEGAL, "BAD_NUMBER");
+    while(true){
+        const char ch = *p;
 
-    return new_token(CAT_LITERAL, lit, num_str.data);
+        bool accept = false;
+        switch(lit){
+            case LIT_HEX: accept = is_class(ch, CH_HEX); break;
+            case LIT_BIN: accept = ch == '0' || ch == '1'; break;
+            case LIT_OCT: accept = ch >= '0' && ch <= '7'; break;
+            default:
+                // a dot only continues the number when a digit follows, "0..9" is a range
+                accept = is_class(ch, CH_DIGIT) || (ch == '.' && lit == LIT_NUMBER && is_class(p[1], CH_DIGIT));
+                if(ch == '.' && accept) lit = LIT_FLOAT;
+                break;
+        }
+        if(!accept) break;
+        p++;
+    }
+
+    // digits outside the base, letters glued to a prefixed literal, or no digits at all
+    if(lit == LIT_HEX || lit == LIT_BIN || lit == LIT_OCT){
+        if(is_class(*p, CH_ALPHA | CH_DIGIT) || p == begin + 2){
+            while(is_class(*p, CH_ALPHA | CH_DIGIT)) p++;
+            lexer->cursor = p;
+            add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_LIT, loc_at(lexer, begin, (size_t)(p - begin)));
+            return new_token(CAT_SERVICE, SERV_ILLEGAL);
+        }
+    }
+    lexer->cursor = p;
+
+    const size_t length = (size_t)(p - begin);
+    if(length > MAX_NUM_SIZE){
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_NUM, loc_at(lexer, begin, length));
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    }
+
+    // the value is decoded once here, later phases read it from the literal table
+    constant_t constant = {.kind = CONST_INT};
+    bool in_range = true;
+    switch(lit){
+        case LIT_HEX: in_range = decode_integer(begin + 2, length - 2, 16, &constant.integer); break;
+        case LIT_BIN: in_range = decode_integer(begin + 2, length - 2, 2, &constant.integer); break;
+        case LIT_OCT: in_range = decode_integer(begin + 2, length - 2, 8, &constant.integer); break;
+        case LIT_FLOAT:
+            constant.kind = CONST_FLOAT;
+            in_range = decode_float(begin, length, &constant.real);
+            break;
+        default: in_range = decode_integer(begin, length, 10, &constant.integer); break;
+    }
+    if(!in_range){
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_NUM_RANGE, loc_at(lexer, begin, length));
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    }
+
+    token_t token = new_token(CAT_LITERAL, lit);
+    token.constant = add_constant(&lexer->ctx->literals, constant);
+    if(token.constant == CONST_NONE) return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    return token;
 }
 
 token_t handle_paren(lexer_t* lexer)
 {
-    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL, "NULL_LEXER");
+    if(!lexer) return new_token(CAT_SERVICE, SERV_ILLEGAL);
+
+    const char ch = *lexer->cursor;
 
-    if(lexer->ch == '(' || lexer->ch == '{' || lexer->ch == '['){
+    if(ch == '(' || ch == '{' || ch == '['){
         lexer->balance++;
     }
-    else if(lexer->ch == ')' || lexer->ch == '}' || lexer->ch == ']'){
+    else if(ch == ')' || ch == '}' || ch == ']'){
         if(lexer->balance == 0){
             add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_UNMAT_PAREN, lexer->loc);
         }
@@ -253,7 +1107,7 @@ token_t handle_paren(lexer_t* lexer)
     }
 
     enum category_paren type = 0;
-    switch(lexer->ch){
+    switch(ch){
         case '(': type = PAR_LPAREN; break;
         case ')': type = PAR_RPAREN; break;
         case '{': type = PAR_LBRACE; break;
@@ -261,34 +1115,56 @@ token_t handle_paren(lexer_t* lexer)
         case '[': type = PAR_LBRACKET; break;
         case ']': type = PAR_RBRACKET; break;
     }
-    char paren_str[2] = {lexer->ch, '\0'};
-    string_t stored = new_string(&lexer->ctx->memory.temp_strings, paren_str);
-    const token_t token = new_token(CAT_PAREN, type, stored.data ? stored.data : paren_str);
-    read_ch(lexer);
+    const token_t token = new_token(CAT_PAREN, type);
+    lexer->cursor++;
     return token;
 }
 
 token_t handle_string(lexer_t* lexer)
 {
-    char quote_char = lexer->ch;
+    const char quote_char = *lexer->cursor;
     enum category_delimiter opening_delim_type = (quote_char == '"') ? DELIM_DQUOTE : DELIM_SQUOTE;
-    read_ch(lexer);
 
-    string_t str = read_string(lexer, quote_char);
-    if(!str.data){
-        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_STR, lexer->loc);
-        return new_token(CAT_SERVICE, SERV_ILLEGAL, "INVALID_STRING");
+    // strings can span lines, report them at the opening quote
+    location_t loc = lexer->loc;
+
+    const char* begin = lexer->cursor + 1;
+    const char* p = begin;
+    while(true){
+        p = find_special(p, lexer->end, quote_char, '\\');
+        if(*p == quote_char || *p == '\0') break;
+
+        if(p[1] != '\0') p++;
+        p++;
     }
-    if(lexer->ch != quote_char){
-        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_UNCLO_STR, lexer->loc);
-        return new_token(CAT_SERVICE, SERV_ILLEGAL, "UNCLOSED_STRING");
+
+    if(*p != quote_char){
+        lexer->cursor = p;
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_UNCLO_STR, loc);
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    }
+    lexer->cursor = p + 1;
+
+    const size_t length = (size_t)(p - begin);
+    loc.length = (uint32_t)(length + 2);
+
+    if(length > MAX_STR_SIZE){
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_STR, loc);
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    }
+
+    string_t str = read_string(lexer, begin, length);
+    if(!str.data){
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_STR, loc);
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
     }
     if(opening_delim_type == DELIM_SQUOTE && str.length > 1){
-        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_STR, loc_copy(lexer->loc, -lexer->loc.length));
-        return new_token(CAT_SERVICE, SERV_ILLEGAL, "INVALID_STRING");
+        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_STR, loc);
+        return new_token(CAT_SERVICE, SERV_ILLEGAL);
     }
 
-    token_t string_token = new_token(CAT_LITERAL, LIT_STRING, str.data);
+    token_t string_token = new_token(CAT_LITERAL, LIT_STRING);
+    string_token.atom = str.atom;
 
     return string_token;
 }
@@ -297,144 +1173,62 @@ void handle_comment(lexer_t* lexer)
 {
     if(!lexer) return;
 
-    switch(peek_ch(lexer)){
-        case '#': read_ch(lexer); read_ch(lexer); while(lexer->ch != '\n' && lexer->ch != '\0') read_ch(lexer); break;
-        case '[': while(lexer->ch != ']' && peek_ch(lexer) != '#') read_ch(lexer); break;
-        default:  while(lexer->ch != '\n') read_ch(lexer);
-    }
-}
-
-string_t read_ident(lexer_t* lexer)
-{
-    char stack_buffer[IDENT_SIZE];
-    char* buffer = stack_buffer;
-    size_t capacity = IDENT_SIZE;
-    size_t length = 0;
-
-    if(isdigit(lexer->ch)){
-        add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_IDENT, lexer->loc);
-        return (string_t){0};
-    }
-
-    while(isalnum(lexer->ch) || lexer->ch == '_'){
-        if(length >= MAX_IDENT_SIZE){
-            if(buffer != stack_buffer) free(buffer);
-            add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_IDENT, lexer->loc);
-            return (string_t){0};
-        }
-
-        if(length >= capacity - 1){
-            capacity *= 2;
-            char* new_buf = realloc(buffer == stack_buffer ? NULL : buffer, capacity * sizeof(char));
-            if(!new_buf){
-                if(buffer != stack_buffer) free(buffer);
-                return (string_t){0};
-            }
-            if(buffer == stack_buffer) memcpy(new_buf, stack_buffer, length * sizeof(char));
-            buffer = new_buf;
+    const char* p = lexer->cursor + 1;
+    if(*p == '['){
+        // block comment, runs until "]#"
+        p++;
+        while(true){
+            p = find_special(p, lexer->end, ']', ']');
+            if(*p == '\0' || p[1] == '#') break;
+            p++;
         }
-
-        buffer[length++] = lexer->ch;
-        read_ch(lexer);
+        if(*p != '\0') p += 2;
     }
-
-    buffer[length] = '\0';
-
-    string_t stored = new_string(&lexer->ctx->memory.perm_strings, buffer);
-    if(!stored.data){
-        if(buffer != stack_buffer) free(buffer);
-        return (string_t){0};
+    else {
+        p = find_special(p, lexer->end, '\n', '\n');
     }
-
-    if(buffer != stack_buffer) free(buffer);
-
-    return stored;
+    lexer->cursor = p;
 }
 
-string_t read_number(lexer_t* lexer, enum category_literal *lit)
+// interns the contents of a string literal, escapes are decoded in a scratch buffer
+string_t read_string(lexer_t* lexer, const char* begin, size_t length)
 {
-    if(!isdigit(lexer->ch)) return (string_t){0};
-
-    char stack_buffer[NUM_SIZE];
-    char* buffer = stack_buffer;
-    size_t capacity = NUM_SIZE;
-    size_t length = 0;
-
-    while(true){
-        char ch = lexer->ch;
-        if(ch == '\0') break;
-
-        bool accept = false;
-        switch(*lit){
-            case LIT_HEX: if(isxdigit(ch)) accept = true; break;
-            case LIT_BIN: if(ch == '0' || ch == '1') accept = true; break;
-            case LIT_OCT: if(ch >= '0' && ch <= '7') accept = true; break;
-            default: break;
-        }
-        if(ch == '.' && *lit != LIT_FLOAT){
-            *lit = LIT_FLOAT;
-            accept = true;
-        }
-        else if(isdigit(ch)){
-            accept = true;
-        }
-
-        if(!accept) break;
+    const char* end = begin + length;
 
-        if(length >= MAX_NUM_SIZE){
-            if(buffer != stack_buffer) free(buffer);
-            add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_NUM, lexer->loc);
-            return (string_t){0};
-        }
+    const char* p = memchr(begin, '\\', length);
+    if(!p) return new_string_n(&lexer->ctx->memory.perm_strings, begin, length);
 
-        if(length >= capacity - 1){
-            capacity *= 2;
-            char* new_buf = realloc(buffer == stack_buffer ? NULL : buffer, capacity * sizeof(char));
-            if(!new_buf){
-                if(buffer != stack_buffer) free(buffer);
-                return (string_t){0};
-            }
-            if(buffer == stack_buffer) memcpy(new_buf, stack_buffer, length * sizeof(char));
-            buffer = new_buf;
-        }
-
-        buffer[length++] = ch;
-        read_ch(lexer);
+    arena_scratch_t scratch = arena_scratch_begin(NULL);
+    char* buffer = arena_alloc(scratch.arena, length + 1, alignof(char));
+    if(!buffer){
+        arena_scratch_end(scratch);
+        return (string_t){0};
     }
 
-    if(length > 0 && (*lit == LIT_HEX || *lit == LIT_BIN || *lit == LIT_OCT)){
-        if(isalpha(lexer->ch) || lexer->ch == '_'){
-            while(isalnum(lexer->ch) || lexer->ch == '_'){
-                read_ch(lexer);
-                length++;
-            }
-
-            add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_LIT, loc_copy(lexer->loc, -lexer->loc.length));
+    size_t decoded = (size_t)(p - begin);
+    memcpy(buffer, begin, decoded);
 
-            if(buffer != stack_buffer) free(buffer);
-            return (string_t){0};
+    while(p < end){
+        if(*p == '\\'){
+            p++;
+            buffer[decoded++] = read_escseq(lexer, &p);
+            continue;
         }
+        buffer[decoded++] = *p++;
     }
 
-    buffer[length] = '\0';
-
-    string_t stored = new_string(&lexer->ctx->memory.perm_strings, buffer);
-    if(!stored.data){
-        if(buffer != stack_buffer) free(buffer);
-        return (string_t){0};
-    }
-
-    if(buffer != stack_buffer) free(buffer);
+    string_t stored = new_string_n(&lexer->ctx->memory.perm_strings, buffer, decoded);
+    arena_scratch_end(scratch);
 
     return stored;
 }
 
-char read_escseq(lexer_t* lexer)
+char read_escseq(lexer_t* lexer, const char** p)
 {
     if(!lexer) return '\0';
 
     char esc_seq = '\0';
-    switch(lexer->ch){
+    switch(**p){
         case 'n': esc_seq = '\n'; break;
         case 't': esc_seq = '\t'; break;
         case 'r': esc_seq = '\r'; break;
@@ -446,63 +1240,6 @@ char read_escseq(lexer_t* lexer)
             add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_WARN, ERR_INVAL_ESCSEQ, lexer->loc);
             break;
     }
-    read_ch(lexer);
+    (*p)++;
     return esc_seq;
 }
-
-string_t read_string(lexer_t* lexer, char quote_char)
-{
-    char stack_buffer[STR_SIZE];
-    char* buffer = stack_buffer;
-    size_t capacity = STR_SIZE;
-    size_t length = 0;
-
-    while(lexer->ch != quote_char && lexer->ch != '\0'){
-        if(length >= MAX_STR_SIZE){
-            if(buffer != stack_buffer) free(buffer);
-            add_report(lexer->ctx->reports, lexer->ctx->src_manager.current, SEV_ERR, ERR_INVAL_STR, lexer->loc);
-            return (string_t){0};
-        }
-
-        if(lexer->ch == '\\'){
-            read_ch(lexer);
-            if(length >= capacity - 1){
-                capacity *= 2;
-                char* new_buf = realloc(buffer == stack_buffer ? NULL : buffer, capacity * sizeof(char));
-                if(!new_buf){
-                    if(buffer != stack_buffer) free(buffer);
-                    return (string_t){0};
-                }
-                if(buffer == stack_buffer) memcpy(new_buf, stack_buffer, length * sizeof(char));
-                buffer = new_buf;
-            }
-            buffer[length++] = read_escseq(lexer);
-            continue;
-        }
-
-        if(length >= capacity - 1){
-            capacity *= 2;
-            char* new_buf = realloc(buffer == stack_buffer ? NULL : buffer, capacity * sizeof(char));
-            if(!new_buf){
-                if(buffer != stack_buffer) free(buffer);
-                return (string_t){0};
-            }
-            if(buffer == stack_buffer) memcpy(new_buf, stack_buffer, length * sizeof(char));
-            buffer = new_buf;
-        }
-
-        buffer[length++] = lexer->ch;
-        read_ch(lexer);
-    }
-
-    buffer[length] = '\0';
-
-    string_t stored = new_string(&lexer->ctx->memory.perm_strings, buffer);
-    if(!stored.data){
-        if(buffer != stack_buffer) free(buffer);
-        return (string_t){0};
-    }
-
-    if(buffer != stack_buffer) free(buffer);
-    return stored;
-}
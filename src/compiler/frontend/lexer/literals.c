@@ -0,0 +1,187 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler/frontend/lexer/literals.h"
+
+#define MAX_FLOAT_TEXT 128  // longer literals are rejected by the lexer before they get here
+
+literal_table_t new_literal_table(void)
+{
+    literal_table_t table;
+    table.capacity = LT_DEF_CAPACITY;
+    table.elements = calloc(table.capacity, sizeof(constant_t));
+    table.count = 0;
+    table.index = NULL;
+    table.index_capacity = 0;
+    return table;
+}
+
+void free_literal_table(literal_table_t* table)
+{
+    if(!table) return;
+    if(table->elements) free(table->elements);
+    table->elements = NULL;
+    if(table->index) free(table->index);
+    table->index = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->index_capacity = 0;
+}
+
+// the union is compared and hashed by its bits, so 0 and 0.0 stay distinct constants
+static uint32_t hash_constant(const constant_t constant)
+{
+    const uint64_t bits = constant.integer ^ ((uint64_t)constant.kind << 63);
+    return (uint32_t)((bits * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static bool grow_index(literal_table_t* table)
+{
+    size_t new_capacity = table->index_capacity ? table->index_capacity * 2 : LT_INDEX_CAPACITY;
+    uint32_t* index = calloc(new_capacity, sizeof(uint32_t));
+    if(!index) return false;
+
+    const size_t mask = new_capacity - 1;
+    for(size_t i = 0; i < table->count; i++){
+        size_t slot = hash_constant(table->elements[i]) & mask;
+        while(index[slot]) slot = (slot + 1) & mask;
+        index[slot] = (uint32_t)(i + 1);
+    }
+
+    free(table->index);
+    table->index = index;
+    table->index_capacity = new_capacity;
+    return true;
+}
+
+const_id_t add_constant(literal_table_t* table, const constant_t constant)
+{
+    if(!table) return CONST_NONE;
+
+    if((table->count + 1) * 4 > table->index_capacity * 3){
+        if(!grow_index(table)) return CONST_NONE;
+    }
+
+    // check if the value already exists
+    const size_t mask = table->index_capacity - 1;
+    size_t slot = hash_constant(constant) & mask;
+    while(table->index[slot]){
+        const constant_t* stored = &table->elements[table->index[slot] - 1];
+        if(stored->kind == constant.kind && stored->integer == constant.integer) return table->index[slot];
+        slot = (slot + 1) & mask;
+    }
+
+    if(table->count >= table->capacity){
+        size_t new_capacity = table->capacity == 0 ? LT_DEF_CAPACITY : table->capacity * 2;
+        constant_t* new_elements = realloc(table->elements, sizeof(constant_t) * new_capacity);
+        if(!new_elements) return CONST_NONE;
+        table->elements = new_elements;
+        table->capacity = new_capacity;
+    }
+
+    table->elements[table->count] = constant;
+    table->index[slot] = (uint32_t)(table->count + 1);
+
+    return (const_id_t)++table->count;
+}
+
+constant_t get_constant(const literal_table_t* table, const const_id_t id)
+{
+    if(!table || id == CONST_NONE || id > table->count) return (constant_t){0};
+    return table->elements[id - 1];
+}
+
+bool decode_integer(const char* digits, const size_t length, const unsigned base, uint64_t* value)
+{
+    if(!digits || !value) return false;
+
+    uint64_t result = 0;
+    const char* p = digits;
+    const char* end = digits + length;
+
+    // this many digits of the base always fit, only the rest needs overflow checks
+    size_t safe = 0;
+    switch(base){
+        case 2:  safe = 64; break;
+        case 8:  safe = 21; break;
+        case 10: safe = 19; break;
+        case 16: safe = 16; break;
+        default: return false;
+    }
+
+    const char* checked = length > safe ? digits + safe : end;
+    for(; p < checked; p++){
+        const unsigned ch = (unsigned char)*p;
+        const unsigned digit = ch <= '9' ? ch - '0' : (ch | 0x20) - 'a' + 10;
+        result = result * base + digit;
+    }
+
+    const uint64_t limit = UINT64_MAX / base;
+    for(; p < end; p++){
+        const unsigned ch = (unsigned char)*p;
+        const unsigned digit = ch <= '9' ? ch - '0' : (ch | 0x20) - 'a' + 10;
+        if(result > limit || (result == limit && digit > UINT64_MAX - limit * base)) return false;
+        result = result * base + digit;
+    }
+
+    *value = result;
+    return true;
+}
+
+bool decode_float(const char* text, const size_t length, double* value)
+{
+    if(!text || !value) return false;
+
+    // powers of ten a double holds exactly
+    static const double exact_pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    // the digits without the dot as one integer, scaled down by the fraction length
+    uint64_t mantissa = 0;
+    size_t significant = 0;
+    size_t fraction = 0;
+    bool dot = false;
+    bool exact = true;
+
+    for(size_t i = 0; i < length; i++){
+        const char ch = text[i];
+        if(ch == '.'){
+            dot = true;
+            continue;
+        }
+        if(significant == 19){
+            exact = false;
+            break;
+        }
+        mantissa = mantissa * 10 + (uint64_t)(ch - '0');
+        if(mantissa) significant++;
+        if(dot) fraction++;
+    }
+
+    // both operands are exact, so the one division rounds correctly
+    if(exact && mantissa <= (1ull << 53) && fraction < sizeof(exact_pow10) / sizeof(exact_pow10[0])){
+        *value = (double)mantissa / exact_pow10[fraction];
+        return true;
+    }
+
+    // long mantissas and fractions go through the C library. The dot is dropped
+    // and the fraction written as an exponent, strtod reads the decimal point
+    // from the current locale but never the exponent
+    char buffer[MAX_FLOAT_TEXT + 8];
+    if(length > MAX_FLOAT_TEXT) return false;
+
+    size_t size = 0;
+    size_t scale = 0;
+    for(size_t i = 0; i < length; i++){
+        if(text[i] == '.') scale = length - i - 1;
+        else buffer[size++] = text[i];
+    }
+    snprintf(buffer + size, sizeof(buffer) - size, "e-%zu", scale);
+
+    *value = strtod(buffer, NULL);
+    return !isinf(*value);
+}
@@ -1,101 +1,197 @@
 #include <stddef.h>     // size_t
-#include <stdlib.h>     // malloc, free
-#include <stdio.h>      // printf
-#include <string.h>     // strlen
+#include <string.h>     // memcmp
 
-#include "core/ds/hashmap.h"    // hashmap_t
 #include "compiler/frontend/lexer/tokens.h" // token_t, CAT_OPERATOR, CAT_KEYWORD, ...
-#ifdef DEBUG
-#include "core/lang/debug.h"    // print_token
-#endif
 
-#define C_OP (CAT_OPERATOR)
 #define C_KW (CAT_KEYWORD)
 #define C_DT (CAT_DATATYPE)
 #define C_MD (CAT_MODIFIER)
 #define C_LT (CAT_LITERAL)
-#define C_PR (CAT_PAREN)
-#define C_DL (CAT_DELIMITER)
 
-hashmap_t* tokens_table = NULL;
-
-void init_tokens(void)
+// spelling of fixed tokens, indexed by their type
+static const char* const service_literals[] = {
+    [SERV_ILLEGAL] = "ILLEGAL", [SERV_COMMENT] = "COMMENT", [SERV_EOF] = "EOF",
+};
+
+static const char* const operator_literals[] = {
+    [OPER_PLUS]   = "+",  [OPER_MINUS]  = "-",  [OPER_ASTERISK]  = "*",
+    [OPER_SLASH]  = "/",  [OPER_PERCENT]= "%",
+    [OPER_ASSIGN] = "=",  [OPER_ADD]    = "+=", [OPER_SUB]       = "-=",
+    [OPER_MUL]    = "*=", [OPER_DIV]    = "/=", [OPER_MOD]       = "%=",
+    [OPER_EQ]     = "==", [OPER_NEQ]    = "!=", [OPER_LANGLE]    = "<",
+    [OPER_RANGLE] = ">",  [OPER_LTE]    = "<=", [OPER_GTE]       = ">=",
+    [OPER_AND]    = "&&", [OPER_OR]     = "||", [OPER_NOT]       = "!",
+    [OPER_INCREM] = "++", [OPER_DECREM] = "--",
+    [OPER_DOT]    = ".",  [OPER_COMMA]  = ",",  [OPER_COLON]     = ":",
+    [OPER_SEMICOLON] = ";", [OPER_QUESTION] = "?", [OPER_RANGE]  = "..",
+};
+
+static const char* const keyword_literals[] = {
+    [KW_IF]     = "if",     [KW_ELIF]   = "elif",   [KW_ELSE]     = "else",
+    [KW_FOR]    = "for",    [KW_DO]     = "do",     [KW_WHILE]    = "while",
+    [KW_FUNC]   = "func",   [KW_STRUCT] = "struct", [KW_ENUM]     = "enum",
+    [KW_MATCH]  = "match",  [KW_CASE]   = "case",   [KW_DEFAULT]  = "default",
+    [KW_RETURN] = "return", [KW_BREAK]  = "break",  [KW_CONTINUE] = "continue",
+    [KW_TRAIT]  = "trait",  [KW_IMPL]   = "impl",   [KW_SELF]     = "self",
+    [KW_IMPORT] = "import", [KW_MODULE] = "module", [KW_USE]      = "use",
+    [KW_TRY]    = "try",    [KW_CATCH]  = "catch",  [KW_THROW]    = "throw",
+    [KW_TYPE]   = "type",
+};
+
+static const char* const paren_literals[] = {
+    [PAR_LPAREN]   = "(", [PAR_RPAREN]   = ")",
+    [PAR_LBRACE]   = "{", [PAR_RBRACE]   = "}",
+    [PAR_LBRACKET] = "[", [PAR_RBRACKET] = "]",
+};
+
+static const char* const delimiter_literals[] = {
+    [DELIM_DQUOTE] = "\"", [DELIM_SQUOTE] = "'",
+};
+
+static const char* const datatype_literals[] = {
+    [DT_INT]   = "int",   [DT_UINT]    = "uint",
+    [DT_SHORT] = "short", [DT_USHORT]  = "ushort",
+    [DT_LONG]  = "long",  [DT_ULONG]   = "ulong",
+    [DT_CHAR]  = "char",  [DT_BYTE]    = "byte",
+    [DT_FLOAT] = "float", [DT_DECIMAL] = "decimal",
+    [DT_STR]   = "str",   [DT_BOOL]    = "bool",
+    [DT_VOID]  = "void",  [DT_ANY]     = "any",
+};
+
+static const char* const modifier_literals[] = {
+    [MOD_VAR] = "var", [MOD_CONST] = "const", [MOD_FINAL] = "final", [MOD_STATIC] = "static",
+};
+
+// only the literal words, identifiers and values are spelled by their atom
+static const char* const word_literals[] = {
+    [LIT_NULL] = "null", [LIT_TRUE] = "true", [LIT_FALSE] = "false", [LIT_INFINITY] = "infinity",
+};
+
+#define LOOKUP(table, type) \
+    ((size_t)(type) < sizeof(table) / sizeof(table[0]) ? table[type] : NULL)
+
+token_t new_token(const enum category_tag category, const int type)
 {
-    if(tokens_table != NULL) return;
-
-    static token_t tokens[] = {
-        /* operators */
-        {"++", OPER_INCREM, C_OP}, {"--", OPER_DECREM, C_OP},
-        {"==", OPER_EQ,     C_OP}, {"!=", OPER_NEQ,    C_OP},
-        {"+=", OPER_ADD,    C_OP}, {"-=", OPER_SUB,    C_OP},
-        {"*=", OPER_MUL,    C_OP}, {"/=", OPER_DIV,    C_OP},
-        {"%=", OPER_MOD,    C_OP}, {"&&", OPER_AND,    C_OP},
-        {"||", OPER_OR,     C_OP}, {"<=", OPER_LTE,    C_OP},
-        {">=", OPER_GTE,    C_OP}, {"..", OPER_RANGE,  C_OP},
-
-        /* сontrol structures */
-        {"if",      KW_IF,      C_KW}, {"else",     KW_ELSE,      C_KW},
-        {"elif",    KW_ELIF,    C_KW}, {"for",      KW_FOR,       C_KW},
-        {"do",      KW_DO,      C_KW}, {"while",    KW_WHILE,     C_KW},
-        {"func",    KW_FUNC,    C_KW}, {"return",   KW_RETURN,    C_KW},
-        {"break",   KW_BREAK,   C_KW}, {"continue", KW_CONTINUE,  C_KW},
-        {"default", KW_DEFAULT, C_KW},
-        {"match",   KW_MATCH,   C_KW}, {"case",     KW_CASE,      C_KW},
-        {"struct",  KW_STRUCT,  C_KW}, {"enum",     KW_ENUM,      C_KW},
-        {"import",  KW_IMPORT,  C_KW}, {"module",   KW_MODULE,    C_KW},
-        {"use",     KW_USE,     C_KW}, {"type",     KW_TYPE,      C_KW},
-        {"trait",   KW_TRAIT,   C_KW}, {"impl",     KW_IMPL,      C_KW},
-        {"try",     KW_TRY,     C_KW}, {"catch",    KW_CATCH,     C_KW},
-        {"throw",   KW_THROW,   C_KW},
-
-        /* data types */
-        {"int",     DT_INT,     C_DT}, {"uint",    DT_UINT,       C_DT},
-        {"short",   DT_SHORT,   C_DT}, {"ushort",  DT_USHORT,     C_DT},
-        {"long",    DT_LONG,    C_DT}, {"ulong",   DT_ULONG,      C_DT},
-        {"char",    DT_CHAR,    C_DT}, {"byte",    DT_BYTE,       C_DT},
-        {"float",   DT_FLOAT,   C_DT}, {"decimal", DT_DECIMAL,    C_DT},
-        {"str",     DT_STR,     C_DT}, {"bool",    DT_BOOL,       C_DT},
-        {"void",    DT_VOID,    C_DT}, {"any",     DT_ANY,        C_DT},
-
-        /* modifiers */
-        {"var",     MOD_VAR,    C_MD}, {"const",   MOD_CONST,     C_MD},
-        {"final",   MOD_FINAL,  C_MD}, {"static",  MOD_STATIC,    C_MD},
-
-        /* literals */
-        {"true",    LIT_TRUE,   C_LT}, {"false",    LIT_FALSE,    C_LT},
-        {"null",    LIT_NULL,   C_LT}, {"infinity", LIT_INFINITY, C_LT},
+    return (token_t){
+        .category = (uint8_t)category,
+        .type = (uint16_t)type,
+        .atom = ATOM_NONE,
     };
+}
 
-    const size_t tokens_count = sizeof(tokens) / sizeof(tokens[0]);
-
-    tokens_table = new_hashmap();
-
-    for(size_t i = 0; i < tokens_count; ++i){
-        hm_insert(tokens_table, tokens[i].literal, &tokens[i]);
+const char* token_literal(const token_t token)
+{
+    switch(token.category){
+        case CAT_SERVICE:   return LOOKUP(service_literals, token.type);
+        case CAT_OPERATOR:  return LOOKUP(operator_literals, token.type);
+        case CAT_KEYWORD:   return LOOKUP(keyword_literals, token.type);
+        case CAT_PAREN:     return LOOKUP(paren_literals, token.type);
+        case CAT_DELIMITER: return LOOKUP(delimiter_literals, token.type);
+        case CAT_DATATYPE:  return LOOKUP(datatype_literals, token.type);
+        case CAT_MODIFIER:  return LOOKUP(modifier_literals, token.type);
+        case CAT_LITERAL:   return LOOKUP(word_literals, token.type);
     }
+    return NULL;
 }
 
-token_t new_token(const enum category_tag category, const int type, const char *literal)
+bool is_number_literal(const token_t token)
 {
-    token_t token = {
-        .literal = literal,
-        .type = type,
-        .category = category,
-    };
+    if(token.category != CAT_LITERAL) return false;
+    switch(token.type){
+        case LIT_NUMBER: case LIT_FLOAT:
+        case LIT_HEX:    case LIT_BIN:   case LIT_OCT:
+            return true;
+        default:
+            return false;
+    }
+}
 
-#ifdef DEBUG
-    print_token(token);
-#endif
+#undef LOOKUP
 
-    return token;
-}
+#define WORD(word, cat, kind)                                                   \
+    if(memcmp(begin, word, sizeof(word) - 1) == 0){                             \
+        static const token_t token = {.category = cat, .type = kind, .atom = ATOM_NONE}; \
+        return &token;                                                          \
+    }
 
-token_t* find_token(const char* literal)
+// keywords, data types, modifiers and literal words, picked by length and
+// first byte so that at most three comparisons are made for any identifier
+const token_t* find_keyword(const char* begin, const size_t length)
 {
-    return hm_lookup(tokens_table, literal);
+    if(!begin || length < 2) return NULL;
+
+    switch(length){
+        case 2:
+            switch(begin[0]){
+                case 'd': WORD("do", C_KW, KW_DO); break;
+                case 'i': WORD("if", C_KW, KW_IF); break;
+            }
+            break;
+
+        case 3:
+            switch(begin[0]){
+                case 'a': WORD("any", C_DT, DT_ANY); break;
+                case 'f': WORD("for", C_KW, KW_FOR); break;
+                case 'i': WORD("int", C_DT, DT_INT); break;
+                case 's': WORD("str", C_DT, DT_STR); break;
+                case 't': WORD("try", C_KW, KW_TRY); break;
+                case 'u': WORD("use", C_KW, KW_USE); break;
+                case 'v': WORD("var", C_MD, MOD_VAR); break;
+            }
+            break;
+
+        case 4:
+            switch(begin[0]){
+                case 'b': WORD("byte", C_DT, DT_BYTE); WORD("bool", C_DT, DT_BOOL); break;
+                case 'c': WORD("case", C_KW, KW_CASE); WORD("char", C_DT, DT_CHAR); break;
+                case 'e': WORD("else", C_KW, KW_ELSE); WORD("elif", C_KW, KW_ELIF); WORD("enum", C_KW, KW_ENUM); break;
+                case 'f': WORD("func", C_KW, KW_FUNC); break;
+                case 'i': WORD("impl", C_KW, KW_IMPL); break;
+                case 'l': WORD("long", C_DT, DT_LONG); break;
+                case 'n': WORD("null", C_LT, LIT_NULL); break;
+                case 't': WORD("type", C_KW, KW_TYPE); WORD("true", C_LT, LIT_TRUE); break;
+                case 'u': WORD("uint", C_DT, DT_UINT); break;
+                case 'v': WORD("void", C_DT, DT_VOID); break;
+            }
+            break;
+
+        case 5:
+            switch(begin[0]){
+                case 'b': WORD("break", C_KW, KW_BREAK); break;
+                case 'c': WORD("catch", C_KW, KW_CATCH); WORD("const", C_MD, MOD_CONST); break;
+                case 'f': WORD("float", C_DT, DT_FLOAT); WORD("final", C_MD, MOD_FINAL); WORD("false", C_LT, LIT_FALSE); break;
+                case 'm': WORD("match", C_KW, KW_MATCH); break;
+                case 's': WORD("short", C_DT, DT_SHORT); break;
+                case 't': WORD("trait", C_KW, KW_TRAIT); WORD("throw", C_KW, KW_THROW); break;
+                case 'u': WORD("ulong", C_DT, DT_ULONG); break;
+                case 'w': WORD("while", C_KW, KW_WHILE); break;
+            }
+            break;
+
+        case 6:
+            switch(begin[0]){
+                case 'i': WORD("import", C_KW, KW_IMPORT); break;
+                case 'm': WORD("module", C_KW, KW_MODULE); break;
+                case 'r': WORD("return", C_KW, KW_RETURN); break;
+                case 's': WORD("struct", C_KW, KW_STRUCT); WORD("static", C_MD, MOD_STATIC); break;
+                case 'u': WORD("ushort", C_DT, DT_USHORT); break;
+            }
+            break;
+
+        case 7:
+            if(begin[0] != 'd') break;
+            WORD("default", C_KW, KW_DEFAULT);
+            WORD("decimal", C_DT, DT_DECIMAL);
+            break;
+
+        case 8:
+            switch(begin[0]){
+                case 'c': WORD("continue", C_KW, KW_CONTINUE); break;
+                case 'i': WORD("infinity", C_LT, LIT_INFINITY); break;
+            }
+            break;
+    }
+    return NULL;
 }
 
-void free_tokens(void)
-{
-    free_hashmap(tokens_table);
-}
+#undef WORD
@@ -1,18 +1,29 @@
 #include <stddef.h>     // size_t
+#include <stdlib.h>     // calloc, free
+#include <string.h>     // strlen
 
 #include "compiler/frontend/lexer/tokens.h"
 #include "core/ds/arena.h"              // arena_t
 #include "core/lang/diagnostic.h"       // diagnostic_t
 
-#include "compiler/frontend/ast.h"      // ast_t, node_t
+#include "compiler/frontend/ast.h"      // ast_t, node_id_t
+#include "compiler/frontend/ast/traversal.h"    // prune_node_kinds
 #include "compiler/frontend/parser.h"   // parser_t
 #include "compiler/frontend/parser/decl.h"  // parse_decl_func, parse_decl_struct, etc.
 #include "compiler/frontend/parser/stmt.h"  // parse_stmt_if, parse_stmt_while, etc.
+#include "core/platform/unix.h"    // pthread_create, pthread_join
+#include "core/platform/windows.h" // CreateThread, WaitForSingleObject
 
 #ifdef DEBUG
 #include "core/lang/debug.h"    // print_ast
+
+#define DEBUG_AST_MAX_NODES 4096 // bigger trees are generated input, their dump is only noise
 #endif
 
+// a span of parse_program_parallel only interns into its own pool, those
+// atoms are tagged so the join can tell them from the lexer's
+#define SPAN_ATOM 0x80000000u
+
 parse_func_t parse_table[] = {
     [KW_IF]       = parse_stmt_if,
     [KW_WHILE]    = parse_stmt_while,
@@ -38,26 +49,55 @@ const size_t PARSE_TABLE_LENGTH = sizeof(parse_table)/sizeof(parse_table[0]);
 
 parser_t* new_parser(compiler_context_t* ctx, lexer_t* lexer)
 {
+    if(!lexer) return NULL;
+
     parser_t* parser = arena_alloc(ctx->memory.phase_arena, sizeof(parser_t), alignof(parser_t));
     if(!parser) return NULL;
     parser->token.current = next_token(lexer);
     parser->token.next = next_token(lexer);
+    parser->loc = lexer->loc;
     parser->lexer = lexer;
+    parser->buffer = NULL;
+    parser->index = 0;
+    parser->in_span = false;
+    parser->scratch = (nodes_t){0};
+    parser->depth = 0;
+    parser->too_deep = false;
     parser->ctx = ctx;
     return parser;
 }
 
-ast_t* parse_program(parser_t* parser)
+parser_t* new_buffered_parser(compiler_context_t* ctx, const token_buffer_t* buffer)
 {
+    if(!buffer || buffer->count == 0) return NULL;
+
+    parser_t* parser = arena_alloc(ctx->memory.phase_arena, sizeof(parser_t), alignof(parser_t));
     if(!parser) return NULL;
+    parser->token.current = buffer_token(buffer, 0);
+    parser->token.next = buffer_token(buffer, 1);
+    parser->loc = buffer_loc(buffer, 1);
+    parser->lexer = NULL;
+    parser->buffer = buffer;
+    parser->index = 1;
+    parser->in_span = false;
+    parser->scratch = (nodes_t){0};
+    parser->depth = 0;
+    parser->too_deep = false;
+    parser->ctx = ctx;
+    return parser;
+}
 
-    parser->ctx->ast = arena_alloc_default(parser->ctx->memory.perm_arena, sizeof(ast_t));
-    if(!parser->ctx->ast) return NULL;
+// parses top-level statements into the root block until the current token
+// is the one at buffer index `end` or past it, or the input runs out
+static bool parse_statements(parser_t* parser, const size_t end)
+{
+    ast_t* ast = parser->ctx->ast;
+    list_builder_t statements = begin_list(parser);
 
-    while(!is_eof(parser->token.next)){
+    while(!is_eof(parser->token.next) && parser->index <= end){
         token_t prev_token = parser->token.current;
 
-        node_t* stmt = parse_stmt(parser);
+        node_id_t stmt = parse_stmt(parser);
         if(!stmt){
             if((parser->token.current.category == prev_token.category
             &&  parser->token.current.type == prev_token.type)
@@ -69,21 +109,440 @@ ast_t* parse_program(parser_t* parser)
             continue;
         }
 
-        if(!add_stmt_block(parser, parser->ctx->ast->nodes, stmt)) return NULL;
+        if(!push_list(parser, &statements, stmt)) return false;
 
         // optionally consume ';'
         if(check_token(parser, CAT_OPERATOR, OPER_SEMICOLON)){
             advance_token(parser);
         }
-
-        parser->ctx->ast->count++;
     }
 
+    return end_list(parser, &statements, &ast_node(ast, ast->root)->block.statement);
+}
+
+static ast_t* finish_program(ast_t* ast)
+{
+    if(!prune_node_kinds(ast)) return NULL;
+
 #ifdef DEBUG
-    print_ast(parser->ctx->ast->nodes, 0);
+    if(ast->count <= DEBUG_AST_MAX_NODES) print_ast(ast, ast->root, 0);
 #endif
 
-    return parser->ctx->ast;
+    return ast;
+}
+
+ast_t* parse_program(parser_t* parser)
+{
+    if(!parser) return NULL;
+
+    free_ast(parser->ctx->ast);
+    parser->ctx->ast = new_ast(parser->ctx->memory.perm_arena, &parser->ctx->memory.perm_strings);
+    if(!parser->ctx->ast) return NULL;
+    ast_t* ast = parser->ctx->ast;
+
+    ast->root = new_node(ast, NODE_BLOCK);
+    if(!ast->root) return NULL;
+
+    if(!parse_statements(parser, SIZE_MAX)) return NULL;
+
+    // missing parentheses and expressions of the levels that were open
+    if(parser->too_deep){
+        arena_rewind(parser->ctx->reports->arena, parser->reports_mark);
+        parser->ctx->reports->count = parser->reports_count;
+    }
+
+    return finish_program(ast);
+}
+
+// one run of top-level statements for parse_program_parallel. It is parsed
+// with a private context, so interning and reports need no locks, and its
+// nodes, atoms and reports are moved into the real context afterwards.
+typedef struct {
+    compiler_context_t local;   // own arenas, string pool, reports and ast, the source is shared
+    const token_buffer_t* buffer;
+    size_t begin;               // buffer index of the first token
+    size_t end;                 // begin of the next span, or the buffer count
+    parser_t* parser;           // where the span stopped
+    bool ok;
+} parse_span_t;
+
+static void parse_span(parse_span_t* span)
+{
+    compiler_context_t* local = &span->local;
+    local->ast = new_ast(local->memory.perm_arena, &local->memory.perm_strings);
+    if(!local->ast) return;
+
+    local->ast->root = new_node(local->ast, NODE_BLOCK);
+    parser_t* parser = local->ast->root ? new_buffered_parser(local, span->buffer) : NULL;
+    if(!parser) return;
+
+    parser->in_span = true;
+    parser->token.current = buffer_token(span->buffer, span->begin);
+    parser->token.next = buffer_token(span->buffer, span->begin + 1);
+    parser->loc = buffer_loc(span->buffer, span->begin + 1);
+    parser->index = span->begin + 1;
+
+    span->parser = parser;
+    span->ok = parse_statements(parser, span->end) && !parser->too_deep;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI parse_span_thread(LPVOID arg)
+{
+    parse_span(arg);
+    return 0;
+}
+#else
+static void* parse_span_thread(void* arg)
+{
+    parse_span(arg);
+    return NULL;
+}
+#endif
+
+// Cuts the tokens from `first` into up to `threads` spans, each beginning
+// near an even share at a func, struct, enum or module keyword outside any
+// brackets that follows a `}` or `;`. Returns the number of spans, whose
+// first tokens go to `cuts`.
+static size_t cut_spans(const token_buffer_t* buffer, const size_t first, const size_t threads, size_t* cuts)
+{
+    const size_t length = buffer->count - first;
+    size_t count = 0;
+    cuts[count++] = first;
+
+    size_t depth = 0;
+    size_t target = first + length / threads;
+    for(size_t i = first + 1; i < buffer->count && count < threads; i++){
+        const uint8_t category = buffer->categories[i];
+        const uint16_t type = buffer->types[i];
+
+        if(category == CAT_PAREN){
+            if(type == PAR_LPAREN || type == PAR_LBRACE || type == PAR_LBRACKET) depth++;
+            else if(depth > 0) depth--;
+            continue;
+        }
+        if(depth > 0 || i < target || category != CAT_KEYWORD) continue;
+        if(type != KW_FUNC && type != KW_STRUCT && type != KW_ENUM && type != KW_MODULE) continue;
+
+        const bool after_brace = buffer->categories[i - 1] == CAT_PAREN && buffer->types[i - 1] == PAR_RBRACE;
+        const bool after_semicolon = buffer->categories[i - 1] == CAT_OPERATOR && buffer->types[i - 1] == OPER_SEMICOLON;
+        if(!after_brace && !after_semicolon) continue;
+
+        cuts[count++] = i;
+        target = first + length * count / threads;
+    }
+    return count;
+}
+
+// joins the spans in order, node ids are shifted past the nodes already in
+// the tree and the span's own atoms interned in the real pool on first use
+typedef struct {
+    ast_t* ast;
+    const ast_t* from;
+    uint32_t base;          // added to every id of `from` but its root's
+    uint32_t extra_base;    // added to the start of every list of `from`
+    atom_t* atoms;          // span atom without SPAN_ATOM -> context atom, ATOM_NONE until first use
+    string_pool_t* strings;
+} ast_join_t;
+
+static void join_id(const ast_join_t* join, node_id_t* id)
+{
+    if(*id != NODE_NONE) *id += join->base;
+}
+
+static void join_atom(ast_join_t* join, atom_t* atom)
+{
+    if(!(*atom & SPAN_ATOM)) return;
+
+    const atom_t local = *atom & ~SPAN_ATOM;
+    if(!join->atoms[local]){
+        const string_t str = sp_atom_str(join->from->names, local);
+        join->atoms[local] = new_string_n(join->strings, str.data, str.length).atom;
+    }
+    *atom = join->atoms[local];
+}
+
+// the items were copied with the rest of the extra array already
+static void join_list(ast_join_t* join, node_list_t* list, const bool atoms)
+{
+    if(list->count == 0) return;
+
+    list->start += join->extra_base;
+    uint32_t* items = join->ast->extra + list->start;
+    for(uint32_t i = 0; i < list->count; i++){
+        if(atoms) join_atom(join, &items[i]);
+        else join_id(join, &items[i]);
+    }
+}
+
+static void join_node(ast_join_t* join, node_t* node)
+{
+    switch(node->kind){
+        case NODE_BINOP:
+            join_id(join, &node->binop.left);
+            join_id(join, &node->binop.right);
+            break;
+        case NODE_UNARYOP:
+            join_id(join, &node->unaryop.right);
+            break;
+        case NODE_LITERAL:
+            join_atom(join, &node->lit.value);
+            break;
+        case NODE_CALL:
+            join_atom(join, &node->func_call.name);
+            join_list(join, &node->func_call.args, false);
+            break;
+        case NODE_ASSIGN:
+            join_atom(join, &node->var_assign.name);
+            join_id(join, &node->var_assign.value);
+            break;
+        case NODE_REFERENCE:
+            join_atom(join, &node->var_ref.name);
+            break;
+        case NODE_PARAM:
+            join_atom(join, &node->param_decl.name);
+            break;
+        case NODE_VARIABLE:
+            join_atom(join, &node->var_decl.name);
+            join_id(join, &node->var_decl.value);
+            break;
+        case NODE_VARIANT:
+            join_atom(join, &node->variant_decl.name);
+            join_id(join, &node->variant_decl.value);
+            break;
+        case NODE_BLOCK:
+            join_list(join, &node->block.statement, false);
+            break;
+        case NODE_RANGE:
+            join_id(join, &node->range.start);
+            join_id(join, &node->range.end);
+            break;
+        case NODE_IF:
+            join_id(join, &node->if_stmt.condition);
+            join_id(join, &node->if_stmt.then_block);
+            join_id(join, &node->if_stmt.elif_blocks);
+            join_id(join, &node->if_stmt.else_block);
+            break;
+        case NODE_WHILE:
+            join_id(join, &node->while_stmt.condition);
+            join_id(join, &node->while_stmt.body);
+            break;
+        case NODE_FOR:
+            join_id(join, &node->for_stmt.init);
+            join_id(join, &node->for_stmt.condition);
+            join_id(join, &node->for_stmt.update);
+            join_id(join, &node->for_stmt.body);
+            break;
+        case NODE_FUNC:
+            join_atom(join, &node->func_decl.name);
+            join_list(join, &node->func_decl.param_decl, false);
+            join_id(join, &node->func_decl.body);
+            break;
+        case NODE_MATCH:
+            join_id(join, &node->match_stmt.target);
+            join_list(join, &node->match_stmt.block, false);
+            break;
+        case NODE_CASE:
+            join_id(join, &node->case_stmt.condition);
+            join_id(join, &node->case_stmt.body);
+            break;
+        case NODE_STRUCT:
+            join_atom(join, &node->struct_decl.name);
+            join_list(join, &node->struct_decl.member, false);
+            break;
+        case NODE_ENUM:
+            join_atom(join, &node->enum_decl.name);
+            join_list(join, &node->enum_decl.member, false);
+            break;
+        case NODE_ARRAY:
+            join_list(join, &node->array_decl.elements, false);
+            break;
+        case NODE_RETURN:
+            join_id(join, &node->return_stmt.body);
+            break;
+        case NODE_TYPE:
+            join_atom(join, &node->type_decl.name);
+            join_id(join, &node->type_decl.body);
+            break;
+        case NODE_IMPORT:
+            join_list(join, &node->import_decl.modules, true);
+            break;
+        case NODE_MODULE:
+            join_atom(join, &node->module_decl.name);
+            join_id(join, &node->module_decl.body);
+            break;
+        case NODE_TRAIT:
+            join_atom(join, &node->trait_decl.name);
+            join_id(join, &node->trait_decl.body);
+            break;
+        case NODE_IMPL:
+            join_atom(join, &node->impl_decl.trait_name);
+            join_atom(join, &node->impl_decl.struct_name);
+            join_id(join, &node->impl_decl.body);
+            break;
+        case NODE_TRY:
+            join_id(join, &node->try_stmt.try_block);
+            break;
+        case NODE_CATCH:
+            join_id(join, &node->catch_stmt.catch_block);
+            break;
+        default:
+            break;
+    }
+}
+
+// appends the nodes of a span but its root, the root's statements go to
+// `statements` and its reports to the real table
+static bool join_span(parser_t* parser, list_builder_t* statements, parse_span_t* span)
+{
+    ast_t* ast = parser->ctx->ast;
+    const ast_t* from = span->local.ast;
+
+    // the root's list is the last one a span creates
+    const node_list_t roots = ast_node(from, from->root)->block.statement;
+    const uint32_t extra = roots.count > 0 ? roots.start : from->extra_count;
+
+    ast_join_t join = {
+        .ast = ast,
+        .from = from,
+        .base = ast->count - 1,
+        .extra_base = ast->extra_count,
+        .atoms = calloc(span->local.memory.perm_strings.count + 1, sizeof(atom_t)),
+        .strings = &parser->ctx->memory.perm_strings,
+    };
+    if(!join.atoms) return false;
+
+    node_list_t copied;
+    bool ok = new_node_list(ast, from->extra, extra, &copied);
+
+    for(node_id_t id = from->root + 1; ok && id <= from->count; id++){
+        const node_t* node = ast_node(from, id);
+        const node_id_t copy = new_node(ast, node->kind);
+        if(!copy){
+            ok = false;
+            break;
+        }
+        *ast_node(ast, copy) = *node;
+        join_node(&join, ast_node(ast, copy));
+    }
+
+    for(uint32_t i = 0; ok && i < roots.count; i++){
+        ok = push_list(parser, statements, ast_list(from, roots)[i] + join.base);
+    }
+
+    report_iter_t it = report_iter(span->local.reports);
+    for(const report_t* report = report_next(&it); ok && report; report = report_next(&it)){
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, report->severity, report->code, report->loc);
+    }
+
+    free(join.atoms);
+    return ok;
+}
+
+ast_t* parse_program_parallel(parser_t* parser, size_t threads)
+{
+    if(!parser) return NULL;
+
+    const token_buffer_t* buffer = parser->buffer;
+    if(!buffer) return parse_program(parser);
+
+    const size_t first = parser->index - 1;
+    if(threads > PARSER_MAX_THREADS) threads = PARSER_MAX_THREADS;
+    if(threads > (buffer->count - first) / PARSER_SPAN_MIN) threads = (buffer->count - first) / PARSER_SPAN_MIN;
+    if(threads <= 1) return parse_program(parser);
+
+    size_t cuts[PARSER_MAX_THREADS];
+    const size_t count = cut_spans(buffer, first, threads, cuts);
+    if(count <= 1) return parse_program(parser);
+
+    parse_span_t* spans = calloc(count, sizeof(parse_span_t));
+    if(!spans) return NULL;
+
+    bool ok = true;
+    for(size_t i = 0; i < count; i++){
+        parse_span_t* span = &spans[i];
+        span->buffer = buffer;
+        span->begin = cuts[i];
+        span->end = i + 1 < count ? cuts[i + 1] : SIZE_MAX;
+        span->local.src_manager.current = parser->ctx->src_manager.current;
+        span->local.memory.perm_arena = new_arena(ARENA_DEF_SIZE);
+        span->local.memory.phase_arena = new_arena(ARENA_DEF_SIZE);
+        span->local.memory.perm_strings = new_string_pool(SP_DEF_CAPACITY);
+        span->local.reports = span->local.memory.perm_arena ? new_report_table(span->local.memory.perm_arena) : NULL;
+        ok = ok && span->local.memory.phase_arena && span->local.reports;
+    }
+
+    // the first span is parsed on this thread, the rest on workers
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE workers[PARSER_MAX_THREADS];
+#else
+    pthread_t workers[PARSER_MAX_THREADS];
+#endif
+    bool started[PARSER_MAX_THREADS] = {false};
+
+    if(ok){
+        for(size_t i = 1; i < count; i++){
+#if defined(_WIN32) || defined(_WIN64)
+            workers[i] = CreateThread(NULL, 0, parse_span_thread, &spans[i], 0, NULL);
+            started[i] = workers[i] != NULL;
+#else
+            started[i] = pthread_create(&workers[i], NULL, parse_span_thread, &spans[i]) == 0;
+#endif
+        }
+        parse_span(&spans[0]);
+    }
+    for(size_t i = 1; i < count; i++){
+        if(!started[i]){
+            if(ok) parse_span(&spans[i]);
+            continue;
+        }
+#if defined(_WIN32) || defined(_WIN64)
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
+#else
+        pthread_join(workers[i], NULL);
+#endif
+    }
+
+    // a sequential parse reaches every cut at the start of a statement, or a
+    // span swallowed the next one's first tokens and the cuts are no good
+    for(size_t i = 0; ok && i < count; i++){
+        ok = spans[i].ok && (i + 1 == count || spans[i].parser->index - 1 == spans[i].end);
+    }
+
+    ast_t* ast = NULL;
+    if(ok){
+        free_ast(parser->ctx->ast);
+        parser->ctx->ast = new_ast(parser->ctx->memory.perm_arena, &parser->ctx->memory.perm_strings);
+        ast = parser->ctx->ast;
+        if(ast) ast->root = new_node(ast, NODE_BLOCK);
+
+        list_builder_t statements = begin_list(parser);
+        bool joined = ast && ast->root;
+        for(size_t i = 0; joined && i < count; i++){
+            joined = join_span(parser, &statements, &spans[i]);
+        }
+        joined = joined && end_list(parser, &statements, &ast_node(ast, ast->root)->block.statement);
+
+        const parser_t* last = spans[count - 1].parser;
+        parser->token = last->token;
+        parser->loc = last->loc;
+        parser->index = last->index;
+
+        ast = joined ? finish_program(ast) : NULL;
+    }
+
+    for(size_t i = 0; i < count; i++){
+        compiler_context_t* local = &spans[i].local;
+        free_ast(local->ast);
+        free_string_pool(&local->memory.perm_strings);
+        if(local->reports) free_report_table(local->reports);
+        if(local->memory.phase_arena) free_arena(local->memory.phase_arena);
+        if(local->memory.perm_arena) free_arena(local->memory.perm_arena);
+    }
+    free(spans);
+
+    return ok ? ast : parse_program(parser);
 }
 
 bool check_token(parser_t* parser, enum category_tag category, int type)
@@ -96,42 +555,111 @@ bool is_eof(const token_t token)
     return token.category == CAT_SERVICE && token.type == SERV_EOF;
 }
 
-void set_node_loc(node_t* node, parser_t* parser)
+static atom_t intern_atom(parser_t* parser, const char* str, const size_t length)
+{
+    const atom_t atom = new_string_n(&parser->ctx->memory.perm_strings, str, length).atom;
+    return parser->in_span && atom != ATOM_NONE ? atom | SPAN_ATOM : atom;
+}
+
+atom_t token_atom(parser_t* parser, const token_t token)
+{
+    // numbers carry a constant id instead of an atom, their spelling is the source slice
+    if(is_number_literal(token)){
+        const string_t* content = parser->ctx->src_manager.current->content;
+        return intern_atom(parser, content->data + token.offset, token.length);
+    }
+
+    // identifiers and strings were interned by the lexer already
+    if(token.atom != ATOM_NONE) return token.atom;
+
+    // fixed tokens are spelled by the static table
+    const char* literal = token_literal(token);
+    if(!literal) return ATOM_NONE;
+    return intern_atom(parser, literal, strlen(literal));
+}
+
+void set_node_loc(const node_id_t node, parser_t* parser)
 {
     if(!node || !parser) return;
-    node->loc = parser->lexer->loc;
+    ast_node(parser->ctx->ast, node)->loc = parser->loc;
 }
 
-void set_node_len(node_t* node, parser_t* parser, size_t start_pos)
+void set_node_len(const node_id_t node, parser_t* parser, size_t start_pos)
 {
     if(!node || !parser) return;
-    size_t end_pos = parser->lexer->loc.offset;
+    node_t* n = ast_node(parser->ctx->ast, node);
+    size_t end_pos = get_lexer_pos(parser);
     if(end_pos > start_pos){
-        node->loc.length = end_pos - start_pos;
+        n->loc.length = (uint32_t)(end_pos - start_pos);
     }
     else {
-        node->loc.length = 1;
+        n->loc.length = 1;
     }
 }
 
 size_t get_lexer_pos(parser_t* parser)
 {
-    return parser ? parser->lexer->loc.offset : 0;
+    // end of the lookahead token
+    return parser ? (size_t)parser->loc.offset + parser->loc.length : 0;
+}
+
+bool enter_nesting(parser_t* parser)
+{
+    if(parser->too_deep) return false;
+
+    if(parser->depth >= PARSER_MAX_DEPTH){
+        report_table_t* reports = parser->ctx->reports;
+        add_report(reports, parser->ctx->src_manager.current, SEV_ERR, ERR_NEST_DEPTH, parser->loc);
+
+        // the lexer still reports on the skipped input
+        while(!is_eof(parser->token.next)) advance_token(parser);
+
+        parser->too_deep = true;
+        parser->reports_mark = arena_mark(reports->arena);
+        parser->reports_count = reports->count;
+        return false;
+    }
+
+    parser->depth++;
+    return true;
+}
+
+void leave_nesting(parser_t* parser)
+{
+    if(parser->depth > 0) parser->depth--;
 }
 
 void advance_token(parser_t* parser)
 {
     if(!parser || is_eof(parser->token.next)) return;
     parser->token.current = parser->token.next;
+
+    if(parser->buffer){
+        parser->index++;
+        parser->token.next = buffer_token(parser->buffer, parser->index);
+        parser->loc = buffer_loc(parser->buffer, parser->index);
+        return;
+    }
     parser->token.next = next_token(parser->lexer);
+    parser->loc = parser->lexer->loc;
+}
+
+// token `ahead` positions after the current one, a streaming parser can only see token.next
+token_t peek_token(parser_t* parser, size_t ahead)
+{
+    if(!parser) return new_token(CAT_SERVICE, SERV_ILLEGAL);
+    if(ahead == 0) return parser->token.current;
+    if(ahead == 1) return parser->token.next;
+    if(parser->buffer) return buffer_token(parser->buffer, parser->index + ahead - 1);
+    return new_token(CAT_SERVICE, SERV_ILLEGAL);
 }
 
-bool consume_token(parser_t* parser, node_t* node, const enum category_tag expec_category, const int expec_type, const enum report_code err)
+bool consume_token(parser_t* parser, const node_id_t node, const enum category_tag expec_category, const int expec_type, const enum report_code err)
 {
     if(!parser) return false;
 
     if(parser->token.current.category != expec_category){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, err, node->loc);
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, err, ast_node(parser->ctx->ast, node)->loc);
         return false;
     }
 
@@ -139,7 +667,7 @@ bool consume_token(parser_t* parser, node_t* node, const enum category_tag expec
         int actual_type = parser->token.current.type;
 
         if(actual_type != expec_type){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, err, node->loc);
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, err, ast_node(parser->ctx->ast, node)->loc);
             return false;
         }
     }
@@ -147,3 +675,30 @@ bool consume_token(parser_t* parser, node_t* node, const enum category_tag expec
     advance_token(parser);
     return true;
 }
+
+list_builder_t begin_list(parser_t* parser)
+{
+    return (list_builder_t){parser ? parser->scratch.count : 0, 0};
+}
+
+bool push_list(parser_t* parser, list_builder_t* list, const uint32_t item)
+{
+    if(!parser || !list) return false;
+
+    // drops whatever a nested list left behind when its parse failed
+    parser->scratch.count = list->base + list->count;
+    if(!nodes_push(parser->ctx->memory.phase_arena, &parser->scratch, item)) return false;
+    list->count++;
+    return true;
+}
+
+bool end_list(parser_t* parser, list_builder_t* list, node_list_t* out)
+{
+    if(!parser || !list) return false;
+
+    // `out` may point into the node array, nothing here grows it
+    bool ok = new_node_list(parser->ctx->ast, parser->scratch.elems + list->base, list->count, out);
+    parser->scratch.count = list->base;
+    list->count = 0;
+    return ok;
+}
@@ -3,113 +3,110 @@
 #include "compiler/frontend/parser/stmt.h"  // parse_stmt_block
 #include "core/lang/source.h"
 
-node_t* parse_decl_var(parser_t* parser)
+node_id_t parse_decl_var(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_VARIABLE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_VARIABLE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     // expect modifier
     if(parser->token.current.category != CAT_MODIFIER){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_KEYWORD, node->loc);
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_KEYWORD, parser_node(parser, node)->loc);
     }
-    node->var_decl->modif = parser->token.current.type;
+    parser_node(parser, node)->var_decl.modif = parser->token.current.type;
     advance_token(parser);
 
     // expect identifier
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->var_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->var_decl->name.data) return NULL;
+    parser_node(parser, node)->var_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->var_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // optional type annotation
     if(check_token(parser, CAT_OPERATOR, OPER_COLON)){
         advance_token(parser);
         if(parser->token.current.category != CAT_DATATYPE && !check_token(parser, CAT_LITERAL, LIT_IDENT)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, loc_copy(node->loc, 1));
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, loc_copy(parser_node(parser, node)->loc, 1));
+            return NODE_NONE;
         }
-        node->var_decl->dtype = parser->token.current.type;
+        parser_node(parser, node)->var_decl.dtype = parser->token.current.type;
         advance_token(parser);
     }
 
     // optional assignment
     if(check_token(parser, CAT_OPERATOR, OPER_ASSIGN)){
         advance_token(parser);
-        node->var_decl->value = parse_expr(parser);
-        if(!node->var_decl->value){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, node->loc);
-            return NULL;
+        node_id_t value = parse_expr(parser);
+        if(!value){
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
+        parser_node(parser, node)->var_decl.value = value;
     }
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_type(parser_t* parser)
+node_id_t parse_decl_type(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_TYPE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_TYPE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'type'
 
     // expect type name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->type_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->type_decl->name.data) return NULL;
+    parser_node(parser, node)->type_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->type_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // expect ':'
-    if(!consume_token(parser, node, CAT_OPERATOR, OPER_COLON, ERR_EXPEC_OPER)) return NULL;
+    if(!consume_token(parser, node, CAT_OPERATOR, OPER_COLON, ERR_EXPEC_OPER)) return NODE_NONE;
 
     // expect type body (currently only struct or enum)
+    node_id_t body;
     if(check_token(parser, CAT_KEYWORD, KW_STRUCT)){
-        node->type_decl->body = parse_decl_struct(parser);
+        body = parse_decl_struct(parser);
     }
     else if(check_token(parser, CAT_KEYWORD, KW_ENUM)){
-        node->type_decl->body = parse_decl_enum(parser);
+        body = parse_decl_enum(parser);
     }
     else {
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, node->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, parser_node(parser, node)->loc);
+        return NODE_NONE;
     }
+    parser_node(parser, node)->type_decl.body = body;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_array(parser_t* parser)
+node_id_t parse_decl_array(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_ARRAY);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_ARRAY);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip '['
 
     // parse elements (comma separated)
+    list_builder_t elements = begin_list(parser);
     while(!check_token(parser, CAT_PAREN, PAR_RBRACKET)){
-        node_t* element = parse_expr(parser);
-        if(!element) return NULL;
-
-        if(node->array_decl->count >= node->array_decl->capacity){
-            size_t new_cap = node->array_decl->capacity == 0 ? 4 : node->array_decl->capacity * 2;
-            node_t** new_arr = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_cap, alignof(node_t*));
-            if(!new_arr) return NULL;
-            node->array_decl->elements = new_arr;
-            node->array_decl->capacity = new_cap;
-        }
-        node->array_decl->elements[node->array_decl->count++] = element;
+        node_id_t element = parse_expr(parser);
+        if(!element) return NODE_NONE;
+
+        if(!push_list(parser, &elements, element)) return NODE_NONE;
 
         if(check_token(parser, CAT_OPERATOR, OPER_COMMA)){
             advance_token(parser); // consume ','
@@ -119,87 +116,80 @@ node_t* parse_decl_array(parser_t* parser)
     }
 
     // expect ']'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACKET, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACKET, ERR_EXPEC_PAREN)) return NODE_NONE;
+    if(!end_list(parser, &elements, &parser_node(parser, node)->array_decl.elements)) return NODE_NONE;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_param(parser_t* parser)
+node_id_t parse_decl_param(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_VARIABLE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_VARIABLE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     // expect identifier
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->var_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->var_decl->name.data) return NULL;
+    parser_node(parser, node)->var_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->var_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // expect ':'
-    if(!consume_token(parser, node, CAT_OPERATOR, OPER_COLON, ERR_EXPEC_OPER)) return NULL;
+    if(!consume_token(parser, node, CAT_OPERATOR, OPER_COLON, ERR_EXPEC_OPER)) return NODE_NONE;
 
     // expect datatype
     if(parser->token.current.category != CAT_DATATYPE){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, node->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, parser_node(parser, node)->loc);
+        return NODE_NONE;
     }
-    node->var_decl->dtype = parser->token.current.type;
+    parser_node(parser, node)->var_decl.dtype = parser->token.current.type;
     advance_token(parser);
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_func(parser_t* parser)
+node_id_t parse_decl_func(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_FUNC);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_FUNC);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'func'
 
     // expect function name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
 
-    node->func_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->func_decl->name.data) return NULL;
+    parser_node(parser, node)->func_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->func_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // expect '('
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parsing params until ')'
+    list_builder_t params = begin_list(parser);
     if(!check_token(parser, CAT_PAREN, PAR_RPAREN)){
         while(true){
-            node_t* param_decl = parse_decl_param(parser);
-            if(!param_decl) return NULL;
+            node_id_t param_decl = parse_decl_param(parser);
+            if(!param_decl) return NODE_NONE;
 
             // ensure parameter node is a variable
-            if(param_decl->kind != NODE_VARIABLE){
-                add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PARAM, node->loc);
-                return NULL;
-            }
-
-            // check if there is enough capacity
-            if(node->func_decl->param_decl.count >= node->func_decl->param_decl.capacity){
-                size_t new_capacity = node->func_decl->param_decl.capacity == 0 ? 4 : node->func_decl->param_decl.capacity * 2;
-                node_t** new_params = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_capacity, alignof(node_t*));
-                if(!new_params) return NULL;
-                node->func_decl->param_decl.elems = new_params;
-                node->func_decl->param_decl.capacity = new_capacity;
+            if(parser_node(parser, param_decl)->kind != NODE_VARIABLE){
+                add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PARAM, parser_node(parser, node)->loc);
+                return NODE_NONE;
             }
 
-            node->func_decl->param_decl.elems[node->func_decl->param_decl.count++] = param_decl;
+            if(!push_list(parser, &params, param_decl)) return NODE_NONE;
 
             // consume ','
             if(check_token(parser, CAT_OPERATOR, OPER_COMMA)){
@@ -211,6 +201,7 @@ node_t* parse_decl_func(parser_t* parser)
     }
 
     advance_token(parser); // consume ')'
+    if(!end_list(parser, &params, &parser_node(parser, node)->func_decl.param_decl)) return NODE_NONE;
 
     // optional return type
     if(check_token(parser, CAT_OPERATOR, OPER_COLON)){
@@ -218,56 +209,51 @@ node_t* parse_decl_func(parser_t* parser)
 
         // expect datatype
         if(parser->token.current.category != CAT_DATATYPE){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, node->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_TYPE, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
 
-        node->func_decl->return_type = parser->token.current.type;
+        parser_node(parser, node)->func_decl.return_type = parser->token.current.type;
         advance_token(parser);
     }
 
     // expect function body (block)
-    node->func_decl->body = parse_stmt_block(parser);
-    if(!node->func_decl->body) return NULL;
+    node_id_t body = parse_stmt_block(parser);
+    if(!body) return NODE_NONE;
+    parser_node(parser, node)->func_decl.body = body;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_struct(parser_t* parser)
+node_id_t parse_decl_struct(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_STRUCT);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_STRUCT);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'struct'
 
     // expect '{'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse struct members
+    list_builder_t members = begin_list(parser);
     while(!check_token(parser,  CAT_PAREN, PAR_RBRACE)){
 
         // check for EOF
         if(is_eof(parser->token.current) || is_eof(parser->token.next)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, node->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
 
         // parse member variable declaration
-        node_t* member = parse_decl_var(parser);
-        if(!member) return NULL;
+        node_id_t member = parse_decl_var(parser);
+        if(!member) return NODE_NONE;
 
         // add member
-        if(node->struct_decl->member.count >= node->struct_decl->member.capacity){
-            size_t new_cap = node->struct_decl->member.capacity == 0 ? 4 : node->struct_decl->member.capacity * 2;
-            node_t** new_members = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_cap, alignof(node_t*));
-            if(!new_members) return NULL;
-            node->struct_decl->member.elems = new_members;
-            node->struct_decl->member.capacity = new_cap;
-        }
-        node->struct_decl->member.elems[node->struct_decl->member.count++] = member;
+        if(!push_list(parser, &members, member)) return NODE_NONE;
 
         // optional comma separator
         if(check_token(parser, CAT_OPERATOR, OPER_COMMA)){
@@ -276,50 +262,49 @@ node_t* parse_decl_struct(parser_t* parser)
     }
 
     // expect '}'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
+    if(!end_list(parser, &members, &parser_node(parser, node)->struct_decl.member)) return NODE_NONE;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_variant(parser_t* parser)
+node_id_t parse_decl_variant(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_VARIANT);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_VARIANT);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     // expect member name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->variant_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->variant_decl->name.data) return NULL;
+    parser_node(parser, node)->variant_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->variant_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // optional value assignment
     if(check_token(parser, CAT_OPERATOR, OPER_ASSIGN)){
         advance_token(parser);
-        node->variant_decl->value = parse_expr(parser);
-        if(!node->variant_decl->value){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, node->loc);
-            return NULL;
+        node_id_t value = parse_expr(parser);
+        if(!value){
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
-    }
-    else {
-        node->variant_decl->value = NULL;
+        parser_node(parser, node)->variant_decl.value = value;
     }
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_enum(parser_t* parser)
+node_id_t parse_decl_enum(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_ENUM);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_ENUM);
+    if(!node) return NODE_NONE;
 
     set_node_loc(node, parser);
 
@@ -327,112 +312,98 @@ node_t* parse_decl_enum(parser_t* parser)
 
     // expect enum name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->enum_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->enum_decl->name.data) return NULL;
+    parser_node(parser, node)->enum_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->enum_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // expect '{'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse enum members
+    list_builder_t members = begin_list(parser);
     while(!check_token(parser, CAT_PAREN, PAR_RBRACE))
     {
         // check for EOF
-        if(is_eof(parser->token.current) || is_eof(parser->token.next)) return NULL;
+        if(is_eof(parser->token.current) || is_eof(parser->token.next)) return NODE_NONE;
 
         // expect member name
         if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+            return NODE_NONE;
         }
 
-        node_t* member = parse_decl_variant(parser);
-        if(!member) return NULL;
+        node_id_t member = parse_decl_variant(parser);
+        if(!member) return NODE_NONE;
 
-        // grow array if needed
-        if(node->enum_decl->member.count >= node->enum_decl->member.capacity){
-            size_t new_cap = node->enum_decl->member.capacity == 0 ? 4 : node->enum_decl->member.capacity * 2;
-            node_t** new_members = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_cap, alignof(node_t*));
-            if(!new_members) return NULL;
-            node->enum_decl->member.elems = new_members;
-            node->enum_decl->member.capacity = new_cap;
-        }
-        node->enum_decl->member.elems[node->enum_decl->member.count++] = member;
+        // add member
+        if(!push_list(parser, &members, member)) return NODE_NONE;
 
         // optional comma separator
         if(check_token(parser, CAT_OPERATOR, OPER_COMMA)) advance_token(parser);
     }
 
     // expect '}'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
+    if(!end_list(parser, &members, &parser_node(parser, node)->enum_decl.member)) return NODE_NONE;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_module(parser_t* parser)
+node_id_t parse_decl_module(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_MODULE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_MODULE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'module'
 
     // expect module name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->module_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->module_decl->name.data) return NULL;
+    parser_node(parser, node)->module_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->module_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // optional module body
     if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-        node->module_decl->body = parse_stmt_block(parser);
-        if(!node->module_decl->body) return NULL;
-    }
-    else {
-        node->module_decl->body = NULL;
+        node_id_t body = parse_stmt_block(parser);
+        if(!body) return NODE_NONE;
+        parser_node(parser, node)->module_decl.body = body;
     }
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_import(parser_t* parser)
+node_id_t parse_decl_import(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_IMPORT);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_IMPORT);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'import'
 
     // parse module path
+    list_builder_t modules = begin_list(parser);
     do {
         // expect module name component
         if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-            return NULL;
-        }
-
-        if(node->import_decl->count >= node->import_decl->capacity){
-            size_t new_cap = node->import_decl->capacity == 0 ? 4 : node->import_decl->capacity * 2;
-            string_t* new_modules = (string_t*)arena_alloc_array(parser->ctx->ast->arena, sizeof(string_t), new_cap, alignof(string_t));
-            if(!new_modules) return NULL;
-            node->import_decl->modules = new_modules;
-            node->import_decl->capacity = new_cap;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+            return NODE_NONE;
         }
 
         // store module name component
-        string_t module_name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-        if(!module_name.data) return NULL;
-        node->import_decl->modules[node->import_decl->count++] = module_name;
+        atom_t module_name = token_atom(parser, parser->token.current);
+        if(!module_name) return NODE_NONE;
+        if(!push_list(parser, &modules, module_name)) return NODE_NONE;
 
         advance_token(parser);
 
@@ -446,26 +417,28 @@ node_t* parse_decl_import(parser_t* parser)
         }
     } while (true);
 
+    if(!end_list(parser, &modules, &parser_node(parser, node)->import_decl.modules)) return NODE_NONE;
+
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_impl(parser_t* parser)
+node_id_t parse_decl_impl(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_IMPL);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_IMPL);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'impl'
 
     // expect trait name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->impl_decl->trait_name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->impl_decl->trait_name.data) return NULL;
+    parser_node(parser, node)->impl_decl.trait_name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->impl_decl.trait_name) return NODE_NONE;
     advance_token(parser);
 
     // optional 'for' clause
@@ -474,23 +447,21 @@ node_t* parse_decl_impl(parser_t* parser)
 
         // expect struct name
         if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+            return NODE_NONE;
         }
-        node->impl_decl->struct_name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-        if(!node->impl_decl->struct_name.data) return NULL;
+        parser_node(parser, node)->impl_decl.struct_name = token_atom(parser, parser->token.current);
+        if(!parser_node(parser, node)->impl_decl.struct_name) return NODE_NONE;
         advance_token(parser);
     }
-    else {
-        node->impl_decl->struct_name = (string_t){0};
-    }
 
     // expect '{'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse body
-    node->impl_decl->body = parse_stmt_block(parser);
-    if(!node->impl_decl->body) return NULL;
+    node_id_t body = parse_stmt_block(parser);
+    if(!body) return NODE_NONE;
+    parser_node(parser, node)->impl_decl.body = body;
 
     set_node_len(node, parser, start_pos);
     return node;
@@ -1,95 +1,221 @@
-#include "compiler/frontend/parser/expr.h"  // parse_expr, parse_expr_keyword, parse_expr_paren, parse_expr_literal, parse_expr_operator, parse_expr_func_call
+#include "compiler/frontend/parser/expr.h"  // parse_expr, parse_expr_binop, parse_expr_unaryop, parse_expr_literal, parse_expr_func_call
 #include "compiler/frontend/parser/decl.h"  // parse_decl_var, parse_decl_array
 #include "compiler/frontend/parser/stmt.h"  // parse_stmt_block
 
-node_t* parse_expr(parser_t* parser)
+// binding powers, an operator takes operands that bind at least as tight
+enum expr_precedence {
+    PREC_NONE     = 0,
+    PREC_ASSIGN   = 2,     // = += -= *= /= %=, right associative
+    PREC_OR       = 4,     // ||
+    PREC_AND      = 5,     // &&
+    PREC_EQUALITY = 9,     // == !=
+    PREC_COMPARE  = 10,    // < > <= >=
+    PREC_TERM     = 12,    // + -
+    PREC_FACTOR   = 13,    // * / %
+    PREC_PREFIX   = 14,    // + - ! ++ -- in front of the operand
+    PREC_POSTFIX  = 15,    // ++ -- after it
+};
+
+typedef struct expr_rule expr_rule_t;
+typedef node_id_t (*infix_func_t)(parser_t* parser, node_id_t left, const expr_rule_t* rule);
+
+// what a token does at the start of an operand (prefix) and after one
+// (infix). Statement rules only start a whole expression and nothing
+// continues it.
+struct expr_rule {
+    parse_func_t prefix;
+    infix_func_t infix;
+    uint8_t precedence;     // of the infix
+    bool right_assoc;
+    bool statement;
+};
+
+// rules are looked up by category and type, every type fits in the low bits
+#define EXPR_KIND_BITS 5
+#define EXPR_KIND(category, type) ((category) << EXPR_KIND_BITS | (type))
+#define NUM_EXPR_KINDS ((CAT_MODIFIER + 1) << EXPR_KIND_BITS)
+
+_Static_assert(OPER_RANGE < (1 << EXPR_KIND_BITS) && KW_TYPE < (1 << EXPR_KIND_BITS) && LIT_OCT < (1 << EXPR_KIND_BITS),
+               "token types are expected to fit in EXPR_KIND_BITS");
+
+static node_id_t parse_expr_ident(parser_t* parser);
+static node_id_t parse_expr_group(parser_t* parser);
+static node_id_t parse_expr_infix(parser_t* parser, node_id_t left, const expr_rule_t* rule);
+static node_id_t parse_expr_postfix(parser_t* parser, node_id_t left, const expr_rule_t* rule);
+
+#define LITERAL(type)  [EXPR_KIND(CAT_LITERAL, type)] = {.prefix = parse_expr_literal}
+#define KEYWORD(type)  [EXPR_KIND(CAT_KEYWORD, type)] = {.prefix = parse_expr_keyword, .statement = true}
+#define MODIFIER(type) [EXPR_KIND(CAT_MODIFIER, type)] = {.prefix = parse_decl_var, .statement = true}
+#define BINARY(type, prec) [EXPR_KIND(CAT_OPERATOR, type)] = {.infix = parse_expr_infix, .precedence = prec}
+#define ASSIGN(type)   [EXPR_KIND(CAT_OPERATOR, type)] = {.infix = parse_expr_infix, .precedence = PREC_ASSIGN, .right_assoc = true}
+
+static const expr_rule_t expr_rules[NUM_EXPR_KINDS] = {
+    [EXPR_KIND(CAT_LITERAL, LIT_IDENT)] = {.prefix = parse_expr_ident},
+    LITERAL(LIT_NULL),   LITERAL(LIT_NUMBER),   LITERAL(LIT_CHAR),
+    LITERAL(LIT_STRING), LITERAL(LIT_TRUE),     LITERAL(LIT_FALSE),
+    LITERAL(LIT_FLOAT),  LITERAL(LIT_INFINITY), LITERAL(LIT_HEX),
+    LITERAL(LIT_BIN),    LITERAL(LIT_OCT),
+
+    [EXPR_KIND(CAT_PAREN, PAR_LPAREN)]   = {.prefix = parse_expr_group},
+    [EXPR_KIND(CAT_PAREN, PAR_LBRACKET)] = {.prefix = parse_decl_array},
+    [EXPR_KIND(CAT_PAREN, PAR_LBRACE)]   = {.prefix = parse_stmt_block, .statement = true},
+
+    // + and - are both prefix and infix
+    [EXPR_KIND(CAT_OPERATOR, OPER_PLUS)]   = {.prefix = parse_expr_unaryop, .infix = parse_expr_infix, .precedence = PREC_TERM},
+    [EXPR_KIND(CAT_OPERATOR, OPER_MINUS)]  = {.prefix = parse_expr_unaryop, .infix = parse_expr_infix, .precedence = PREC_TERM},
+    [EXPR_KIND(CAT_OPERATOR, OPER_NOT)]    = {.prefix = parse_expr_unaryop},
+    [EXPR_KIND(CAT_OPERATOR, OPER_INCREM)] = {.prefix = parse_expr_unaryop, .infix = parse_expr_postfix, .precedence = PREC_POSTFIX},
+    [EXPR_KIND(CAT_OPERATOR, OPER_DECREM)] = {.prefix = parse_expr_unaryop, .infix = parse_expr_postfix, .precedence = PREC_POSTFIX},
+
+    BINARY(OPER_ASTERISK, PREC_FACTOR), BINARY(OPER_SLASH, PREC_FACTOR), BINARY(OPER_PERCENT, PREC_FACTOR),
+    BINARY(OPER_LANGLE, PREC_COMPARE),  BINARY(OPER_RANGLE, PREC_COMPARE),
+    BINARY(OPER_LTE, PREC_COMPARE),     BINARY(OPER_GTE, PREC_COMPARE),
+    BINARY(OPER_EQ, PREC_EQUALITY),     BINARY(OPER_NEQ, PREC_EQUALITY),
+    BINARY(OPER_AND, PREC_AND),         BINARY(OPER_OR, PREC_OR),
+
+    ASSIGN(OPER_ASSIGN), ASSIGN(OPER_ADD), ASSIGN(OPER_SUB),
+    ASSIGN(OPER_MUL),    ASSIGN(OPER_DIV), ASSIGN(OPER_MOD),
+
+    KEYWORD(KW_IF),     KEYWORD(KW_WHILE),  KEYWORD(KW_FOR),
+    KEYWORD(KW_MATCH),  KEYWORD(KW_TRY),    KEYWORD(KW_CATCH),
+    KEYWORD(KW_BREAK),  KEYWORD(KW_CONTINUE), KEYWORD(KW_RETURN),
+    KEYWORD(KW_FUNC),   KEYWORD(KW_STRUCT), KEYWORD(KW_ENUM),
+    KEYWORD(KW_TRAIT),  KEYWORD(KW_IMPL),   KEYWORD(KW_TYPE),
+    KEYWORD(KW_MODULE), KEYWORD(KW_IMPORT),
+
+    MODIFIER(MOD_VAR), MODIFIER(MOD_CONST), MODIFIER(MOD_FINAL), MODIFIER(MOD_STATIC),
+};
+
+#undef LITERAL
+#undef KEYWORD
+#undef MODIFIER
+#undef BINARY
+#undef ASSIGN
+
+// kinds outside the table share the empty rule of SERV_ILLEGAL
+static inline const expr_rule_t* token_rule(const token_t token)
 {
-    if(!parser) return NULL;
-
-    switch(parser->token.current.category){
-        case CAT_OPERATOR: return parse_expr_operator(parser);
-        case CAT_KEYWORD:  return parse_expr_keyword(parser);
-        case CAT_PAREN:    return parse_expr_paren(parser);
-        case CAT_MODIFIER: return parse_decl_var(parser);
-        case CAT_LITERAL:  return parse_expr_binop(parser, 0);
-        default: return NULL;
+    if(token.category > CAT_MODIFIER || token.type >= (1 << EXPR_KIND_BITS)) return &expr_rules[0];
+    return &expr_rules[EXPR_KIND(token.category, token.type)];
+}
+
+// an operand starting with `rule`'s token, then every operator binding at
+// least as tight as `min_precedence`. One rule lookup per token. Operators
+// that would have to advance past the last token fail instead, advancing
+// there leaves it current.
+static node_id_t parse_expr_rule(parser_t* parser, const expr_rule_t* rule, const int min_precedence)
+{
+    if(!rule->prefix || rule->statement) return NODE_NONE;
+
+    node_id_t left = rule->prefix(parser);
+    if(!left) return NODE_NONE;
+
+    size_t expr_start_pos = get_lexer_pos(parser) - parser_node(parser, left)->loc.length;
+
+    while(true){
+        rule = token_rule(parser->token.current);
+        if(!rule->infix || rule->precedence < min_precedence) break;
+
+        left = rule->infix(parser, left, rule);
+        if(!left) return NODE_NONE;
+    }
+
+    // update length to span the entire expression
+    size_t current_pos = get_lexer_pos(parser);
+    if(current_pos > expr_start_pos){
+        parser_node(parser, left)->loc.length = current_pos - expr_start_pos;
     }
+    return left;
+}
+
+node_id_t parse_expr(parser_t* parser)
+{
+    if(!parser) return NODE_NONE;
+    if(!enter_nesting(parser)) return NODE_NONE;
+
+    const expr_rule_t* rule = token_rule(parser->token.current);
+    node_id_t node = rule->statement ? rule->prefix(parser) : parse_expr_rule(parser, rule, PREC_NONE);
 
-    return NULL;
+    leave_nesting(parser);
+    return node;
 }
 
-node_t* parse_expr_keyword(parser_t* parser)
+node_id_t parse_expr_binop(parser_t* parser, int min_precedence)
+{
+    if(!parser) return NODE_NONE;
+    return parse_expr_rule(parser, token_rule(parser->token.current), min_precedence);
+}
+
+node_id_t parse_expr_keyword(parser_t* parser)
 {
     const int kw = parser->token.current.type;
 
     if(kw < 0 || (size_t)kw >= PARSE_TABLE_LENGTH){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_KEYWORD, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_KEYWORD, parser->loc);
+        return NODE_NONE;
     }
 
     parse_func_t func = parse_table[kw];
 
-    if(!func) return NULL;
+    if(!func) return NODE_NONE;
 
     return func(parser);
 }
 
-node_t* parse_expr_paren(parser_t* parser)
+static node_id_t parse_expr_group(parser_t* parser)
 {
-    switch(parser->token.current.type){
-        case PAR_LBRACE:   return parse_stmt_block(parser);
-        case PAR_LBRACKET: return parse_decl_array(parser);
-        case PAR_LPAREN:
-            advance_token(parser); // skip '('
-
-            node_t* node = parse_expr(parser);
-            if(!node) return NULL;
-
-            // expect ')'
-            if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NULL;
-            return node;
-        default: return NULL;
-    }
+    // a '(' that ends the input would be parsed again and again
+    if(is_eof(parser->token.next)) return NODE_NONE;
+
+    advance_token(parser); // skip '('
+
+    node_id_t node = parse_expr(parser);
+    if(!node) return NODE_NONE;
+
+    // expect ')'
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
+    return node;
 }
 
-node_t* parse_expr_literal(parser_t* parser)
+node_id_t parse_expr_literal(parser_t* parser)
 {
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_LITERAL);
-    if(!node) return NULL;
+    size_t start_pos = get_lexer_pos(parser);
+    node_id_t node = new_node(parser->ctx->ast, NODE_LITERAL);
+    if(!node) return NODE_NONE;
+    set_node_loc(node, parser);
 
-    node->lit->value = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->lit->value.data) return NULL;
-    node->lit->type = parser->token.current.type;
+    struct node_literal* lit = &parser_node(parser, node)->lit;
+    lit->value = token_atom(parser, parser->token.current);
+    lit->type = parser->token.current.type;
+    lit->constant = is_number_literal(parser->token.current) ? parser->token.current.constant : CONST_NONE;
 
     advance_token(parser);
+    set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_expr_operator(parser_t* parser)
+static node_id_t parse_expr_ident(parser_t* parser)
 {
-    bool is_unary = (parser->token.next.category == CAT_LITERAL) ||
-                    (parser->token.next.category == CAT_PAREN    &&
-                    (parser->token.next.type     == PAR_LPAREN   ||
-                     parser->token.next.type     == PAR_LBRACE   ||
-                     parser->token.next.type     == PAR_LBRACKET));
-
-    return is_unary ? parse_expr_unaryop(parser) : parse_expr_binop(parser, 0);
+    if(parser->token.next.category == CAT_PAREN && parser->token.next.type == PAR_LPAREN){
+        return parse_expr_func_call(parser);
+    }
+    return parse_expr_var_ref(parser);
 }
 
-node_t* parse_expr_func_call(parser_t* parser)
+node_id_t parse_expr_func_call(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_CALL);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_CALL);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     // extract function name before consuming token
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, node->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser_node(parser, node)->loc);
+        return NODE_NONE;
     }
-    node->func_call->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->func_call->name.data) return NULL;
+    parser_node(parser, node)->func_call.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->func_call.name) return NODE_NONE;
     advance_token(parser);
 
     // parse arguments if '(' is present
@@ -97,20 +223,12 @@ node_t* parse_expr_func_call(parser_t* parser)
         advance_token(parser); // skip '('
 
         // parse arguments until ')'
+        list_builder_t args = begin_list(parser);
         while (!check_token(parser, CAT_PAREN, PAR_RPAREN)){
-            node_t* arg = parse_expr(parser);
-            if(!arg) return NULL;
-
-            // grow array if needed
-            if(node->func_call->args.count >= node->func_call->args.capacity){
-                size_t new_capacity = node->func_call->args.capacity == 0 ? 4 : node->func_call->args.capacity * 2;
-                node_t** new_args = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_capacity, alignof(node_t*));
-                if(!new_args) return NULL;
-                node->func_call->args.elems = new_args;
-                node->func_call->args.capacity = new_capacity;
-            }
+            node_id_t arg = parse_expr(parser);
+            if(!arg) return NODE_NONE;
 
-            node->func_call->args.elems[node->func_call->args.count++] = arg;
+            if(!push_list(parser, &args, arg)) return NODE_NONE;
 
             if(check_token(parser, CAT_OPERATOR, OPER_COMMA)){
                 advance_token(parser); // skip ','
@@ -122,29 +240,30 @@ node_t* parse_expr_func_call(parser_t* parser)
 
         // expect closing ')'
         if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, node->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
+        if(!end_list(parser, &args, &parser_node(parser, node)->func_call.args)) return NODE_NONE;
     }
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_expr_var_ref(parser_t* parser)
+node_id_t parse_expr_var_ref(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_REFERENCE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_REFERENCE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
 
-    node->var_ref->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->var_ref->name.data) return NULL;
+    parser_node(parser, node)->var_ref.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->var_ref.name) return NODE_NONE;
 
     advance_token(parser);
 
@@ -152,299 +271,101 @@ node_t* parse_expr_var_ref(parser_t* parser)
     return node;
 }
 
-node_t* parse_expr_primary(parser_t* parser)
+static node_id_t parse_expr_postfix(parser_t* parser, node_id_t left, const expr_rule_t* rule)
 {
-    switch(parser->token.current.category){
-        case CAT_LITERAL:
-            if(parser->token.current.type == LIT_IDENT){
-                if(parser->token.next.category == CAT_PAREN && parser->token.next.type == PAR_LPAREN){
-                    return parse_expr_func_call(parser);
-                }
-                return parse_expr_var_ref(parser);
-            }
-            else {
-                size_t start_pos = get_lexer_pos(parser);
-                node_t* node = new_node(parser->ctx->ast->arena, NODE_LITERAL);
-                if(!node) return NULL;
-                set_node_loc(node, parser);
-                node->lit->value = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-                node->lit->type = parser->token.current.type;
-                advance_token(parser);
-                set_node_len(node, parser, start_pos);
-                return node;
-            }
-
-        case CAT_PAREN:
-            if(parser->token.current.type == PAR_LPAREN){
-                advance_token(parser);
-                node_t* expr = parse_expr(parser);
-                if(!expr) return NULL;
-
-                // expect ')'
-                if(!consume_token(parser, expr, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NULL;
-                return expr;
-            }
-            else if(parser->token.current.type == PAR_LBRACKET){
-                return parse_decl_array(parser);
-            }
-            break;
-        case CAT_OPERATOR:
-            // check for unary operators
-            if(parser->token.current.type == OPER_PLUS
-            || parser->token.current.type == OPER_MINUS
-            || parser->token.current.type == OPER_NOT)
-            {
-                return parse_expr_unaryop(parser);
-            }
-            break;
-        default: break;
-    }
-    return NULL;
-
+    (void)rule;
+    size_t start_pos = get_lexer_pos(parser) - parser_node(parser, left)->loc.length;
+    node_id_t postfix = new_node(parser->ctx->ast, NODE_UNARYOP);
+    if(!postfix) return NODE_NONE;
+
+    node_t* n = parser_node(parser, postfix);
+    n->loc = parser_node(parser, left)->loc;
+    n->unaryop.right = left;
+    n->unaryop.is_postfix = true;
+    n->unaryop.operator = parser->token.current.type;
+
+    // advancing keeps the last token current, every operator loop would apply it again
+    if(is_eof(parser->token.next)) parser->token.current = parser->token.next;
+    else advance_token(parser);
+
+    set_node_len(postfix, parser, start_pos);
+    return postfix;
 }
 
-int get_operator_precedence(enum category_operator op)
+static node_id_t parse_expr_infix(parser_t* parser, node_id_t left, const expr_rule_t* rule)
 {
-    switch(op){
-        case OPER_INCREM:
-        case OPER_DECREM:
-            return 15;
-
-        case OPER_ASTERISK:
-        case OPER_SLASH:
-        case OPER_PERCENT:
-            return 13;
-
-        case OPER_PLUS:
-        case OPER_MINUS:
-            return 12;
-
-        case OPER_LANGLE:
-        case OPER_RANGLE:
-        case OPER_LTE:
-        case OPER_GTE:
-            return 10;
-
-        case OPER_EQ:
-        case OPER_NEQ:
-            return 9;
-
-        case OPER_AND:
-            return 5;
-
-        case OPER_OR:
-            return 4;
-
-        case OPER_ASSIGN:
-        case OPER_ADD:
-        case OPER_SUB:
-        case OPER_MUL:
-        case OPER_DIV:
-        case OPER_MOD:
-            return 2;
-
-        case OPER_COMMA:
-            return 1;
-
-        case OPER_DOT:
-        case OPER_SEMICOLON:
-        case OPER_COLON:
-        case OPER_QUESTION:
-        case OPER_RANGE:
-        case OPER_NOT:
-        default:
-            return 0;
-    }
-}
+    enum category_operator op_type = parser->token.current.type;
 
-bool is_right_associative(enum category_operator op)
-{
-    switch(op){
-        case OPER_ASSIGN: case OPER_ADD: case OPER_SUB: case OPER_MUL: case OPER_DIV: case OPER_MOD:
-            return true;
-        default:
-            return false;
+    // nothing follows the operator
+    if(is_eof(parser->token.next)){
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, parser->loc);
+        return NODE_NONE;
     }
-}
-
-bool is_binary_operator(enum category_operator op)
-{
-    int precedence = get_operator_precedence(op);
-    return precedence > 0 && op != OPER_SEMICOLON && op != OPER_COMMA;
-}
-
-node_t* parse_expr_postfix(parser_t* parser)
-{
-    node_t* expr = parse_expr_primary(parser);
-    if(!expr) return NULL;
-
-    while(parser->token.current.category == CAT_OPERATOR){
-        enum category_operator op = parser->token.current.type;
-
-        if(op == OPER_INCREM || op == OPER_DECREM){
-            size_t start_pos = get_lexer_pos(parser) - expr->loc.length;
-            node_t* postfix = new_node(parser->ctx->ast->arena, NODE_UNARYOP);
-            if(!postfix) return NULL;
-
-            postfix->loc = expr->loc;
-            postfix->unaryop->right = expr;
-            postfix->unaryop->is_postfix = true;
-            postfix->unaryop->operator = op;
-
-            advance_token(parser);
-            set_node_len(postfix, parser, start_pos);
+    advance_token(parser);
 
-            expr = postfix;
-        }
-        else break;
+    // `a = b = c ...` nests one level per operator
+    if(!enter_nesting(parser)) return NODE_NONE;
+    node_id_t right = parse_expr_binop(parser, rule->right_assoc ? rule->precedence : rule->precedence + 1);
+    leave_nesting(parser);
+    if(!right){
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, parser->loc);
+        return NODE_NONE;
     }
-    return expr;
-}
 
-node_t* parse_expr_binop(parser_t* parser, int min_precedence)
-{
-    node_t* left = parse_expr_postfix(parser);
-    if(!left) return NULL;
-
-    size_t expr_start_pos = get_lexer_pos(parser) - left->loc.length;
-
-    while(parser->token.current.category == CAT_OPERATOR){
-        enum category_operator op_type = parser->token.current.type;
-        if(op_type == OPER_SEMICOLON || op_type == OPER_COMMA) break;
-
-        int precedence = get_operator_precedence(op_type);
-        if(precedence == 0 || precedence < min_precedence) break;
-
-        #ifdef DEBUG
-        const char* op_literal;
-        switch(op_type) {
-            case OPER_PLUS:      op_literal = "+"; break;
-            case OPER_MINUS:     op_literal = "-"; break;
-            case OPER_ASTERISK:  op_literal = "*"; break;
-            case OPER_SLASH:     op_literal = "/"; break;
-            case OPER_PERCENT:   op_literal = "%"; break;
-            case OPER_ASSIGN:    op_literal = "="; break;
-            case OPER_ADD:       op_literal = "+="; break;
-            case OPER_SUB:       op_literal = "-="; break;
-            case OPER_MUL:       op_literal = "*="; break;
-            case OPER_DIV:       op_literal = "/="; break;
-            case OPER_MOD:       op_literal = "%="; break;
-            case OPER_EQ:        op_literal = "=="; break;
-            case OPER_NEQ:       op_literal = "!="; break;
-            case OPER_LANGLE:    op_literal = "<"; break;
-            case OPER_RANGLE:    op_literal = ">"; break;
-            case OPER_LTE:       op_literal = "<="; break;
-            case OPER_GTE:       op_literal = ">="; break;
-            case OPER_AND:       op_literal = "&&"; break;
-            case OPER_OR:        op_literal = "||"; break;
-            case OPER_NOT:       op_literal = "!"; break;
-            case OPER_INCREM:    op_literal = "++"; break;
-            case OPER_DECREM:    op_literal = "--"; break;
-            case OPER_DOT:       op_literal = "."; break;
-            case OPER_QUESTION:  op_literal = "?"; break;
-            case OPER_COLON:     op_literal = ":"; break;
-            default:             op_literal = "?"; break;
-        }
-        #endif
+    node_id_t node = new_node(parser->ctx->ast, NODE_BINOP);
+    if(!node) return NODE_NONE;
 
-        advance_token(parser);
+    node_t* n = parser_node(parser, node);
+    n->binop.left = left;
+    n->binop.right = right;
+    n->binop.operator = op_type;
 
-        // calculate next minimum precedence
-        int next_min_prec;
-        if(is_right_associative(op_type)) next_min_prec = precedence;
-        else next_min_prec = precedence + 1;
-
-        node_t* right = parse_expr_binop(parser, next_min_prec);
-        if(!right){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_EXPR, parser->lexer->loc);
-            return NULL;
-        }
-
-        node_t* node = new_node(parser->ctx->ast->arena, NODE_BINOP);
-        if(!node) return NULL;
-
-        node->binop->left = left;
-        node->binop->right = right;
-        node->binop->operator = op_type;
-    #ifdef DEBUG
-        node->binop->lit = op_literal;
-    #endif
-        // use location from left operand
-        node->loc = left->loc;
-
-        left = node;
-    }
-
-    // update length to span the entire expression
-    if(left){
-        size_t current_pos = get_lexer_pos(parser);
-        if(current_pos > expr_start_pos){
-            left->loc.length = current_pos - expr_start_pos;
-        }
-    }
-    return left;
+    // use location from left operand
+    n->loc = parser_node(parser, left)->loc;
+    return node;
 }
 
-node_t* parse_expr_unaryop(parser_t* parser)
+node_id_t parse_expr_unaryop(parser_t* parser)
 {
+    // an operator that ends the input would be parsed again and again
+    if(is_eof(parser->token.next)) return NODE_NONE;
+
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_UNARYOP);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_UNARYOP);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
-    enum category_operator op_type = parser->token.current.type;
+    parser_node(parser, node)->unaryop.operator = parser->token.current.type;
+    parser_node(parser, node)->unaryop.is_postfix = false;
 
-    if(op_type != OPER_PLUS
-    && op_type != OPER_MINUS
-    && op_type != OPER_NOT
-    && op_type != OPER_INCREM
-    && op_type != OPER_DECREM)
-    {
-        return NULL;
-    }
-
-    node->unaryop->operator = op_type;
-    node->unaryop->is_postfix = false;
-#ifdef DEBUG
-    // Use operator string instead of potentially NULL token literal
-    switch(op_type) {
-        case OPER_PLUS:   node->unaryop->lit = "+"; break;
-        case OPER_MINUS:  node->unaryop->lit = "-"; break;
-        case OPER_NOT:    node->unaryop->lit = "!"; break;
-        case OPER_INCREM: node->unaryop->lit = "++"; break;
-        case OPER_DECREM: node->unaryop->lit = "--"; break;
-        default:          node->unaryop->lit = "?"; break;
-    }
-#endif
     advance_token(parser);
 
-    if(op_type == OPER_INCREM || op_type == OPER_DECREM){
-        node->unaryop->right = parse_expr_postfix(parser);
-    }
-    else {
-        node->unaryop->right = parse_expr_primary(parser);
-    }
+    // `- - - x` recurses once per operator
+    if(!enter_nesting(parser)) return NODE_NONE;
+    node_id_t right = parse_expr_binop(parser, PREC_PREFIX);
+    leave_nesting(parser);
 
-    if(!node->unaryop->right) return NULL;
+    if(!right) return NODE_NONE;
+    parser_node(parser, node)->unaryop.right = right;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_expr_array_access(parser_t* parser)
+node_id_t parse_expr_array_access(parser_t* parser)
 {
     // TODO: implement
-    return NULL;
+    return NODE_NONE;
 }
 
-node_t* parse_expr_field_access(parser_t* parser)
+node_id_t parse_expr_field_access(parser_t* parser)
 {
     // TODO: implement
-    return NULL;
+    return NODE_NONE;
 }
 
-node_t* parse_expr_lambda(parser_t* parser)
+node_id_t parse_expr_lambda(parser_t* parser)
 {
     // TODO: implement
-    return NULL;
+    return NODE_NONE;
 }
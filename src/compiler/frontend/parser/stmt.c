@@ -2,78 +2,69 @@
 #include "compiler/frontend/parser/expr.h"  // parse_expr
 #include "compiler/frontend/parser/decl.h"  // parse_decl_var
 
-node_t* parse_stmt(parser_t* parser)
+node_id_t parse_stmt(parser_t* parser)
 {
-    if(!parser) return NULL;
+    if(!parser) return NODE_NONE;
 
     // skip empty statements
     if(check_token(parser, CAT_OPERATOR, OPER_SEMICOLON)){
         advance_token(parser);
-        return NULL;
+        return NODE_NONE;
     }
 
+    if(!enter_nesting(parser)) return NODE_NONE;
+
+    node_id_t node;
     if(parser->token.current.category == CAT_KEYWORD){
-        return parse_stmt_keyword(parser);
+        node = parse_stmt_keyword(parser);
     }
     else if(parser->token.current.category == CAT_MODIFIER){
-        return parse_decl_var(parser);
+        node = parse_decl_var(parser);
     }
     else if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-        return parse_stmt_block(parser);
+        node = parse_stmt_block(parser);
+    }
+    else {
+        node = parse_expr(parser);
     }
 
-    return parse_expr(parser);
+    leave_nesting(parser);
+    return node;
 }
 
-node_t* parse_stmt_keyword(parser_t* parser)
+node_id_t parse_stmt_keyword(parser_t* parser)
 {
-    if(!parser) return NULL;
+    if(!parser) return NODE_NONE;
     int kw = parser->token.current.type;
-    if(kw < 0 || (size_t)kw >= PARSE_TABLE_LENGTH) return NULL;
+    if(kw < 0 || (size_t)kw >= PARSE_TABLE_LENGTH) return NODE_NONE;
     parse_func_t func = parse_table[kw];
-    if(!func) return NULL;
+    if(!func) return NODE_NONE;
     return func(parser);
 }
 
-bool add_stmt_block(parser_t* parser, node_t* node, node_t* stmt)
-{
-    if(node->kind != NODE_BLOCK) return false;
-
-    if(node->block->statement.count >= node->block->statement.capacity){
-        size_t new_capacity = node->block->statement.capacity == 0 ? 4 : node->block->statement.capacity * 2;
-        node_t** new_statements = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_capacity, alignof(node_t*));
-        if(!new_statements) return false;
-
-        node->block->statement.elems = new_statements;
-        node->block->statement.capacity = new_capacity;
-    }
-
-    node->block->statement.elems[node->block->statement.count++] = stmt;
-    return true;
-}
-
-node_t* parse_stmt_block(parser_t* parser)
+node_id_t parse_stmt_block(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_BLOCK);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_BLOCK);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip '{'
 
     // parse statements until '}'
+    list_builder_t statements = begin_list(parser);
     while(!check_token(parser,  CAT_PAREN, PAR_RBRACE))
     {
         // check for EOF
         if(is_eof(parser->token.current) || is_eof(parser->token.next)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, node->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
 
         token_t prev_token = parser->token.current;
 
         // parse statement
-        node_t* stmt = parse_stmt(parser);
+        node_id_t stmt = parse_stmt(parser);
         if(!stmt){
             if(parser->token.current.category == prev_token.category
             && parser->token.current.type == prev_token.type
@@ -85,7 +76,7 @@ node_t* parse_stmt_block(parser_t* parser)
         }
 
         // add to block
-        if(!add_stmt_block(parser, node, stmt)) return NULL;
+        if(!push_list(parser, &statements, stmt)) return NODE_NONE;
 
         // optionally consume ';'
         if(check_token(parser, CAT_OPERATOR, OPER_SEMICOLON)){
@@ -94,37 +85,39 @@ node_t* parse_stmt_block(parser_t* parser)
     }
 
     // expect '}'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
+    if(!end_list(parser, &statements, &parser_node(parser, node)->block.statement)) return NODE_NONE;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_stmt_ctrl(parser_t* parser)
+node_id_t parse_stmt_ctrl(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
     int type = parser->token.current.type;
-    node_t* node = NULL;
+    node_id_t node = NODE_NONE;
 
     advance_token(parser); // skip keyword
 
     switch(type){
         case KW_BREAK:
-            node = new_node(parser->ctx->ast->arena, NODE_BREAK);
+            node = new_node(parser->ctx->ast, NODE_BREAK);
             break;
         case KW_CONTINUE:
-            node = new_node(parser->ctx->ast->arena, NODE_CONTINUE);
+            node = new_node(parser->ctx->ast, NODE_CONTINUE);
             break;
         case KW_RETURN:
-            node = new_node(parser->ctx->ast->arena, NODE_RETURN);
-            if(!node) return NULL;
+            node = new_node(parser->ctx->ast, NODE_RETURN);
+            if(!node) return NODE_NONE;
             if(!check_token(parser, CAT_OPERATOR, OPER_SEMICOLON) &&
                !check_token(parser, CAT_PAREN, PAR_RBRACE)){
-                node->return_stmt->body = parse_expr(parser);
+                node_id_t body = parse_expr(parser);
+                parser_node(parser, node)->return_stmt.body = body;
             }
             break;
         default:
-            return NULL;
+            return NODE_NONE;
     }
 
     if(node){
@@ -134,32 +127,35 @@ node_t* parse_stmt_ctrl(parser_t* parser)
     return node;
 }
 
-node_t* parse_stmt_if(parser_t* parser){
+node_id_t parse_stmt_if(parser_t* parser){
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_IF);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_IF);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'if'
 
     // expect '('
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
-    node->if_stmt->condition = parse_expr(parser);
-    if(!node->if_stmt->condition) return NULL;
+    node_id_t condition = parse_expr(parser);
+    if(!condition) return NODE_NONE;
+    parser_node(parser, node)->if_stmt.condition = condition;
 
     // expect ')'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // expect '{'
+    node_id_t then_block;
     if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-        node->if_stmt->then_block = parse_stmt_block(parser);
+        then_block = parse_stmt_block(parser);
     }
     else {
-        node->if_stmt->then_block = parse_stmt(parser);
+        then_block = parse_stmt(parser);
     }
 
-    if(!node->if_stmt->then_block) return NULL;
+    if(!then_block) return NODE_NONE;
+    parser_node(parser, node)->if_stmt.then_block = then_block;
 
     // parse elif/else blocks
     while(parser->token.current.category == CAT_KEYWORD &&
@@ -171,15 +167,15 @@ node_t* parse_stmt_if(parser_t* parser){
             advance_token(parser);
 
             // expect '('
-            if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NULL;
+            if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
-            node_t* elif_condition = parse_expr(parser);
-            if(!elif_condition) return NULL;
+            node_id_t elif_condition = parse_expr(parser);
+            if(!elif_condition) return NODE_NONE;
 
             // expect ')'
-            if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NULL;
+            if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
-            node_t* elif_body;
+            node_id_t elif_body;
 
             // expect '{'
             if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
@@ -189,29 +185,19 @@ node_t* parse_stmt_if(parser_t* parser){
                 elif_body = parse_stmt(parser);
             }
 
-            if(!elif_body) return NULL;
-
-            node_t* elif_node = new_node(parser->ctx->ast->arena, NODE_IF);
-            if(!elif_node) return NULL;
+            if(!elif_body) return NODE_NONE;
 
-            elif_node->if_stmt = arena_alloc_default(parser->ctx->ast->arena, sizeof(struct node_if));
-            if(!elif_node->if_stmt) return NULL;
+            node_id_t elif_node = new_node(parser->ctx->ast, NODE_IF);
+            if(!elif_node) return NODE_NONE;
 
-            elif_node->if_stmt->condition = elif_condition;
-            elif_node->if_stmt->then_block = elif_body;
-            elif_node->if_stmt->elif_blocks = NULL;
-            elif_node->if_stmt->else_block = NULL;
+            parser_node(parser, elif_node)->if_stmt.condition = elif_condition;
+            parser_node(parser, elif_node)->if_stmt.then_block = elif_body;
 
-            if(!node->if_stmt->elif_blocks){
-                node->if_stmt->elif_blocks = elif_node;
-            }
-            else {
-                node_t* current = node->if_stmt->elif_blocks;
-                while(current->if_stmt->elif_blocks){
-                    current = current->if_stmt->elif_blocks;
-                }
-                current->if_stmt->elif_blocks = elif_node;
+            node_id_t current = node;
+            while(parser_node(parser, current)->if_stmt.elif_blocks){
+                current = parser_node(parser, current)->if_stmt.elif_blocks;
             }
+            parser_node(parser, current)->if_stmt.elif_blocks = elif_node;
         }
 
         // expect optional 'else'
@@ -219,14 +205,16 @@ node_t* parse_stmt_if(parser_t* parser){
             advance_token(parser);
 
             // expect '{'
+            node_id_t else_block;
             if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-                node->if_stmt->else_block = parse_stmt_block(parser);
+                else_block = parse_stmt_block(parser);
             }
             else {
-                node->if_stmt->else_block = parse_stmt(parser);
+                else_block = parse_stmt(parser);
             }
 
-            if(!node->if_stmt->else_block) return NULL;
+            if(!else_block) return NODE_NONE;
+            parser_node(parser, node)->if_stmt.else_block = else_block;
             break;
         }
     }
@@ -234,208 +222,207 @@ node_t* parse_stmt_if(parser_t* parser){
     return node;
 }
 
-node_t* parse_stmt_while(parser_t* parser)
+node_id_t parse_stmt_while(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_WHILE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_WHILE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'while'
 
     // expect '('
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
-    node->while_stmt->condition = parse_expr(parser);
-    if(!node->while_stmt->condition) return NULL;
+    node_id_t condition = parse_expr(parser);
+    if(!condition) return NODE_NONE;
+    parser_node(parser, node)->while_stmt.condition = condition;
 
     // expect ')'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse body (can be a block or a single statement)
+    node_id_t body;
     if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-        node->while_stmt->body = parse_stmt_block(parser);
+        body = parse_stmt_block(parser);
     }
     else {
-        node->while_stmt->body = parse_stmt(parser);
+        body = parse_stmt(parser);
     }
 
-    if(!node->while_stmt->body) return NULL;
+    if(!body) return NODE_NONE;
+    parser_node(parser, node)->while_stmt.body = body;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_stmt_for(parser_t* parser)
+node_id_t parse_stmt_for(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_FOR);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_FOR);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'for'
 
     // expect '('
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse init statement
     if(!check_token(parser, CAT_OPERATOR, OPER_SEMICOLON)){
-        node->for_stmt->init = parse_decl_var(parser);
-        if(!node->for_stmt->init) return NULL;
+        node_id_t init = parse_decl_var(parser);
+        if(!init) return NODE_NONE;
+        parser_node(parser, node)->for_stmt.init = init;
     }
 
     // expect ';'
-    if(!consume_token(parser, node, CAT_OPERATOR, OPER_SEMICOLON, ERR_EXPEC_DELIM)) return NULL;
+    if(!consume_token(parser, node, CAT_OPERATOR, OPER_SEMICOLON, ERR_EXPEC_DELIM)) return NODE_NONE;
 
     // parse condition
     if(!check_token(parser, CAT_OPERATOR, OPER_SEMICOLON)){
-        node->for_stmt->condition = parse_expr(parser);
-        if(!node->for_stmt->condition) return NULL;
+        node_id_t condition = parse_expr(parser);
+        if(!condition) return NODE_NONE;
+        parser_node(parser, node)->for_stmt.condition = condition;
     }
 
     // expect ';'
-    if(!consume_token(parser, node, CAT_OPERATOR, OPER_SEMICOLON, ERR_EXPEC_DELIM)) return NULL;
+    if(!consume_token(parser, node, CAT_OPERATOR, OPER_SEMICOLON, ERR_EXPEC_DELIM)) return NODE_NONE;
 
     // parse update statement
     if(!check_token(parser,  CAT_PAREN, PAR_RPAREN)){
-        node->for_stmt->update = parse_expr(parser);
-        if(!node->for_stmt->update) return NULL;
+        node_id_t update = parse_expr(parser);
+        if(!update) return NODE_NONE;
+        parser_node(parser, node)->for_stmt.update = update;
     }
 
     // expect ')'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RPAREN, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse body (can be a block or a single statement)
+    node_id_t body;
     if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-        node->for_stmt->body = parse_stmt_block(parser);
+        body = parse_stmt_block(parser);
     }
     else {
-        node->for_stmt->body = parse_stmt(parser);
+        body = parse_stmt(parser);
     }
 
-    if(!node->for_stmt->body) return NULL;
+    if(!body) return NODE_NONE;
+    parser_node(parser, node)->for_stmt.body = body;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_stmt_case(parser_t* parser)
+node_id_t parse_stmt_case(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_CASE);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_CASE);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'case'
 
-    node->case_stmt->condition = parse_expr(parser);
-    if(!node->case_stmt->condition) return NULL;
+    node_id_t condition = parse_expr(parser);
+    if(!condition) return NODE_NONE;
+    parser_node(parser, node)->case_stmt.condition = condition;
 
     // parse body (can be a block or a single statement)
+    node_id_t body;
     if(check_token(parser, CAT_PAREN, PAR_LBRACE)){
-        node->case_stmt->body = parse_stmt_block(parser);
+        body = parse_stmt_block(parser);
     }
     else {
-        node->case_stmt->body = parse_stmt(parser);
+        body = parse_stmt(parser);
     }
 
-    if(!node->case_stmt->body) return NULL;
+    if(!body) return NODE_NONE;
+    parser_node(parser, node)->case_stmt.body = body;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_stmt_match(parser_t* parser)
+node_id_t parse_stmt_match(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_MATCH);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_MATCH);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'match'
 
     // parse target expression
-    node->match_stmt->target = parse_expr(parser);
-    if(!node->match_stmt->target) return NULL;
+    node_id_t target = parse_expr(parser);
+    if(!target) return NODE_NONE;
+    parser_node(parser, node)->match_stmt.target = target;
 
     // expect '{'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse cases until '}'
+    list_builder_t cases = begin_list(parser);
     while(!check_token(parser, CAT_PAREN, PAR_RBRACE))
     {
         // check for EOF
         if(is_eof(parser->token.current) || is_eof(parser->token.next)){
-            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, node->loc);
-            return NULL;
+            add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_PAREN, parser_node(parser, node)->loc);
+            return NODE_NONE;
         }
 
-        node_t* case_node = parse_stmt_case(parser);
+        node_id_t case_node = parse_stmt_case(parser);
 
         // add to match statement
-        if(!node->match_stmt->block.elems){
-            node->match_stmt->block.elems = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), 4, alignof(node_t*));
-            if(!node->match_stmt->block.elems) return NULL;
-            node->match_stmt->block.capacity = 4;
-        }
-        else if(node->match_stmt->block.count >= node->match_stmt->block.capacity){
-            size_t new_capacity = node->match_stmt->block.capacity * 2;
-            node_t** new_cases = arena_alloc_array(parser->ctx->ast->arena, sizeof(node_t*), new_capacity, alignof(node_t*));
-            if(!new_cases) return NULL;
-
-            for(size_t i = 0; i < node->match_stmt->block.count; i++){
-                new_cases[i] = node->match_stmt->block.elems[i];
-            }
-            node->match_stmt->block.elems = new_cases;
-            node->match_stmt->block.capacity = new_capacity;
-        }
-        node->match_stmt->block.elems[node->match_stmt->block.count++] = case_node;
+        if(!push_list(parser, &cases, case_node)) return NODE_NONE;
     }
 
     // expect '}'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
+    if(!end_list(parser, &cases, &parser_node(parser, node)->match_stmt.block)) return NODE_NONE;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_decl_trait(parser_t* parser)
+node_id_t parse_decl_trait(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_TRAIT);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_TRAIT);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'trait'
 
     // expect name
     if(!check_token(parser, CAT_LITERAL, LIT_IDENT)){
-        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->lexer->loc);
-        return NULL;
+        add_report(parser->ctx->reports, parser->ctx->src_manager.current, SEV_ERR, ERR_EXPEC_IDENT, parser->loc);
+        return NODE_NONE;
     }
-    node->trait_decl->name = new_string(&parser->ctx->memory.perm_strings, parser->token.current.literal);
-    if(!node->trait_decl->name.data) return NULL;
+    parser_node(parser, node)->trait_decl.name = token_atom(parser, parser->token.current);
+    if(!parser_node(parser, node)->trait_decl.name) return NODE_NONE;
     advance_token(parser);
 
     // expect '{'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_LBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     // parse body
-    node->trait_decl->body = parse_stmt_block(parser);
-    if(!node->trait_decl->body) return NULL;
+    node_id_t body = parse_stmt_block(parser);
+    if(!body) return NODE_NONE;
+    parser_node(parser, node)->trait_decl.body = body;
 
     // expect '}'
-    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NULL;
+    if(!consume_token(parser, node, CAT_PAREN, PAR_RBRACE, ERR_EXPEC_PAREN)) return NODE_NONE;
 
     set_node_len(node, parser, start_pos);
     return node;
 }
 
-node_t* parse_stmt_try(parser_t* parser)
+node_id_t parse_stmt_try(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_TRY);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_TRY);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'try'
@@ -444,11 +431,11 @@ node_t* parse_stmt_try(parser_t* parser)
     return node;
 }
 
-node_t* parse_stmt_catch(parser_t* parser)
+node_id_t parse_stmt_catch(parser_t* parser)
 {
     size_t start_pos = get_lexer_pos(parser);
-    node_t* node = new_node(parser->ctx->ast->arena, NODE_CATCH);
-    if(!node) return NULL;
+    node_id_t node = new_node(parser->ctx->ast, NODE_CATCH);
+    if(!node) return NODE_NONE;
     set_node_loc(node, parser);
 
     advance_token(parser); // skip 'catch'
@@ -6,33 +6,43 @@
 #include "core/lang/debug.h"                // print_semantic_table
 #endif
 
-type_t* infer_type(semantic_t* sem, node_t* node);
-
-bool check_node(semantic_t* sem, node_t* node);
-bool check_function(semantic_t* sem, node_t* node);
-bool check_variable(semantic_t* sem, node_t* node);
-bool check_param(semantic_t* sem, node_t* node);
-bool check_block(semantic_t* sem, node_t* node);
-bool check_if(semantic_t* sem, node_t* node);
-bool check_while(semantic_t* sem, node_t* node);
-bool check_for(semantic_t* sem, node_t* node);
-bool check_return(semantic_t* sem, node_t* node);
-bool check_break(semantic_t* sem, node_t* node);
-bool check_continue(semantic_t* sem, node_t* node);
-bool check_expr(semantic_t* sem, node_t* node);
-bool check_binop(semantic_t* sem, node_t* node);
-bool check_unaryop(semantic_t* sem, node_t* node);
-bool check_func_call(semantic_t* sem, node_t* node);
-bool check_var_ref(semantic_t* sem, node_t* node);
-bool check_literal(semantic_t* sem, node_t* node);
-bool check_array(semantic_t* sem, node_t* node);
-bool check_struct(semantic_t* sem, node_t* node);
-bool check_enum(semantic_t* sem, node_t* node);
-
-bool check_type_compatibility(semantic_t* sem, node_t* node, type_t* expected, type_t* actual);
-
-bool all_paths_return(node_t* node);
-bool is_unreachable_code(node_t* node);
+type_t* infer_type(semantic_t* sem, const node_id_t id);
+
+bool check_node(semantic_t* sem, const node_id_t id);
+bool check_function(semantic_t* sem, const node_id_t id);
+bool check_variable(semantic_t* sem, const node_id_t id);
+bool check_param(semantic_t* sem, const node_id_t id);
+bool check_block(semantic_t* sem, const node_id_t id);
+bool check_if(semantic_t* sem, const node_id_t id);
+bool check_while(semantic_t* sem, const node_id_t id);
+bool check_for(semantic_t* sem, const node_id_t id);
+bool check_return(semantic_t* sem, const node_id_t id);
+bool check_break(semantic_t* sem, const node_id_t id);
+bool check_continue(semantic_t* sem, const node_id_t id);
+bool check_expr(semantic_t* sem, const node_id_t id);
+bool check_binop(semantic_t* sem, const node_id_t id);
+bool check_unaryop(semantic_t* sem, const node_id_t id);
+bool check_func_call(semantic_t* sem, const node_id_t id);
+bool check_var_ref(semantic_t* sem, const node_id_t id);
+bool check_literal(semantic_t* sem, const node_id_t id);
+bool check_array(semantic_t* sem, const node_id_t id);
+bool check_struct(semantic_t* sem, const node_id_t id);
+bool check_enum(semantic_t* sem, const node_id_t id);
+
+bool check_type_compatibility(semantic_t* sem, const node_id_t id, type_t* expected, type_t* actual);
+
+bool all_paths_return(const node_id_t id);
+bool is_unreachable_code(const node_id_t id);
+
+#define NODE_ANY -1
+
+// NULL for NODE_NONE and for nodes of another kind than `kind`
+static inline const node_t* get_node(const semantic_t* sem, const node_id_t id, const int kind)
+{
+    if(!sem || !sem->ast || id == NODE_NONE) return NULL;
+    const node_t* node = ast_node(sem->ast, id);
+    return kind == NODE_ANY || node->kind == kind ? node : NULL;
+}
 
 semantic_t* new_semantic(compiler_context_t* ctx)
 {
@@ -41,8 +51,10 @@ semantic_t* new_semantic(compiler_context_t* ctx)
     semantic_t* sem = arena_alloc(ctx->memory.phase_arena, sizeof(semantic_t), alignof(semantic_t));
     if(!sem) return NULL;
 
+    sem->types = new_type_pool(ctx->memory.phase_arena);
+
     // init if not already done
-    if(!type_int) init_types(ctx->memory.phase_arena);
+    if(!type_int) init_types(&sem->types);
 
     sem->symbols = new_symbol_table(ctx);
     if(!sem->symbols) return NULL;
@@ -50,39 +62,48 @@ semantic_t* new_semantic(compiler_context_t* ctx)
     sem->current_function = NULL;
     sem->loop_depth = 0;
     sem->phase = PHASE_DECLARE;
+    sem->ast = ctx->ast;
+    sem->order = (ast_order_t){0};
 
     sem->ctx = ctx;
 
     return sem;
 }
 
-bool analyze_ast(semantic_t* sem, node_t* root)
+bool analyze_ast(semantic_t* sem, const ast_t* ast)
 {
-    if(!sem || !root) return false;
+    if(!sem || !ast || !ast->root) return false;
+
+    sem->ast = ast;
+    if(!linearize_ast(ast, ast->root, &sem->order)) return false;
+    const node_t* root = ast_node(ast, ast->root);
 
     // declare top-level symbols
     sem->phase = PHASE_DECLARE;
     if(root->kind == NODE_BLOCK){
-        for(size_t i = 0; i < root->block->statement.count; i++){
-            node_t* stmt = root->block->statement.elems[i];
+        const node_id_t* statements = ast_list(ast, root->block.statement);
+        for(size_t i = 0; i < root->block.statement.count; i++){
+            const node_id_t stmt = statements[i];
             if(!stmt) continue;
-            if(stmt->kind == NODE_FUNC || stmt->kind == NODE_STRUCT || stmt->kind == NODE_ENUM){
+            const int kind = ast_node(ast, stmt)->kind;
+            if(kind == NODE_FUNC || kind == NODE_STRUCT || kind == NODE_ENUM){
                 (void)check_node(sem, stmt);
             }
         }
     }
     else {
         if(root->kind == NODE_FUNC || root->kind == NODE_STRUCT || root->kind == NODE_ENUM){
-            (void)check_node(sem, root);
+            (void)check_node(sem, ast->root);
         }
     }
 
     // full semantic checks.
     sem->phase = PHASE_CHECK;
     if(root->kind == NODE_BLOCK){
+        const node_id_t* statements = ast_list(ast, root->block.statement);
         bool ok = true;
-        for(size_t i = 0; i < root->block->statement.count; i++){
-            ok = check_node(sem, root->block->statement.elems[i]) && ok;
+        for(size_t i = 0; i < root->block.statement.count; i++){
+            ok = check_node(sem, statements[i]) && ok;
         }
 
 #ifdef DEBUG
@@ -92,7 +113,7 @@ bool analyze_ast(semantic_t* sem, node_t* root)
         return ok;
     }
 
-    return check_node(sem, root);
+    return check_node(sem, ast->root);
 }
 
 void free_semantic(semantic_t* sem)
@@ -100,30 +121,32 @@ void free_semantic(semantic_t* sem)
     if(!sem) return;
     if(sem->symbols) free_symbol_table(sem->symbols);
     sem->symbols = NULL;
+    free_ast_order(&sem->order);
 }
 
-bool check_node(semantic_t* sem, node_t* node)
+bool check_node(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node) return false;
+    const node_t* node = get_node(sem, id, NODE_ANY);
+    if(!node) return false;
 
     switch(node->kind){
-        case NODE_VARIABLE:      return check_variable(sem, node);
-        case NODE_REFERENCE:      return check_var_ref(sem, node);
-        case NODE_LITERAL:  return check_literal(sem, node);
-        case NODE_BINOP:    return check_binop(sem, node);
-        case NODE_UNARYOP:  return check_unaryop(sem, node);
-        case NODE_CALL:     return check_func_call(sem, node);
-        case NODE_BLOCK:    return check_block(sem, node);
-        case NODE_IF:       return check_if(sem, node);
-        case NODE_WHILE:    return check_while(sem, node);
-        case NODE_FOR:      return check_for(sem, node);
-        case NODE_RETURN:   return check_return(sem, node);
-        case NODE_BREAK:    return check_break(sem, node);
-        case NODE_CONTINUE: return check_continue(sem, node);
-        case NODE_FUNC:     return check_function(sem, node);
-        case NODE_ARRAY:    return check_array(sem, node);
-        case NODE_STRUCT:   return check_struct(sem, node);
-        case NODE_ENUM:     return check_enum(sem, node);
+        case NODE_VARIABLE: return check_variable(sem, id);
+        case NODE_REFERENCE:
+        case NODE_LITERAL:
+        case NODE_BINOP:
+        case NODE_UNARYOP:
+        case NODE_CALL:
+        case NODE_ARRAY:    return check_expr(sem, id);
+        case NODE_BLOCK:    return check_block(sem, id);
+        case NODE_IF:       return check_if(sem, id);
+        case NODE_WHILE:    return check_while(sem, id);
+        case NODE_FOR:      return check_for(sem, id);
+        case NODE_RETURN:   return check_return(sem, id);
+        case NODE_BREAK:    return check_break(sem, id);
+        case NODE_CONTINUE: return check_continue(sem, id);
+        case NODE_FUNC:     return check_function(sem, id);
+        case NODE_STRUCT:   return check_struct(sem, id);
+        case NODE_ENUM:     return check_enum(sem, id);
         default:
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_WARN, ERR_UNIMPL_NODE, node->loc);
             return true;
@@ -144,16 +167,17 @@ type_t* datatype_to_type(int dtype)
     }
 }
 
-bool check_function(semantic_t* sem, node_t* node)
+bool check_function(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_FUNC) return false;
+    const node_t* node = get_node(sem, id, NODE_FUNC);
+    if(!node) return false;
 
-    struct node_func* func = node->func_decl;
-    if(!func || !func->name.data) return false;
+    const struct node_func* func = &node->func_decl;
+    if(!func->name) return false;
 
     // register the function symbol
     if(sem->phase == PHASE_DECLARE){
-        if(is_scope_symbol_exist(sem->symbols, func->name.data)){
+        if(is_scope_symbol_exist(sem->symbols, func->name)){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FUNC_ALREADY_DECL, node->loc);
             return false;
         }
@@ -165,10 +189,11 @@ bool check_function(semantic_t* sem, node_t* node)
         if(param_count > 0){
             param_types = arena_alloc_array(sem->ctx->memory.phase_arena, sizeof(type_t*), param_count, alignof(type_t*));
             if(!param_types) return false;
+            const node_id_t* params = ast_list(sem->ast, func->param_decl);
             for(size_t i = 0; i < param_count; i++){
-                node_t* p = func->param_decl.elems[i];
-                if(p && p->kind == NODE_VARIABLE && p->var_decl){
-                    int dt = p->var_decl->dtype;
+                const node_t* p = get_node(sem, params[i], NODE_VARIABLE);
+                if(p){
+                    int dt = p->var_decl.dtype;
                     param_types[i] = (dt == DT_VOID) ? type_any : datatype_to_type(dt);
                 }
                 else {
@@ -176,9 +201,9 @@ bool check_function(semantic_t* sem, node_t* node)
                 }
             }
         }
-        type_t* func_type = new_type_function(sem->ctx->memory.phase_arena, return_type, param_types, param_count);
+        type_t* func_type = new_type_function(&sem->types, return_type, param_types, param_count);
 
-        symbol_t* func_sym = define_symbol(sem->symbols, func->name.data, SYMBOL_FUNC, func_type, node);
+        symbol_t* func_sym = define_symbol(sem->symbols, func->name, SYMBOL_FUNC, func_type, id);
         if(!func_sym){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_FUNC, node->loc);
             return false;
@@ -188,16 +213,16 @@ bool check_function(semantic_t* sem, node_t* node)
     }
 
     // check function body
-    symbol_t* func_sym = lookup_symbol(sem->symbols, func->name.data);
+    symbol_t* func_sym = lookup_symbol(sem->symbols, func->name);
     if(!func_sym){
         type_t* return_type = datatype_to_type(func->return_type);
-        type_t* func_type = new_type_function(sem->ctx->memory.phase_arena, return_type, NULL, 0);
-        func_sym = define_symbol(sem->symbols, func->name.data, SYMBOL_FUNC, func_type, node);
+        type_t* func_type = new_type_function(&sem->types, return_type, NULL, 0);
+        func_sym = define_symbol(sem->symbols, func->name, SYMBOL_FUNC, func_type, id);
         if(!func_sym) return false;
     }
 
     // create new function body scope
-    scope_t* function_scope = push_scope(sem->symbols, SCOPE_FUNCTION, node);
+    scope_t* function_scope = push_scope(sem->symbols, SCOPE_FUNCTION, id);
     if(!function_scope) return false;
 
     symbol_t* prev_func = sem->current_function;
@@ -205,8 +230,9 @@ bool check_function(semantic_t* sem, node_t* node)
 
     // add parameters to function scope
     bool params_ok = true;
+    const node_id_t* params = ast_list(sem->ast, func->param_decl);
     for(size_t i = 0; i < func->param_decl.count; i++){
-        if(!check_param(sem, func->param_decl.elems[i])){
+        if(!check_param(sem, params[i])){
             params_ok = false;
             break;
         }
@@ -225,21 +251,22 @@ bool check_function(semantic_t* sem, node_t* node)
     return success && params_ok;
 }
 
-bool check_param(semantic_t* sem, node_t* node)
+bool check_param(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_VARIABLE || !node->var_decl) return false;
+    const node_t* node = get_node(sem, id, NODE_VARIABLE);
+    if(!node) return false;
 
-    struct node_variable* var = node->var_decl;
-    if(!var->name.data) return false;
+    const struct node_variable* var = &node->var_decl;
+    if(!var->name) return false;
 
-    if(is_scope_symbol_exist(sem->symbols, var->name.data)){
+    if(is_scope_symbol_exist(sem->symbols, var->name)){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_VAR_ALREADY_DECL, node->loc);
         return false;
     }
 
     // determine parameter type
     type_t* param_type = (var->dtype == DT_VOID) ? type_any : datatype_to_type(var->dtype);
-    symbol_t* sym = define_symbol(sem->symbols, var->name.data, SYMBOL_PARAM, param_type, node);
+    symbol_t* sym = define_symbol(sem->symbols, var->name, SYMBOL_PARAM, param_type, id);
     if(!sym){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_VAR, node->loc);
         return false;
@@ -249,14 +276,15 @@ bool check_param(semantic_t* sem, node_t* node)
     return true;
 }
 
-bool check_variable(semantic_t* sem, node_t* node)
+bool check_variable(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_VARIABLE) return false;
+    const node_t* node = get_node(sem, id, NODE_VARIABLE);
+    if(!node) return false;
 
-    struct node_variable* var = node->var_decl;
-    if(!var || !var->name.data) return false;
+    const struct node_variable* var = &node->var_decl;
+    if(!var->name) return false;
 
-    if(is_scope_symbol_exist(sem->symbols, var->name.data)){
+    if(is_scope_symbol_exist(sem->symbols, var->name)){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_VAR_ALREADY_DECL, node->loc);
         return false;
     }
@@ -285,7 +313,7 @@ bool check_variable(semantic_t* sem, node_t* node)
     // check type compatibility if both annotation and initializer exist
     if(var->dtype != DT_VOID && var->value){
         type_t* init_type = infer_type(sem, var->value);
-        if(!check_type_compatibility(sem, node, var_type, init_type)){
+        if(!check_type_compatibility(sem, id, var_type, init_type)){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_TYPE_MISMATCH, node->loc);
             return false;
         }
@@ -298,7 +326,7 @@ bool check_variable(semantic_t* sem, node_t* node)
     }
 
     // add to symbol table
-    symbol_t* sym = define_symbol(sem->symbols, var->name.data, kind, var_type, node);
+    symbol_t* sym = define_symbol(sem->symbols, var->name, kind, var_type, id);
     if(!sym){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_VAR, node->loc);
         return false;
@@ -310,16 +338,18 @@ bool check_variable(semantic_t* sem, node_t* node)
     return true;
 }
 
-bool check_block(semantic_t* sem, node_t* node)
+bool check_block(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_BLOCK) return false;
+    const node_t* node = get_node(sem, id, NODE_BLOCK);
+    if(!node) return false;
 
-    scope_t* block_scope = push_scope(sem->symbols, SCOPE_BLOCK, node);
+    scope_t* block_scope = push_scope(sem->symbols, SCOPE_BLOCK, id);
     if(!block_scope) return false;
 
     bool success = true;
-    for(size_t i = 0; i < node->block->statement.count; i++){
-        if(!check_node(sem, node->block->statement.elems[i])){
+    const node_id_t* statements = ast_list(sem->ast, node->block.statement);
+    for(size_t i = 0; i < node->block.statement.count; i++){
+        if(!check_node(sem, statements[i])){
             success = false;
             // TODO: continue checking other statements
         }
@@ -329,72 +359,77 @@ bool check_block(semantic_t* sem, node_t* node)
     return success;
 }
 
-bool check_if(semantic_t* sem, node_t* node)
+bool check_if(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_IF) return false;
+    const node_t* node = get_node(sem, id, NODE_IF);
+    if(!node) return false;
 
-    if(!check_node(sem, node->if_stmt->condition)) return false; // check condition
+    if(!check_node(sem, node->if_stmt.condition)) return false; // check condition
 
     // check branches
     bool success = true;
-    if(node->if_stmt->then_block)  success = check_node(sem, node->if_stmt->then_block)  && success;
-    if(node->if_stmt->elif_blocks) success = check_node(sem, node->if_stmt->elif_blocks) && success;
-    if(node->if_stmt->else_block)  success = check_node(sem, node->if_stmt->else_block)  && success;
+    if(node->if_stmt.then_block)  success = check_node(sem, node->if_stmt.then_block)  && success;
+    if(node->if_stmt.elif_blocks) success = check_node(sem, node->if_stmt.elif_blocks) && success;
+    if(node->if_stmt.else_block)  success = check_node(sem, node->if_stmt.else_block)  && success;
 
     return success;
 }
 
-bool check_while(semantic_t* sem, node_t* node)
+bool check_while(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_WHILE) return false;
+    const node_t* node = get_node(sem, id, NODE_WHILE);
+    if(!node) return false;
 
     sem->loop_depth++;
 
     bool success = true;
-    if(node->while_stmt->condition) success = check_node(sem, node->while_stmt->condition) && success;
-    if(node->while_stmt->body)      success = check_node(sem, node->while_stmt->body) && success;
+    if(node->while_stmt.condition) success = check_node(sem, node->while_stmt.condition) && success;
+    if(node->while_stmt.body)      success = check_node(sem, node->while_stmt.body) && success;
 
     sem->loop_depth--;
     return success;
 }
 
-bool check_for(semantic_t* sem, node_t* node)
+bool check_for(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_FOR) return false;
+    const node_t* node = get_node(sem, id, NODE_FOR);
+    if(!node) return false;
 
-    scope_t* for_scope = push_scope(sem->symbols, SCOPE_BLOCK, node);
+    scope_t* for_scope = push_scope(sem->symbols, SCOPE_BLOCK, id);
     if(!for_scope) return false;
 
     sem->loop_depth++;
 
     bool success = true;
-    if(node->for_stmt->init)      success = check_node(sem, node->for_stmt->init) && success;
-    if(node->for_stmt->condition) success = check_node(sem, node->for_stmt->condition) && success;
-    if(node->for_stmt->update)    success = check_node(sem, node->for_stmt->update) && success;
-    if(node->for_stmt->body)      success = check_node(sem, node->for_stmt->body) && success;
+    if(node->for_stmt.init)      success = check_node(sem, node->for_stmt.init) && success;
+    if(node->for_stmt.condition) success = check_node(sem, node->for_stmt.condition) && success;
+    if(node->for_stmt.update)    success = check_node(sem, node->for_stmt.update) && success;
+    if(node->for_stmt.body)      success = check_node(sem, node->for_stmt.body) && success;
 
     sem->loop_depth--;
     pop_scope(sem->symbols);
     return success;
 }
 
-bool check_return(semantic_t* sem, node_t* node)
+bool check_return(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_RETURN) return false;
+    const node_t* node = get_node(sem, id, NODE_RETURN);
+    if(!node) return false;
 
     if(!sem->current_function){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_RET_OUTSIDE_FUNC, node->loc);
         return false;
     }
 
-    if(node->return_stmt->body) return check_node(sem, node->return_stmt->body);
+    if(node->return_stmt.body) return check_node(sem, node->return_stmt.body);
 
     return true;
 }
 
-bool check_break(semantic_t* sem, node_t* node)
+bool check_break(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node) return false;
+    const node_t* node = get_node(sem, id, NODE_ANY);
+    if(!node) return false;
 
     if(sem->loop_depth == 0){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_BREAK_OUTSIDE_LOOP, node->loc);
@@ -404,9 +439,10 @@ bool check_break(semantic_t* sem, node_t* node)
     return true;
 }
 
-bool check_continue(semantic_t* sem, node_t* node)
+bool check_continue(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node) return false;
+    const node_t* node = get_node(sem, id, NODE_ANY);
+    if(!node) return false;
 
     if(sem->loop_depth == 0){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_CONTINUE_OUTSIDE_LOOP, node->loc);
@@ -416,24 +452,84 @@ bool check_continue(semantic_t* sem, node_t* node)
     return true;
 }
 
-bool check_expr(semantic_t* sem, node_t* node)
+static bool is_expr(const semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node) return false;
-    // TODO: implement expression checking
-    return true;
+    switch(ast_node(sem->ast, id)->kind){
+        case NODE_REFERENCE:
+        case NODE_LITERAL:
+        case NODE_BINOP:
+        case NODE_UNARYOP:
+        case NODE_CALL:
+        case NODE_ARRAY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool check_expr_node(semantic_t* sem, const node_id_t id)
+{
+    switch(ast_node(sem->ast, id)->kind){
+        case NODE_REFERENCE: return check_var_ref(sem, id);
+        case NODE_LITERAL:   return check_literal(sem, id);
+        case NODE_BINOP:     return check_binop(sem, id);
+        case NODE_UNARYOP:   return check_unaryop(sem, id);
+        case NODE_CALL:      return check_func_call(sem, id);
+        case NODE_ARRAY:     return check_array(sem, id);
+        default:             return false;
+    }
 }
 
-bool check_binop(semantic_t* sem, node_t* node)
+// the expression is checked in one loop over its post-order, operands before
+// the operators that use them, so a long chain doesn't recurse. Statements
+// nested in it (blocks, declarations) go through check_node as a whole.
+bool check_expr(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_BINOP) return false;
+    const node_t* node = get_node(sem, id, NODE_ANY);
+    if(!node) return false;
+
+    ast_iter_t iter = ast_subtree(&sem->order, id);
+    if(!iter.next) return false;
+
+    const ast_entry_t* entries = sem->order.entries;
+    const uint32_t first = (uint32_t)(iter.next - entries);
+    const uint32_t last = (uint32_t)(iter.end - entries) - 1;
+
+    // entries of the nested statements, found from the back so the one
+    // reached first is on top
+    nodes_t nested = {0};
+    for(uint32_t i = last; i-- > first;){
+        if(is_expr(sem, entries[i].node)) continue;
+        if(!nodes_push(NULL, &nested, i)){
+            nodes_free(NULL, &nested);
+            return false;
+        }
+        i = entries[i].first;
+    }
+
+    bool ok = true;
+    for(const ast_entry_t* entry; ok && (entry = ast_iter_next(&iter));){
+        if(nested.count > 0 && entry == entries + entries[nested.elems[nested.count - 1]].first){
+            const uint32_t stmt = nested.elems[--nested.count];
+            ok = check_node(sem, entries[stmt].node);
+            iter.next = entries + stmt + 1;
+            continue;
+        }
+        ok = check_expr_node(sem, entry->node);
+    }
+
+    nodes_free(NULL, &nested);
+    return ok;
+}
 
-    // check both operands
-    if(!check_node(sem, node->binop->left)) return false;
-    if(!check_node(sem, node->binop->right)) return false;
+bool check_binop(semantic_t* sem, const node_id_t id)
+{
+    const node_t* node = get_node(sem, id, NODE_BINOP);
+    if(!node) return false;
 
-    // infer types
-    type_t* left_type = infer_type(sem, node->binop->left);
-    type_t* right_type = infer_type(sem, node->binop->right);
+    // the operands were checked before, infer their types
+    type_t* left_type = infer_type(sem, node->binop.left);
+    type_t* right_type = infer_type(sem, node->binop.right);
 
     if(!left_type || left_type == type_error || !right_type || right_type == type_error){
         return false;
@@ -451,19 +547,22 @@ bool check_binop(semantic_t* sem, node_t* node)
     return true;
 }
 
-bool check_unaryop(semantic_t* sem, node_t* node)
+bool check_unaryop(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_UNARYOP) return false;
+    const node_t* node = get_node(sem, id, NODE_UNARYOP);
+    if(!node) return false;
 
-    return check_node(sem, node->unaryop->right);
+    // the operand was checked before
+    return true;
 }
 
-bool check_func_call(semantic_t* sem, node_t* node)
+bool check_func_call(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_CALL) return false;
+    const node_t* node = get_node(sem, id, NODE_CALL);
+    if(!node) return false;
 
     // lookup function
-    symbol_t* func_sym = lookup_symbol(sem->symbols, node->func_call->name.data);
+    symbol_t* func_sym = lookup_symbol(sem->symbols, node->func_call.name);
     if(!func_sym){
         add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_UNDEC_FUNC, node->loc);
         return false;
@@ -475,22 +574,19 @@ bool check_func_call(semantic_t* sem, node_t* node)
         return false;
     }
 
-    for(size_t i = 0; i < node->func_call->args.count; i++){
-        if(!check_node(sem, node->func_call->args.elems[i])) return false;
-    }
-
     // TODO: check argument count and types match parameters
 
     func_sym->flags |= SYM_FLAG_USED;
     return true;
 }
 
-bool check_var_ref(semantic_t* sem, node_t* node)
+bool check_var_ref(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_REFERENCE) return false;
+    const node_t* node = get_node(sem, id, NODE_REFERENCE);
+    if(!node) return false;
 
-    const char* name = node->var_ref->name.data;
-    if(!name) return false;
+    const atom_t name = node->var_ref.name;
+    if(name == ATOM_NONE) return false;
 
     // lookup variable
     symbol_t* sym = lookup_symbol(sem->symbols, name);
@@ -504,43 +600,41 @@ bool check_var_ref(semantic_t* sem, node_t* node)
     return true;
 }
 
-bool check_literal(semantic_t* sem, node_t* node)
+bool check_literal(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_LITERAL) return false;
+    const node_t* node = get_node(sem, id, NODE_LITERAL);
+    if(!node) return false;
     // literals are always valid
     return true;
 }
 
-bool check_array(semantic_t* sem, node_t* node)
+bool check_array(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_ARRAY) return false;
-
-    for(size_t i = 0; i < node->array_decl->count; i++){
-        if(!check_node(sem, node->array_decl->elements[i])){
-            return false;
-        }
-    }
+    const node_t* node = get_node(sem, id, NODE_ARRAY);
+    if(!node) return false;
 
+    // the elements were checked before
     return true;
 }
 
-bool check_struct(semantic_t* sem, node_t* node)
+bool check_struct(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_STRUCT) return false;
+    const node_t* node = get_node(sem, id, NODE_STRUCT);
+    if(!node) return false;
 
-    struct node_struct* struct_decl = node->struct_decl;
-    if(!struct_decl || !struct_decl->name.data) return false;
+    const struct node_struct* struct_decl = &node->struct_decl;
+    if(!struct_decl->name) return false;
 
     // register struct symbol in declare phase
     if(sem->phase == PHASE_DECLARE){
-        if(is_scope_symbol_exist(sem->symbols, struct_decl->name.data)){
+        if(is_scope_symbol_exist(sem->symbols, struct_decl->name)){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_VAR_ALREADY_DECL, node->loc);
             return false;
         }
 
         // create struct type (will be populated in check phase)
-        type_t* struct_type = new_type_compound(sem->ctx->memory.phase_arena, TYPE_STRUCT, NULL, 0);
-        symbol_t* struct_sym = define_symbol(sem->symbols, struct_decl->name.data, SYMBOL_STRUCT, struct_type, node);
+        type_t* struct_type = new_type_compound(&sem->types, TYPE_STRUCT, NULL, 0);
+        symbol_t* struct_sym = define_symbol(sem->symbols, struct_decl->name, SYMBOL_STRUCT, struct_type, id);
         if(!struct_sym){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_VAR, node->loc);
             return false;
@@ -549,31 +643,32 @@ bool check_struct(semantic_t* sem, node_t* node)
     }
 
     // check struct members
-    symbol_t* struct_sym = lookup_symbol(sem->symbols, struct_decl->name.data);
+    symbol_t* struct_sym = lookup_symbol(sem->symbols, struct_decl->name);
     if(!struct_sym) return false;
 
-    scope_t* struct_scope = push_scope(sem->symbols, SCOPE_STRUCT, node);
+    scope_t* struct_scope = push_scope(sem->symbols, SCOPE_STRUCT, id);
     if(!struct_scope) return false;
 
     bool success = true;
     size_t member_count = 0;
 
+    const node_id_t* members = ast_list(sem->ast, struct_decl->member);
     for(size_t i = 0; i < struct_decl->member.count; i++){
-        node_t* member = struct_decl->member.elems[i];
+        const node_t* member = get_node(sem, members[i], NODE_ANY);
         if(!member || member->kind != NODE_VARIABLE) {
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_INVAL_EXPR, member ? member->loc : node->loc);
             success = false;
             continue;
         }
 
-        struct node_variable* var = member->var_decl;
-        if(!var || !var->name.data) {
+        const struct node_variable* var = &member->var_decl;
+        if(!var->name) {
             success = false;
             continue;
         }
 
         // check for duplicate member names
-        if(is_scope_symbol_exist(sem->symbols, var->name.data)){
+        if(is_scope_symbol_exist(sem->symbols, var->name)){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_VAR_ALREADY_DECL, member->loc);
             success = false;
             continue;
@@ -604,7 +699,7 @@ bool check_struct(semantic_t* sem, node_t* node)
         }
 
         // create member symbol
-        symbol_t* member_sym = define_symbol(sem->symbols, var->name.data, SYMBOL_VAR, member_type, member);
+        symbol_t* member_sym = define_symbol(sem->symbols, var->name, SYMBOL_VAR, member_type, members[i]);
         if(!member_sym) {
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_VAR, member->loc);
             success = false;
@@ -625,23 +720,24 @@ bool check_struct(semantic_t* sem, node_t* node)
     return success;
 }
 
-bool check_enum(semantic_t* sem, node_t* node)
+bool check_enum(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node || node->kind != NODE_ENUM) return false;
+    const node_t* node = get_node(sem, id, NODE_ENUM);
+    if(!node) return false;
 
-    struct node_enum* enum_decl = node->enum_decl;
-    if(!enum_decl || !enum_decl->name.data) return false;
+    const struct node_enum* enum_decl = &node->enum_decl;
+    if(!enum_decl->name) return false;
 
     // register enum symbol in declare phase
     if(sem->phase == PHASE_DECLARE){
-        if(is_scope_symbol_exist(sem->symbols, enum_decl->name.data)){
+        if(is_scope_symbol_exist(sem->symbols, enum_decl->name)){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_VAR_ALREADY_DECL, node->loc);
             return false;
         }
 
         // create enum type
-        type_t* enum_type = new_type_compound(sem->ctx->memory.phase_arena, TYPE_ENUM, NULL, 0);
-        symbol_t* enum_sym = define_symbol(sem->symbols, enum_decl->name.data, SYMBOL_ENUM, enum_type, node);
+        type_t* enum_type = new_type_compound(&sem->types, TYPE_ENUM, NULL, 0);
+        symbol_t* enum_sym = define_symbol(sem->symbols, enum_decl->name, SYMBOL_ENUM, enum_type, id);
         if(!enum_sym){
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_VAR, node->loc);
             return false;
@@ -650,43 +746,52 @@ bool check_enum(semantic_t* sem, node_t* node)
     }
 
     // check enum variants
-    symbol_t* enum_sym = lookup_symbol(sem->symbols, enum_decl->name.data);
+    symbol_t* enum_sym = lookup_symbol(sem->symbols, enum_decl->name);
     if(!enum_sym) return false;
 
-    scope_t* enum_scope = push_scope(sem->symbols, SCOPE_ENUM, node);
+    scope_t* enum_scope = push_scope(sem->symbols, SCOPE_ENUM, id);
     if(!enum_scope) return false;
 
     bool success = true;
     size_t variant_count = 0;
     int next_value = 0; // auto-increment values
 
+    const node_id_t* members = ast_list(sem->ast, enum_decl->member);
     for(size_t i = 0; i < enum_decl->member.count; i++){
-        node_t* member = enum_decl->member.elems[i];
+        const node_t* member = get_node(sem, members[i], NODE_ANY);
         if(!member) {
             success = false;
             continue;
         }
 
-        const char* variant_name = NULL;
+        atom_t variant_name = ATOM_NONE;
         int variant_value = next_value;
 
         // handle different enum member formats
-        if(member->kind == NODE_VARIABLE && member->var_decl) {
-            variant_name = member->var_decl->name.data;
-            if(member->var_decl->value) {
+        if(member->kind == NODE_VARIABLE) {
+            variant_name = member->var_decl.name;
+            if(member->var_decl.value) {
                 // explicit value assignment
-                if(member->var_decl->value->kind == NODE_LITERAL) {
-                    variant_value = atoi(member->var_decl->value->lit->value.data);
+                const node_t* value = get_node(sem, member->var_decl.value, NODE_ANY);
+                if(value->kind == NODE_LITERAL) {
+                    const struct node_literal* lit = &value->lit;
+                    if(lit->constant != CONST_NONE){
+                        const constant_t constant = get_constant(&sem->ctx->literals, lit->constant);
+                        variant_value = constant.kind == CONST_FLOAT ? (int)constant.real : (int)constant.integer;
+                    }
+                    else {
+                        variant_value = atoi(sp_atom_str(sem->ast->names, lit->value).data);
+                    }
                 }
                 else {
-                    add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_INVAL_EXPR, member->var_decl->value->loc);
+                    add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_INVAL_EXPR, value->loc);
                     success = false;
                     continue;
                 }
             }
         }
-        else if(member->kind == NODE_REFERENCE && member->var_ref) {
-            variant_name = member->var_ref->name.data;
+        else if(member->kind == NODE_REFERENCE) {
+            variant_name = member->var_ref.name;
         }
         else {
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_INVAL_EXPR, member->loc);
@@ -694,7 +799,7 @@ bool check_enum(semantic_t* sem, node_t* node)
             continue;
         }
 
-        if(!variant_name) {
+        if(variant_name == ATOM_NONE) {
             success = false;
             continue;
         }
@@ -707,7 +812,7 @@ bool check_enum(semantic_t* sem, node_t* node)
         }
 
         // create variant symbol with int type
-        symbol_t* variant_sym = define_symbol(sem->symbols, variant_name, SYMBOL_ENUM_VARIANT, type_int, member);
+        symbol_t* variant_sym = define_symbol(sem->symbols, variant_name, SYMBOL_ENUM_VARIANT, type_int, members[i]);
         if(!variant_sym) {
             add_report(sem->ctx->reports, sem->ctx->src_manager.current, SEV_ERR, ERR_FAIL_TO_DECL_VAR, member->loc);
             success = false;
@@ -730,15 +835,17 @@ bool check_enum(semantic_t* sem, node_t* node)
 }
 
 
-type_t* infer_type(semantic_t* sem, node_t* node)
+type_t* infer_type(semantic_t* sem, const node_id_t id)
 {
-    if(!sem || !node) return type_error;
+    const node_t* node = get_node(sem, id, NODE_ANY);
+    if(!node) return type_error;
 
     switch(node->kind){
         case NODE_LITERAL:
-            switch(node->lit->type){
+            switch(node->lit.type){
                 case LIT_NUMBER:
                 case LIT_BIN:
+                case LIT_OCT:
                 case LIT_HEX:
                     return type_int;
                 case LIT_FLOAT:
@@ -755,12 +862,12 @@ type_t* infer_type(semantic_t* sem, node_t* node)
             }
 
         case NODE_REFERENCE: {
-            symbol_t* sym = lookup_symbol(sem->symbols, node->var_ref->name.data);
+            symbol_t* sym = lookup_symbol(sem->symbols, node->var_ref.name);
             return sym ? sym->type : type_error;
         }
 
         case NODE_CALL: {
-            symbol_t* func = lookup_symbol(sem->symbols, node->func_call->name.data);
+            symbol_t* func = lookup_symbol(sem->symbols, node->func_call.name);
             if(func && func->type && func->type->kind == TYPE_FUNC){
                 return func->type->func.return_type;
             }
@@ -771,22 +878,22 @@ type_t* infer_type(semantic_t* sem, node_t* node)
     }
 }
 
-bool check_type_compatibility(semantic_t* sem, node_t* node, type_t* expected, type_t* actual)
+bool check_type_compatibility(semantic_t* sem, const node_id_t id, type_t* expected, type_t* actual)
 {
-    if(!sem || !node || !expected || !actual) return false;
+    if(!sem || !id || !expected || !actual) return false;
     return types_compatible(expected, actual);
 }
 
-bool all_paths_return(node_t* node)
+bool all_paths_return(const node_id_t id)
 {
     // TODO: implement control flow analysis
-    (void)node;
+    (void)id;
     return true;
 }
 
-bool is_unreachable_code(node_t* node)
+bool is_unreachable_code(const node_id_t id)
 {
     // TODO: implement unreachable code detection
-    (void)node;
+    (void)id;
     return false;
 }
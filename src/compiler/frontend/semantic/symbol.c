@@ -4,13 +4,13 @@
 #define INITIAL_SCOPE_CAPACITY 16
 #define SYMBOL_TABLE_SIZE 64
 
-static symbol_t* lookup_in_scope(scope_t* scope, const char* name);
+static symbol_t* lookup_in_scope(scope_t* scope, const atom_t name);
 
-scope_t* new_scope(arena_t* arena, int kind, node_t* owner)
+scope_t* new_scope(scope_pool_t* pool, int kind, const node_id_t owner)
 {
-    if(!arena) return NULL;
+    if(!pool) return NULL;
 
-    scope_t* scope = arena_alloc(arena, sizeof(scope_t), alignof(scope_t));
+    scope_t* scope = scope_pool_alloc(pool);
     if(!scope) return NULL;
 
     scope->parent = NULL;
@@ -24,7 +24,10 @@ scope_t* new_scope(arena_t* arena, int kind, node_t* owner)
     scope->depth = 0;
 
     scope->symbols = new_hashmap();
-    if(!scope->symbols) return NULL;
+    if(!scope->symbols){
+        scope_pool_release(pool, scope);
+        return NULL;
+    }
 
     return scope;
 }
@@ -33,8 +36,12 @@ symbol_table_t* new_symbol_table(compiler_context_t* ctx)
 {
     symbol_table_t* st = arena_alloc(ctx->memory.perm_arena, sizeof(symbol_table_t), alignof(symbol_table_t));
     if(!st) return NULL;
+    st->ctx = ctx;
+
+    st->symbol_pool = new_symbol_pool(ctx->memory.perm_arena);
+    st->scope_pool = new_scope_pool(ctx->memory.perm_arena);
 
-    st->global = new_scope(st->ctx->memory.perm_arena, SCOPE_GLOBAL, NULL);
+    st->global = new_scope(&st->scope_pool, SCOPE_GLOBAL, NODE_NONE);
     if(!st->global) return NULL;
 
     st->current = st->global;
@@ -44,11 +51,11 @@ symbol_table_t* new_symbol_table(compiler_context_t* ctx)
     return st;
 }
 
-scope_t* push_scope(symbol_table_t* st, int scope_kind, node_t* owner)
+scope_t* push_scope(symbol_table_t* st, int scope_kind, const node_id_t owner)
 {
     if(!st) return NULL;
 
-    scope_t* scope = new_scope(st->ctx->memory.perm_arena, scope_kind, owner);
+    scope_t* scope = new_scope(&st->scope_pool, scope_kind, owner);
     if(!scope) return NULL;
 
     scope->parent = st->current;
@@ -100,28 +107,26 @@ scope_t* current_scope(symbol_table_t* st)
     return st ? st->current : NULL;
 }
 
-symbol_t* define_symbol(symbol_table_t* st, const char* name, const enum symbol_kind kind, type_t* type, node_t* decl_node)
+symbol_t* define_symbol(symbol_table_t* st, const atom_t name, const enum symbol_kind kind, type_t* type, const node_id_t decl_node)
 {
-    if(!st || !name) return NULL;
+    if(!st || name == ATOM_NONE) return NULL;
 
     scope_t* scope = st->current;
     if(!scope) return NULL;
     if(lookup_in_scope(scope, name) != NULL) return NULL;
 
-    symbol_t* sym = arena_alloc(st->ctx->memory.perm_arena, sizeof(symbol_t), alignof(symbol_t));
+    symbol_t* sym = symbol_pool_alloc(&st->symbol_pool);
     if(!sym) return NULL;
 
-    string_t interned = new_string(&st->ctx->memory.perm_strings, name);
-    if(!interned.data) return NULL;
-    sym->name = (char*)interned.data;
+    sym->name = name;
 
     sym->kind = kind;
     sym->type = type;
     sym->declared_type = NULL;
     sym->flags = SYM_FLAG_NONE;
     sym->decl_node = decl_node;
-    sym->init_node = NULL;
-    sym->loc = decl_node ? decl_node->loc : new_location();
+    sym->init_node = NODE_NONE;
+    sym->loc = decl_node && st->ctx->ast ? ast_node(st->ctx->ast, decl_node)->loc : new_location();
     sym->scope = scope;
     sym->next_in_scope = NULL;
     sym->shadowed_symbol = NULL;
@@ -131,22 +136,22 @@ symbol_t* define_symbol(symbol_table_t* st, const char* name, const enum symbol_
         sym->flags |= SYM_FLAG_GLOBAL;
     }
 
-    hm_insert(scope->symbols, sym->name, sym);
+    hm_insert_atom(scope->symbols, sym->name, sym);
     scope->count += 1;
 
     return sym;
 }
 
-static symbol_t* lookup_in_scope(scope_t* scope, const char* name)
+static symbol_t* lookup_in_scope(scope_t* scope, const atom_t name)
 {
-    if(!scope || !name) return NULL;
+    if(!scope || name == ATOM_NONE) return NULL;
 
-    return hm_lookup(scope->symbols, name);
+    return hm_lookup_atom(scope->symbols, name);
 }
 
-symbol_t* lookup_symbol(symbol_table_t* st, const char* name)
+symbol_t* lookup_symbol(symbol_table_t* st, const atom_t name)
 {
-    if(!st || !name) return NULL;
+    if(!st || name == ATOM_NONE) return NULL;
 
     scope_t* scope = st->current;
     while(scope){
@@ -158,9 +163,9 @@ symbol_t* lookup_symbol(symbol_table_t* st, const char* name)
     return NULL;
 }
 
-bool is_scope_symbol_exist(symbol_table_t* st, const char* name)
+bool is_scope_symbol_exist(symbol_table_t* st, const atom_t name)
 {
-    if(!st || !name) return false;
+    if(!st || name == ATOM_NONE) return false;
     return lookup_in_scope(st->current, name) != NULL;
 }
 
@@ -176,6 +181,49 @@ bool is_symbol_initialized(const symbol_t* sym)
     return (sym->flags & SYM_FLAG_ASSIGNED) != 0;
 }
 
+void release_symbol(symbol_table_t* st, symbol_t* sym)
+{
+    if(!st || !sym) return;
+
+    scope_t* scope = sym->scope;
+    if(scope && hm_lookup_atom(scope->symbols, sym->name) == sym){
+        hm_delete_atom(scope->symbols, sym->name);
+        scope->count -= 1;
+    }
+
+    symbol_pool_release(&st->symbol_pool, sym);
+}
+
+void release_scope(symbol_table_t* st, scope_t* scope)
+{
+    if(!st || !scope || scope == st->global) return;
+
+    // unlink from the parent first, pop_scope may have done it already
+    if(scope->parent){
+        scope_t** link = &scope->parent->first_child;
+        while(*link && *link != scope) link = &(*link)->next_sibling;
+        if(*link) *link = scope->next_sibling;
+    }
+    if(st->current == scope) st->current = scope->parent;
+
+    while(scope->first_child){
+        scope_t* child = scope->first_child;
+        scope->first_child = child->next_sibling;
+        child->parent = NULL;
+        release_scope(st, child);
+    }
+
+    void* value;
+    hm_iter_t it = hm_iter(scope->symbols);
+    while(hm_next(&it, NULL, &value)){
+        symbol_pool_release(&st->symbol_pool, value);
+    }
+    free_hashmap(scope->symbols);
+
+    scope_pool_release(&st->scope_pool, scope);
+    st->scope_count -= 1;
+}
+
 void free_scope(scope_t* scope)
 {
     if(!scope) return;
@@ -195,7 +243,7 @@ void free_scope(scope_t* scope)
     scope->parent = NULL;
     scope->first_child = NULL;
     scope->next_sibling = NULL;
-    scope->owner = NULL;
+    scope->owner = NODE_NONE;
 }
 
 void free_symbol_table(symbol_table_t* st)
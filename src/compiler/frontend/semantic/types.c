@@ -1,4 +1,6 @@
-#include "compiler/frontend/semantic/types.h"   // type_t, enum type_kind
+#include <string.h>
+
+#include "compiler/frontend/semantic/types.h"   // type_t, enum type_kind, type_pool_t
 
 #define DEF_TYPE_SIZE  0
 #define DEF_TYPE_ALIGN 1
@@ -19,38 +21,39 @@ type_t* type_decimal = NULL;
 type_t* type_str = NULL;
 type_t* type_char = NULL;
 
-type_t* new_type(arena_t* arena, const enum type_kind kind, const size_t size, const size_t align)
+type_t* new_type(type_pool_t* pool, const enum type_kind kind, const size_t size, const size_t align)
 {
-    type_t* type = arena_alloc_default(arena, sizeof(type_t));
+    type_t* type = type_pool_alloc(pool);
     if(!type) return NULL;
+    memset(type, 0, sizeof(type_t));
     type->kind = kind;
     type->size = size;
     type->align = align;
     return type;
 }
 
-void init_types(arena_t* arena)
+void init_types(type_pool_t* pool)
 {
-    type_unknown = new_type(arena, TYPE_UNKNOWN, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
-    type_error =   new_type(arena, TYPE_ERROR,   DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
-    type_void =    new_type(arena, TYPE_VOID,    DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
-    type_any =     new_type(arena, TYPE_ANY,   sizeof(void*), alignof(void*));
-    type_bool =    new_type(arena, TYPE_BOOL,  sizeof(bool),  alignof(bool));
-    type_int =     new_type(arena, TYPE_INT,   sizeof(int),   alignof(int));
-    type_uint =    new_type(arena, TYPE_UINT,  sizeof(unsigned int), alignof(unsigned int));
-    type_short =   new_type(arena, TYPE_INT,   sizeof(short), alignof(short));
-    type_ushort =  new_type(arena, TYPE_UINT,  sizeof(unsigned short), alignof(unsigned short));
-    type_long =    new_type(arena, TYPE_INT,   sizeof(long),  alignof(long));
-    type_ulong =   new_type(arena, TYPE_UINT,  sizeof(unsigned long), alignof(unsigned long));
-    type_float =   new_type(arena, TYPE_FLOAT, sizeof(float), alignof(float));
-    type_decimal = new_type(arena, TYPE_FLOAT, sizeof(long),  alignof(long));
-    type_str =     new_type(arena, TYPE_STR,   sizeof(char*), alignof(char*));
-    type_char =    new_type(arena, TYPE_CHAR,  sizeof(char),  alignof(char));
+    type_unknown = new_type(pool, TYPE_UNKNOWN, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
+    type_error =   new_type(pool, TYPE_ERROR,   DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
+    type_void =    new_type(pool, TYPE_VOID,    DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
+    type_any =     new_type(pool, TYPE_ANY,   sizeof(void*), alignof(void*));
+    type_bool =    new_type(pool, TYPE_BOOL,  sizeof(bool),  alignof(bool));
+    type_int =     new_type(pool, TYPE_INT,   sizeof(int),   alignof(int));
+    type_uint =    new_type(pool, TYPE_UINT,  sizeof(unsigned int), alignof(unsigned int));
+    type_short =   new_type(pool, TYPE_INT,   sizeof(short), alignof(short));
+    type_ushort =  new_type(pool, TYPE_UINT,  sizeof(unsigned short), alignof(unsigned short));
+    type_long =    new_type(pool, TYPE_INT,   sizeof(long),  alignof(long));
+    type_ulong =   new_type(pool, TYPE_UINT,  sizeof(unsigned long), alignof(unsigned long));
+    type_float =   new_type(pool, TYPE_FLOAT, sizeof(float), alignof(float));
+    type_decimal = new_type(pool, TYPE_FLOAT, sizeof(long),  alignof(long));
+    type_str =     new_type(pool, TYPE_STR,   sizeof(char*), alignof(char*));
+    type_char =    new_type(pool, TYPE_CHAR,  sizeof(char),  alignof(char));
 }
 
-type_t* new_type_array(arena_t* arena, type_t* elem_type, const size_t length)
+type_t* new_type_array(type_pool_t* pool, type_t* elem_type, const size_t length)
 {
-    type_t* type = new_type(arena, TYPE_ARRAY, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
+    type_t* type = new_type(pool, TYPE_ARRAY, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
     if(!type) return NULL;
 
     type->array.elem_type = elem_type;
@@ -68,9 +71,9 @@ type_t* new_type_array(arena_t* arena, type_t* elem_type, const size_t length)
     return type;
 }
 
-type_t* new_type_function(arena_t* arena, type_t* return_type, type_t** param_types, const size_t param_count)
+type_t* new_type_function(type_pool_t* pool, type_t* return_type, type_t** param_types, const size_t param_count)
 {
-    type_t* type = new_type(arena, TYPE_FUNC, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
+    type_t* type = new_type(pool, TYPE_FUNC, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
     if(!type) return NULL;
 
     type->func.return_type = return_type;
@@ -89,9 +92,9 @@ type_t* new_type_function(arena_t* arena, type_t* return_type, type_t** param_ty
     return type;
 }
 
-type_t* new_type_compound(arena_t* arena, enum type_kind kind, struct symbol* scope, const size_t member_count)
+type_t* new_type_compound(type_pool_t* pool, enum type_kind kind, struct symbol* scope, const size_t member_count)
 {
-    type_t* type = new_type(arena, kind, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
+    type_t* type = new_type(pool, kind, DEF_TYPE_SIZE, DEF_TYPE_ALIGN);
     if(!type) return NULL;
     type->compound.scope = scope;
     type->compound.member_count = member_count;
@@ -200,24 +203,14 @@ bool is_signed_type(const type_t* type)
         || type->kind == TYPE_FLOAT;
 }
 
-void free_type(type_t* type)
+void free_type(type_pool_t* pool, type_t* type)
 {
     if(!type) return;
 
-    switch(type->kind){
-        case TYPE_ARRAY:
-            break;
-
-        case TYPE_FUNC:
-            break;
-
-        case TYPE_STRUCT:
-            break;
-
-        default: break;
-    }
-
+    // element, return and parameter types are shared, only the record goes back
     type->kind = TYPE_UNKNOWN;
     type->size = DEF_TYPE_SIZE;
     type->align = DEF_TYPE_ALIGN;
+
+    type_pool_release(pool, type);
 }
@@ -1,31 +1,145 @@
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, madvise
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
 
 #include "core/ds/arena.h"
+#include "core/platform/unix.h"     // mmap, mprotect, madvise
+#include "core/platform/windows.h"  // VirtualAlloc, VirtualFree
+
+#if defined(_WIN32) || defined(_WIN64)
+static SRWLOCK cache_lock = SRWLOCK_INIT;
+#define cache_acquire() AcquireSRWLockExclusive(&cache_lock)
+#define cache_release() ReleaseSRWLockExclusive(&cache_lock)
+#else
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#define cache_acquire() pthread_mutex_lock(&cache_lock)
+#define cache_release() pthread_mutex_unlock(&cache_lock)
+#endif
+
+#define SCRATCH_COUNT 2
+
+// per-thread scratch arenas, created on first use
+static __thread arena_t* scratch_arenas[SCRATCH_COUNT];
+
+// process-wide list of freed blocks, shared by every arena
+static arena_block_t* block_cache = NULL;
+static size_t block_cache_size = 0;
 
 static arena_block_t* new_arena_block(size_t capacity)
 {
     if(capacity == 0) return NULL;
-    arena_block_t* b = malloc(sizeof(arena_block_t));
-    if(!b) return NULL;
-    b->data = malloc(capacity);
-    if(!b->data){
-        free(b);
-        return NULL;
+
+    // best fit from the cache, a block never gets more than twice the request
+    cache_acquire();
+    arena_block_t** best = NULL;
+    for(arena_block_t** it = &block_cache; *it; it = &(*it)->next){
+        const size_t cap = (*it)->capacity;
+        if(cap >= capacity && cap / 2 <= capacity && (!best || cap < (*best)->capacity)){
+            best = it;
+            if(cap == capacity) break;
+        }
     }
+    arena_block_t* b = NULL;
+    if(best){
+        b = *best;
+        *best = b->next;
+        block_cache_size -= b->capacity;
+    }
+    cache_release();
+
+    if(!b){
+        // header and data share one allocation
+        b = malloc(sizeof(arena_block_t) + capacity);
+        if(!b) return NULL;
+        b->data = (unsigned char*)(b + 1);
+        b->capacity = capacity;
+    }
+
     b->offset = 0;
-    b->capacity = capacity;
     b->next = NULL;
     return b;
 }
 
+static void free_arena_block(arena_block_t* b)
+{
+    cache_acquire();
+    if(block_cache_size + b->capacity <= ARENA_CACHE_SIZE){
+        b->next = block_cache;
+        block_cache = b;
+        block_cache_size += b->capacity;
+        b = NULL;
+    }
+    cache_release();
+
+    free(b);
+}
+
 static inline bool is_power_of_two(size_t n)
 {
     return n && !(n & (n - 1));
 }
 
+static inline size_t align_up(size_t n, size_t align)
+{
+    return (n + align - 1) & ~(align - 1);
+}
+
+static void* vm_reserve(size_t size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+#endif
+}
+
+static bool vm_commit(void* ptr, size_t size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+// drops the pages but keeps them committed, they read back as zero
+static void vm_reset(void* ptr, size_t size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    VirtualAlloc(ptr, size, MEM_RESET, PAGE_READWRITE);
+#else
+    madvise(ptr, size, MADV_DONTNEED);
+#endif
+}
+
+static void vm_release(void* ptr, size_t size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+static bool vm_grow(arena_t* arena, size_t need)
+{
+    arena_block_t* b = arena->head;
+    if(need <= b->capacity) return true;
+    if(need > arena->reserved) return false;
+
+    size_t new_capacity = align_up(need, arena->commit_step);
+    if(new_capacity > arena->reserved) new_capacity = arena->reserved;
+
+    if(!vm_commit(b->data + b->capacity, new_capacity - b->capacity)) return false;
+    b->capacity = new_capacity;
+    return true;
+}
+
 arena_t* new_arena(size_t capacity)
 {
     if(capacity == 0) return NULL;
@@ -41,6 +155,50 @@ arena_t* new_arena(size_t capacity)
 
     arena->head = b;
     arena->current = b;
+    arena->reserved = 0;
+    arena->commit_step = 0;
+    return arena;
+}
+
+arena_t* new_vm_arena(size_t reserve, bool huge_pages)
+{
+    const size_t step = huge_pages ? ARENA_VM_HUGE : ARENA_VM_COMMIT;
+    reserve = align_up(reserve, step);
+    if(reserve == 0) return NULL;
+
+    arena_t* arena = malloc(sizeof(arena_t));
+    if(!arena) return NULL;
+
+    arena_block_t* b = malloc(sizeof(arena_block_t));
+    if(!b){
+        free(arena);
+        return NULL;
+    }
+
+    b->data = vm_reserve(reserve);
+    if(!b->data){
+        free(b);
+        free(arena);
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if(huge_pages) madvise(b->data, reserve, MADV_HUGEPAGE);
+#endif
+
+    b->offset = 0;
+    b->capacity = 0;
+    b->next = NULL;
+
+    arena->head = b;
+    arena->current = b;
+    arena->reserved = reserve;
+    arena->commit_step = step;
+
+    if(!vm_grow(arena, step)){
+        free_arena(arena);
+        return NULL;
+    }
     return arena;
 }
 
@@ -49,13 +207,19 @@ void free_arena(arena_t* arena)
     if(!arena) return;
 
     arena_block_t* b = arena->head;
-    while(b){
+    if(arena->reserved && b){
+        vm_release(b->data, arena->reserved);
         arena_block_t* next = b->next;
-        if(b->data) free(b->data);
         free(b);
         b = next;
     }
 
+    while(b){
+        arena_block_t* next = b->next;
+        free_arena_block(b);
+        b = next;
+    }
+
     arena->head = NULL;
     arena->current = NULL;
     free(arena);
@@ -64,11 +228,17 @@ void free_arena(arena_t* arena)
 bool arena_expand(arena_t* arena, size_t new_capacity)
 {
     if(!arena || !arena->current) return false;
+
+    // virtual memory arenas stay contiguous, commit the extra space instead
+    if(arena->reserved) return vm_grow(arena, arena->head->offset + new_capacity);
+
     if(new_capacity <= arena->current->capacity) return false;
 
     arena_block_t* b = new_arena_block(new_capacity);
     if(!b) return false;
 
+    // keep the blocks released by a rewind after the new one
+    b->next = arena->current->next;
     arena->current->next = b;
     arena->current = b;
     return true;
@@ -80,7 +250,7 @@ bool arena_has_space(arena_t* arena, size_t size, size_t align)
     return ((arena->current->offset + (align - 1)) & ~(align - 1)) + size <= arena->current->capacity;
 }
 
-void* arena_alloc(arena_t* arena, size_t size, size_t alignment)
+void* arena_alloc_uninit(arena_t* arena, size_t size, size_t alignment)
 {
     if(!arena || size == 0 || alignment == 0) return NULL;
 
@@ -91,7 +261,18 @@ void* arena_alloc(arena_t* arena, size_t size, size_t alignment)
 
     size_t aligned_offset = (b->offset + alignment - 1) & ~(alignment - 1);
 
-    if(aligned_offset + size > b->capacity){
+    // reuse the blocks released by a rewind first
+    while(aligned_offset + size > b->capacity && b->next){
+        b = b->next;
+        b->offset = 0;
+        arena->current = b;
+        aligned_offset = 0;
+    }
+
+    if(aligned_offset + size > b->capacity && arena->reserved){
+        if(!vm_grow(arena, aligned_offset + size)) return NULL;
+    }
+    else if(aligned_offset + size > b->capacity){
         size_t new_capacity = b->capacity ? (b->capacity * 2) : ARENA_DEF_SIZE;
         size_t need = size + (alignment - 1);
         if(new_capacity < need) new_capacity = need;
@@ -101,11 +282,22 @@ void* arena_alloc(arena_t* arena, size_t size, size_t alignment)
     }
 
     void* ptr = b->data + aligned_offset;
-    memset(ptr, 0, size);
     b->offset = aligned_offset + size;
     return ptr;
 }
 
+void* arena_alloc(arena_t* arena, size_t size, size_t alignment)
+{
+    return arena_alloc_uninit(arena, size, alignment);
+}
+
+void* arena_alloc_zeroed(arena_t* arena, size_t size, size_t alignment)
+{
+    void* ptr = arena_alloc_uninit(arena, size, alignment);
+    if(ptr) memset(ptr, 0, size);
+    return ptr;
+}
+
 void* arena_alloc_default(arena_t* arena, size_t size)
 {
     return arena_alloc(arena, size, alignof(void*));
@@ -117,6 +309,42 @@ void* arena_alloc_array(arena_t* arena, size_t elem_size, size_t count, size_t a
     return arena_alloc(arena, elem_size * count, align);
 }
 
+void* arena_push_bytes(arena_t* arena, const void* src, size_t length)
+{
+    if(!src) return NULL;
+
+    void* ptr = arena_alloc_uninit(arena, length, alignof(void*));
+    if(ptr) memcpy(ptr, src, length);
+    return ptr;
+}
+
+bool arena_is_top(const arena_t* arena, const void* ptr, size_t size)
+{
+    if(!arena || !arena->current || !ptr) return false;
+    return (const unsigned char*)ptr + size == arena->current->data + arena->current->offset;
+}
+
+void* arena_resize(arena_t* arena, void* ptr, size_t old_size, size_t new_size, size_t alignment)
+{
+    if(!ptr || old_size == 0) return arena_alloc_uninit(arena, new_size, alignment);
+
+    if(arena_is_top(arena, ptr, old_size)){
+        arena_block_t* b = arena->current;
+        const size_t start = (size_t)((unsigned char*)ptr - b->data);
+        if(new_size <= old_size
+           || start + new_size <= b->capacity
+           || (arena->reserved && vm_grow(arena, start + new_size))){
+            b->offset = start + new_size;
+            return ptr;
+        }
+    }
+    if(new_size <= old_size) return ptr;
+
+    void* new_ptr = arena_alloc_uninit(arena, new_size, alignment);
+    if(new_ptr) memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
 void arena_clear(arena_t* arena)
 {
     if(!arena) return;
@@ -126,11 +354,89 @@ void arena_clear(arena_t* arena)
         b->offset = 0;
         b = b->next;
     }
+    arena->current = arena->head;
+
+    // hand everything past the first commit step back to the OS
+    if(arena->reserved && arena->head->capacity > arena->commit_step){
+        vm_reset(arena->head->data + arena->commit_step, arena->head->capacity - arena->commit_step);
+    }
+}
+
+arena_mark_t arena_mark(arena_t* arena)
+{
+    if(!arena || !arena->current) return (arena_mark_t){0};
+    return (arena_mark_t){arena->current, arena->current->offset};
+}
+
+void arena_rewind(arena_t* arena, arena_mark_t mark)
+{
+    if(!arena || !mark.block) return;
+
+    // blocks past the mark stay in the chain and are refilled from the start
+    arena_block_t* b = mark.block->next;
+    while(b){
+        b->offset = 0;
+        b = b->next;
+    }
+
+    mark.block->offset = mark.offset;
+    arena->current = mark.block;
+}
+
+arena_scratch_t arena_scratch_begin(const arena_t* conflict)
+{
+    for(size_t i = 0; i < SCRATCH_COUNT; i++){
+        if(!scratch_arenas[i]){
+            scratch_arenas[i] = new_arena(ARENA_TEMP_SIZE);
+            if(!scratch_arenas[i]) return (arena_scratch_t){0};
+        }
+        if(scratch_arenas[i] == conflict) continue;
+
+        return (arena_scratch_t){scratch_arenas[i], arena_mark(scratch_arenas[i])};
+    }
+    return (arena_scratch_t){0};
+}
+
+void arena_scratch_end(arena_scratch_t scratch)
+{
+    arena_rewind(scratch.arena, scratch.mark);
+}
+
+void free_scratch_arenas(void)
+{
+    for(size_t i = 0; i < SCRATCH_COUNT; i++){
+        free_arena(scratch_arenas[i]);
+        scratch_arenas[i] = NULL;
+    }
+}
+
+size_t arena_cache_size(void)
+{
+    cache_acquire();
+    const size_t size = block_cache_size;
+    cache_release();
+    return size;
+}
+
+void free_arena_cache(void)
+{
+    cache_acquire();
+    arena_block_t* b = block_cache;
+    block_cache = NULL;
+    block_cache_size = 0;
+    cache_release();
+
+    while(b){
+        arena_block_t* next = b->next;
+        free(b);
+        b = next;
+    }
 }
 
 size_t arena_used(arena_t* arena)
 {
     if(!arena) return 0;
+    if(arena->reserved) return arena->head->offset;
 
     size_t total = 0;
     arena_block_t* b = arena->head;
@@ -144,6 +450,7 @@ size_t arena_used(arena_t* arena)
 size_t arena_capacity(arena_t* arena)
 {
     if(!arena) return 0;
+    if(arena->reserved) return arena->head->capacity;
 
     size_t total = 0;
     arena_block_t* b = arena->head;
@@ -5,119 +5,251 @@
 #include "core/ds/hashmap.h"
 #include "core/ds/strings.h"
 
+#define HASH_SEED   0x9e3779b97f4a7c15ull
+#define HASH_PRIME1 0xa0761d6478bd642full
+#define HASH_PRIME2 0xe7037ed1a0b428dbull
+
+static inline uint64_t read_u64(const unsigned char* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t read_u32(const unsigned char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t hash_round(uint64_t hash, uint64_t word)
+{
+    hash ^= word * HASH_PRIME1;
+    hash = (hash << 31) | (hash >> 33);
+    return hash * HASH_PRIME2;
+}
+
 uint32_t hm_hash(const char* str)
 {
-    uint32_t hash = 2166136261u;
-    for(size_t i = 0; str[i] != '\0'; i++){
-        hash ^= (uint8_t)str[i];
-        hash *= 16777619u;
+    return hm_hash_n(str, strlen(str));
+}
+
+// eight bytes per round, identifiers mostly finish in one or two
+uint32_t hm_hash_n(const char* str, size_t length)
+{
+    const unsigned char* p = (const unsigned char*)str;
+    uint64_t hash = HASH_SEED ^ (length * HASH_PRIME1);
+
+    while(length >= 8){
+        hash = hash_round(hash, read_u64(p));
+        p += 8;
+        length -= 8;
+    }
+
+    // the tail is read as two overlapping words, the length in the seed tells them apart
+    if(length >= 4){
+        hash = hash_round(hash, (read_u32(p) << 32) | read_u32(p + length - 4));
+    }
+    else if(length > 0){
+        hash = hash_round(hash, ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1]);
+    }
+
+    // final avalanche so the low bits used as the home slot depend on every byte
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return (uint32_t)hash;
+}
+
+// atom keys carry no bytes and match on the atom alone
+static inline string_t atom_key(atom_t atom)
+{
+    return (string_t){NULL, 0, atom * 2654435769u, atom};
+}
+
+static inline bool key_equal(const string_t* a, const string_t* b)
+{
+    if(!a->data || !b->data) return a->atom == b->atom && a->hash == b->hash;
+    return string_equal(*a, *b);
+}
+
+// robin hood placement: the entry with the longer probe distance keeps the slot
+static void hm_place(hm_slot_t* slots, size_t capacity, hm_slot_t entry)
+{
+    const size_t mask = capacity - 1;
+    size_t i = entry.key.hash & mask;
+    entry.dist = 1;
+
+    while(true){
+        hm_slot_t* slot = &slots[i];
+        if(slot->dist == 0){
+            *slot = entry;
+            return;
+        }
+        if(slot->dist < entry.dist){
+            hm_slot_t tmp = *slot;
+            *slot = entry;
+            entry = tmp;
+        }
+        i = (i + 1) & mask;
+        entry.dist++;
+    }
+}
+
+static bool hm_resize(hashmap_t* map, size_t new_capacity)
+{
+    hm_slot_t* slots = calloc(new_capacity, sizeof(hm_slot_t));
+    if(!slots) return false;
+
+    for(size_t i = 0; i < map->capacity; i++){
+        if(map->slots[i].dist != 0){
+            hm_place(slots, new_capacity, map->slots[i]);
+        }
     }
-    return hash;
+
+    free(map->slots);
+    map->slots = slots;
+    map->capacity = new_capacity;
+    return true;
+}
+
+static hm_slot_t* hm_find(const hashmap_t* map, const string_t* key)
+{
+    if(map->count == 0) return NULL;
+
+    const size_t mask = map->capacity - 1;
+    size_t i = key->hash & mask;
+
+    // an entry can't sit further from home than a poorer one it would have displaced
+    for(uint32_t dist = 1; map->slots[i].dist >= dist; dist++){
+        if(key_equal(&map->slots[i].key, key)) return &map->slots[i];
+        i = (i + 1) & mask;
+    }
+    return NULL;
 }
 
 hashmap_t* new_hashmap(void)
 {
     hashmap_t* map = malloc(sizeof(hashmap_t));
     if(!map) return NULL;
-    map->key = (string_t){NULL, 0, 0};
-    map->value = NULL;
-    map->next = NULL;
+    map->slots = NULL;  // allocated on the first insert, most block scopes stay empty
+    map->capacity = 0;
+    map->count = 0;
     return map;
 }
 
-void hm_insert(hashmap_t* map, const char* key, void* value)
+void free_hashmap(hashmap_t* map)
 {
-    if(!map || !key) return;
+    if(!map) return;
+    free(map->slots);
+    free(map);
+}
 
-    const string_t str = {key, strlen(key), hm_hash(key)};
+void hm_insert_str(hashmap_t* map, string_t key, void* value)
+{
+    if(!map || (!key.data && !key.atom)) return;
 
-    if(!map->key.data){
-        map->key = str;
-        map->value = value;
+    hm_slot_t* slot = hm_find(map, &key);
+    if(slot){
+        slot->value = value;
         return;
     }
 
-    hashmap_t* curr = map;
-    while(curr != NULL){
-        if(curr->key.data && curr->key.hash == str.hash){
-            if(strcmp(curr->key.data, str.data) == 0){
-                curr->value = value;
-                return;
-            }
-        }
-        if(curr->next == NULL) break;
-        curr = curr->next;
+    if((map->count + 1) * 8 > map->capacity * HM_MAX_LOAD){
+        size_t new_capacity = map->capacity ? map->capacity * 2 : HM_DEF_CAPACITY;
+        if(!hm_resize(map, new_capacity)) return;
     }
 
-    hashmap_t* new_entry = malloc(sizeof(hashmap_t));
-    if(!new_entry) return;
-    new_entry->key = str;
-    new_entry->value = value;
-    new_entry->next = NULL;
-    curr->next = new_entry;
+    hm_place(map->slots, map->capacity, (hm_slot_t){key, value, 0});
+    map->count++;
 }
 
-void* hm_lookup(hashmap_t* map, const char* key)
+void* hm_lookup_str(hashmap_t* map, string_t key)
 {
-    if(!map || !key) return NULL;
+    if(!map || (!key.data && !key.atom)) return NULL;
 
-    const string_t str = {key, strlen(key), hm_hash(key)};
+    hm_slot_t* slot = hm_find(map, &key);
+    return slot ? slot->value : NULL;
+}
 
-    while(map != NULL){
-        if(map->key.data && map->key.hash == str.hash){
-            if(strcmp(map->key.data, str.data) == 0){
-                return map->value;
-            }
-        }
-        map = map->next;
+bool hm_delete_str(hashmap_t* map, string_t key)
+{
+    if(!map || (!key.data && !key.atom)) return false;
+
+    hm_slot_t* slot = hm_find(map, &key);
+    if(!slot) return false;
+
+    // backward shift: pull the following run one slot closer to home
+    const size_t mask = map->capacity - 1;
+    size_t i = (size_t)(slot - map->slots);
+    size_t next = (i + 1) & mask;
+
+    while(map->slots[next].dist > 1){
+        map->slots[i] = map->slots[next];
+        map->slots[i].dist--;
+        i = next;
+        next = (next + 1) & mask;
     }
-    return NULL;
+
+    map->slots[i] = (hm_slot_t){0};
+    map->count--;
+    return true;
+}
+
+void hm_insert(hashmap_t* map, const char* key, void* value)
+{
+    if(!map || !key) return;
+    const size_t length = strlen(key);
+    hm_insert_str(map, (string_t){key, length, hm_hash_n(key, length), ATOM_NONE}, value);
+}
+
+void* hm_lookup(hashmap_t* map, const char* key)
+{
+    if(!map || !key) return NULL;
+    const size_t length = strlen(key);
+    return hm_lookup_str(map, (string_t){key, length, hm_hash_n(key, length), ATOM_NONE});
 }
 
 void hm_delete(hashmap_t* map, const char* key)
 {
     if(!map || !key) return;
+    const size_t length = strlen(key);
+    hm_delete_str(map, (string_t){key, length, hm_hash_n(key, length), ATOM_NONE});
+}
 
-    const string_t str = {key, strlen(key), hm_hash(key)};
+void hm_insert_atom(hashmap_t* map, atom_t key, void* value)
+{
+    hm_insert_str(map, atom_key(key), value);
+}
 
-    if(map->key.data && map->key.hash == str.hash){
-        if(map->next){
-            hashmap_t* next = map->next;
-            map->key = next->key;
-            map->value = next->value;
-            map->next = next->next;
-            free(next);
-        }
-        else {
-            map->key.data = NULL;
-            map->value = NULL;
-        }
-        return;
-    }
+void* hm_lookup_atom(hashmap_t* map, atom_t key)
+{
+    return hm_lookup_str(map, atom_key(key));
+}
 
-    hashmap_t* prev = map;
-    map = map->next;
+bool hm_delete_atom(hashmap_t* map, atom_t key)
+{
+    return hm_delete_str(map, atom_key(key));
+}
 
-    while(map != NULL){
-        if(map->key.data && map->key.hash == str.hash){
-            if(strcmp(map->key.data, str.data) == 0){
-                prev->next = map->next;
-                free(map);
-                return;
-            }
-        }
-        prev = map;
-        map = map->next;
-    }
+hm_iter_t hm_iter(const hashmap_t* map)
+{
+    return (hm_iter_t){map, 0};
 }
 
-void free_hashmap(hashmap_t* map)
+bool hm_next(hm_iter_t* it, string_t* key, void** value)
 {
-    if(!map) return;
-    hashmap_t* curr = map;
-    while(curr){
-        hashmap_t* next = curr->next;
-        free(curr);
-        curr = next;
+    if(!it || !it->map) return false;
+
+    while(it->index < it->map->capacity){
+        const hm_slot_t* slot = &it->map->slots[it->index++];
+        if(slot->dist == 0) continue;
+        if(key)   *key = slot->key;
+        if(value) *value = slot->value;
+        return true;
     }
+    return false;
 }
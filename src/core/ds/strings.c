@@ -13,6 +13,8 @@ string_pool_t new_string_pool(const size_t capacity)
     pool.capacity = 16;
     pool.elements = calloc(pool.capacity, sizeof(string_t));
     pool.count = 0;
+    pool.index = NULL;
+    pool.index_capacity = 0;
     return pool;
 }
 
@@ -21,22 +23,59 @@ void free_string_pool(string_pool_t* pool)
     if(!pool) return;
     if(pool->elements) free(pool->elements);
     pool->elements = NULL;
+    if(pool->index) free(pool->index);
+    pool->index = NULL;
     free_arena(pool->arena);
     pool->arena = NULL;
 }
 
+static bool grow_index(string_pool_t* pool)
+{
+    size_t new_capacity = pool->index_capacity ? pool->index_capacity * 2 : SP_INDEX_CAPACITY;
+    uint32_t* index = calloc(new_capacity, sizeof(uint32_t));
+    if(!index) return false;
+
+    const size_t mask = new_capacity - 1;
+    for(size_t i = 0; i < pool->count; i++){
+        size_t slot = pool->elements[i].hash & mask;
+        while(index[slot]) slot = (slot + 1) & mask;
+        index[slot] = (uint32_t)(i + 1);
+    }
+
+    free(pool->index);
+    pool->index = index;
+    pool->index_capacity = new_capacity;
+    return true;
+}
+
+// returns the index slot holding the string, or the empty slot where it belongs
+static size_t find_slot(const string_pool_t* pool, const char* str, const size_t length, const uint32_t hash)
+{
+    const string_t key = {str, length, hash, ATOM_NONE};
+    const size_t mask = pool->index_capacity - 1;
+    size_t slot = hash & mask;
+    while(pool->index[slot]){
+        if(string_equal(pool->elements[pool->index[slot] - 1], key)) break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
 string_t new_string_n(string_pool_t* pool, const char* str, const size_t length)
 {
     if(!pool || !str) return (string_t){0};
-    if(!pool->elements && pool->count > 0) return (string_t){0};
 
-    // check if string already exists
-    for(size_t i = 0; i < pool->count; i++){
-        if(pool->elements && pool->elements[i].data && strncmp(pool->elements[i].data, str, length) == 0 && pool->elements[i].length == length){
-            return pool->elements[i];
-        }
+    // hash the caller's bytes once, the stored copy reuses it
+    const uint32_t hash = hm_hash_n(str, length);
+
+    if((pool->count + 1) * 4 > pool->index_capacity * 3){
+        if(!grow_index(pool)) return (string_t){0};
     }
 
+    // check if string already exists
+    const size_t slot = find_slot(pool, str, length, hash);
+    if(pool->index[slot]) return pool->elements[pool->index[slot] - 1];
+
     if(pool->count >= pool->capacity){
         size_t new_capacity = pool->capacity == 0 ? 16 : pool->capacity * 2;
         string_t* new_elements = realloc(pool->elements, sizeof(string_t) * new_capacity);
@@ -45,18 +84,15 @@ string_t new_string_n(string_pool_t* pool, const char* str, const size_t length)
         pool->capacity = new_capacity;
     }
 
-    char* stored_str = arena_alloc(pool->arena, length + 1, alignof(char*));
+    char* stored_str = arena_alloc_uninit(pool->arena, length + 1, alignof(char));
     if(!stored_str) return (string_t){0};
     memcpy(stored_str, str, length);
     stored_str[length] = '\0';
 
-    pool->elements[pool->count].data = stored_str;
-    pool->elements[pool->count].length = length;
-    pool->elements[pool->count].hash = hm_hash(stored_str);
-
-    pool->count++;
+    pool->elements[pool->count] = (string_t){stored_str, length, hash, (atom_t)(pool->count + 1)};
+    pool->index[slot] = (uint32_t)(pool->count + 1);
 
-    return pool->elements[pool->count - 1];
+    return pool->elements[pool->count++];
 }
 
 string_t new_string(string_pool_t* pool, const char* str)
@@ -64,3 +100,15 @@ string_t new_string(string_pool_t* pool, const char* str)
     if(!pool || !str) return (string_t){0};
     return new_string_n(pool, str, strlen(str));
 }
+
+atom_t sp_lookup_n(const string_pool_t* pool, const char* str, const size_t length)
+{
+    if(!pool || !str || pool->count == 0) return ATOM_NONE;
+    return pool->index[find_slot(pool, str, length, hm_hash_n(str, length))];
+}
+
+string_t sp_atom_str(const string_pool_t* pool, const atom_t atom)
+{
+    if(!pool || atom == ATOM_NONE || atom > pool->count) return (string_t){0};
+    return pool->elements[atom - 1];
+}
@@ -41,29 +41,88 @@ void add_report(
         if(!arena_expand(rt->arena, new_cap)) return;
     }
 
-    report_t* store_report = arena_alloc_default(rt->arena, sizeof(report_t));
-    if(!store_report) return;
-
-    *store_report = (report_t){
+    const report_t report = {
         .severity = sev,
         .code = code,
         .loc = loc,
         .filename = src->filename,
-        .line = src->content
+        .source = src
     };
+    if(!arena_push_bytes(rt->arena, &report, sizeof(report_t))) return;
+
     rt->count++;
 }
 
+static void readd_reports(report_table_t* rt, const report_t* reports, const size_t count)
+{
+    for(size_t i = 0; i < count; i++){
+        add_report(rt, reports[i].source, reports[i].severity, reports[i].code, reports[i].loc);
+    }
+}
+
+bool replace_reports(report_table_t* rt, const source_t* src, const size_t fresh,
+                     const uint32_t begin, const uint32_t end, const int64_t delta)
+{
+    if(!rt || fresh > rt->count) return false;
+
+    // most edits neither add reports nor have any to move
+    bool affected = fresh < rt->count;
+    report_iter_t it = report_iter(rt);
+    for(size_t i = 0; !affected && i < fresh; i++){
+        const report_t* report = report_next(&it);
+        affected = report->source == src && report->loc.offset >= begin;
+    }
+    if(!affected) return true;
+
+    const size_t count = rt->count;
+    report_t* reports = malloc(count * sizeof(report_t));
+    if(!reports) return false;
+
+    it = report_iter(rt);
+    for(size_t i = 0; i < count; i++) reports[i] = *report_next(&it);
+
+    // the table is rebuilt in place, the new reports go before the first old
+    // one past the range
+    arena_clear(rt->arena);
+    rt->count = 0;
+
+    size_t kept = 0;
+    bool placed = false;
+    for(size_t i = 0; i < fresh; i++){
+        report_t report = reports[i];
+        if(report.source == src && report.loc.offset >= begin){
+            if(report.loc.offset < end) continue;
+            if(!placed){
+                readd_reports(rt, reports + fresh, count - fresh);
+                placed = true;
+            }
+            report.loc.offset = (uint32_t)((int64_t)report.loc.offset + delta);
+        }
+        readd_reports(rt, &report, 1);
+        kept++;
+    }
+    if(!placed) readd_reports(rt, reports + fresh, count - fresh);
+
+    free(reports);
+    return rt->count == kept + count - fresh;
+}
+
 void print_report(const report_t* report)
 {
-    if(!report || !report->line->data) return;
+    if(!report || !report->source) return;
+
+    const size_t line = src_get_line(report->source, report->loc.offset);
+    const size_t column = src_get_column(report->source, report->loc.offset);
+
+    size_t start = 0, end = 0;
+    if(!src_get_line_range(report->source, line, &start, &end)) return;
 
-    printf("\n %zu |\t%s\n", report->loc.line, report->line->data);
+    printf("\n %zu |\t%.*s\n", line, (int)(end - start), report->source->content->data + start);
     printf(" %*s |\t%*s\033[31m",
-        (int)report->loc.line < 10   ? 1 :
-        (int)report->loc.line < 100  ? 2 :
-        (int)report->loc.line < 1000 ? 3 : 4,
-        "", report->loc.column != 0 ? (int)report->loc.column - 1 : 0, ""
+        line < 10   ? 1 :
+        line < 100  ? 2 :
+        line < 1000 ? 3 : 4,
+        "", column != 0 ? (int)column - 1 : 0, ""
     );
 
     if(report->loc.length == 1){
@@ -79,24 +138,38 @@ void print_report(const report_t* report)
         report->severity == SEV_NOTE ? "\033[34m[NOTE]"    :
                                        "\033[31m[UNKNOWN]",
         report_msg(report->code),
-        report->filename->data, report->loc.line, report->loc.column
+        report->filename ? report->filename->data : "<source>", line, column
     );
 }
 
-void print_report_table(const report_table_t* table)
+report_iter_t report_iter(const report_table_t* table)
 {
-    if(!table) return;
+    return (report_iter_t){table, table ? table->arena->head : NULL, 0, 0};
+}
 
-    size_t printed = 0;
-    for(arena_block_t* b = table->arena->head; b && printed < table->count; b = b->next){
-        const unsigned char* data = b->data;
-        size_t offset = 0;
-        while(offset + sizeof(report_t) <= b->offset && printed < table->count){
-            report_t* report = (report_t*)(data + offset);
-            print_report(report);
-            offset += sizeof(report_t);
-            printed++;
+const report_t* report_next(report_iter_t* it)
+{
+    if(!it || !it->table) return NULL;
+
+    // reports are packed from the start of each block, in the order they were added
+    while(it->block && it->index < it->table->count){
+        if(it->offset + sizeof(report_t) <= it->block->offset){
+            const report_t* report = (const report_t*)(it->block->data + it->offset);
+            it->offset += sizeof(report_t);
+            it->index++;
+            return report;
         }
+        it->block = it->block->next;
+        it->offset = 0;
+    }
+    return NULL;
+}
+
+void print_report_table(const report_table_t* table)
+{
+    report_iter_t it = report_iter(table);
+    for(const report_t* report = report_next(&it); report; report = report_next(&it)){
+        print_report(report);
     }
 }
 
@@ -113,6 +186,7 @@ const char* report_msg(const enum report_code code)
         case ERR_ILLEG_CHAR:    return "Illegal character";
         case ERR_INVAL_LIT:     return "Invalid literal";
         case ERR_INVAL_NUM:     return "Invalid number format";
+        case ERR_NUM_RANGE:     return "Number out of range";
         case ERR_INVAL_IDENT:   return "Invalid identifier";
         case ERR_INVAL_STR:     return "Invalid string";
         case ERR_UNCLO_STR:     return "Unclosed string literal";
@@ -128,6 +202,7 @@ const char* report_msg(const enum report_code code)
         case ERR_EXPEC_KEYWORD: return "Expected keyword";
         case ERR_EXPEC_EXPR:    return "Expected expression";
         case ERR_EXPEC_PARAM:   return "Expected parameter";
+        case ERR_NEST_DEPTH:    return "Nesting too deep";
         case ERR_INVAL_UNARYOP: return "Invalid unary operator";
         case ERR_TYPE_MISMATCH: return "Type mismatch";
         case ERR_UNDEC_VAR:     return "Undeclared variable";
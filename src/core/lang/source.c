@@ -1,28 +1,183 @@
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, madvise, fdopen
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 #include "core/lang/source.h"
 #include "core/lang/filesystem.h"
+#include "core/platform/unix.h"     // mmap, open, fstat
+#include "core/platform/windows.h"
 
+// lines in `src`, the text after the last '\n' counts as a line even if empty
 static size_t count_lines(const char* src, size_t length)
 {
-    // TODO: implement
-    return 0;
+    size_t count = 1;
+    const char* end = src + length;
+    for(const char* p = memchr(src, '\n', length); p; p = memchr(p + 1, '\n', (size_t)(end - p - 1))){
+        count++;
+    }
+    return count;
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+// zero pages for the whole range, then the file over the front of it. The
+// rest of the last file page reads as zero too, so the content is always
+// followed by at least SRC_PADDING zero bytes.
+static bool map_file(source_t* src, const int fd, const size_t size)
+{
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t total = (size + SRC_PADDING + page - 1) / page * page;
+
+    char* base = mmap(NULL, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED) return false;
+
+    if(size > 0){
+        if(mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED){
+            munmap(base, total);
+            return false;
+        }
+        // the lexer reads it front to back exactly once
+        madvise(base, size, MADV_SEQUENTIAL);
+    }
+
+    src->mapping = base;
+    src->mapping_size = total;
+    src->text = (string_t){.data = base, .length = size};
+    src->content = &src->text;
+    src->loaded = true;
+    return true;
 }
+#endif
 
 source_t* load_source_from_file(const char* filepath)
 {
-    // TODO: implement
-    return NULL;
+    if(!filepath) return NULL;
+
+#if defined(_WIN32) || defined(_WIN64)
+    FILE* file = fopen(filepath, "rb");
+    if(!file) return NULL;
+    return load_source_from_stream(file, filepath);
+#else
+    const int fd = open(filepath, O_RDONLY);
+    if(fd < 0) return NULL;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || S_ISDIR(st.st_mode)){
+        close(fd);
+        return NULL;
+    }
+
+    if(!S_ISREG(st.st_mode)){
+        FILE* file = fdopen(fd, "rb");
+        if(!file){
+            close(fd);
+            return NULL;
+        }
+        return load_source_from_stream(file, filepath);
+    }
+
+    // token offsets are 32-bit
+    if((uint64_t)st.st_size > UINT32_MAX){
+        close(fd);
+        return NULL;
+    }
+
+    source_t* src = new_source(filepath);
+    if(!src || !map_file(src, fd, (size_t)st.st_size)){
+        free_source(src);
+        close(fd);
+        return NULL;
+    }
+
+    // the mapping keeps its own reference to the file
+    close(fd);
+    return src;
+#endif
+}
+
+source_t* load_source_from_stream(FILE* file, const char* name)
+{
+    if(!file) return NULL;
+
+    source_t* src = new_source(name);
+    if(!src){
+        fclose(file);
+        return NULL;
+    }
+
+    src->stream_buffer = new_vm_arena(ARENA_VM_RESERVE, false);
+    if(!src->stream_buffer){
+        fclose(file);
+        free_source(src);
+        return NULL;
+    }
+
+    src->stream = file;
+    src->text = (string_t){.data = "", .length = 0};
+    src->content = &src->text;
+
+    // the first chunk is read right away so the lexer has something to start on
+    src_refill(src);
+    return src;
+}
+
+bool src_refill(source_t* src)
+{
+    if(!src || !src->stream) return false;
+
+    // the buffer is the only allocation in its arena, so it always grows in place
+    const size_t size = src->text.length + SRC_STREAM_CHUNK + SRC_PADDING;
+    if(size - SRC_PADDING > UINT32_MAX) return false;
+
+    char* data = src->stream_size
+               ? arena_resize(src->stream_buffer, (void*)src->text.data, src->stream_size, size, 1)
+               : arena_alloc_uninit(src->stream_buffer, size, 1);
+    if(!data || (src->stream_size && data != src->text.data)) return false;
+    src->stream_size = size;
+
+    const size_t read = fread(data + src->text.length, 1, SRC_STREAM_CHUNK, src->stream);
+    memset(data + src->text.length + read, 0, SRC_PADDING);
+    src->text.data = data;
+    src->text.length += read;
+
+    // line starts are rebuilt once the stream is drained
+    src->line_starts = NULL;
+    src->line_count = 0;
+    src->line_capacity = 0;
+
+    if(read < SRC_STREAM_CHUNK){
+        fclose(src->stream);
+        src->stream = NULL;
+        src->loaded = true;
+    }
+    return read > 0;
 }
 
 source_t* new_source(const char* filename)
 {
-    // TODO: implement
-    return NULL;
+    source_t* src = calloc(1, sizeof(source_t));
+    if(!src) return NULL;
+
+    if(filename && !src_set_filename(src, filename)){
+        free(src);
+        return NULL;
+    }
+    return src;
 }
 
+void free_source(source_t* src)
+{
+    if(!src) return;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    if(src->mapping) munmap(src->mapping, src->mapping_size);
+#endif
+    if(src->stream) fclose(src->stream);
+    if(src->stream_buffer) free_arena(src->stream_buffer);
+    free((char*)src->name.data);
+    free(src);
+}
 
 void new_source_manager(void)
 {
@@ -37,13 +192,30 @@ void free_source_manager(source_manager_t* manager)
 
 bool src_set_filename(source_t* src, const char* filename)
 {
-    // TODO: implement
+    if(!src || !filename) return false;
+
+    const size_t length = strlen(filename);
+    char* name = malloc(length + 1);
+    if(!name) return false;
+    memcpy(name, filename, length + 1);
+
+    free((char*)src->name.data);
+    src->name = (string_t){.data = name, .length = length};
+    src->filename = &src->name;
     return true;
 }
 
+// `content` is borrowed and has to stay NUL-terminated at `length`
 bool src_set_content(source_t* src, const char* content, size_t length)
 {
-    // TODO: implement
+    if(!src || !content || length > UINT32_MAX || content[length] != '\0') return false;
+
+    src->text = (string_t){.data = content, .length = length};
+    src->content = &src->text;
+    src->line_starts = NULL;
+    src->line_count = 0;
+    src->line_capacity = 0;
+    src->loaded = true;
     return true;
 }
 
@@ -53,29 +225,147 @@ int is_source_correct_extension(const char* filepath)
     return 0;
 }
 
-size_t src_get_line(source_t* src, size_t offset)
+// builds the line start table once, diagnostics then find lines by binary search
+bool src_index_lines(source_t* src, arena_t* arena)
 {
-    // TODO: implement
-    return 0;
+    if(!src || !src->content || !src->content->data) return false;
+    if(src->line_starts) return true;
+
+    const char* content = src->content->data;
+    const size_t length = src->content->length;
+    if(length > UINT32_MAX) return false;
+
+    const size_t count = count_lines(content, length);
+    uint32_t* starts = arena_alloc_uninit(arena, count * sizeof(uint32_t), alignof(uint32_t));
+    if(!starts) return false;
+
+    size_t line = 0;
+    starts[line++] = 0;
+
+    const char* end = content + length;
+    for(const char* p = memchr(content, '\n', length); p; p = memchr(p + 1, '\n', (size_t)(end - p - 1))){
+        starts[line++] = (uint32_t)(p - content + 1);
+    }
+
+    src->line_starts = starts;
+    src->line_count = count;
+    src->line_capacity = count;
+    return true;
 }
 
-size_t src_get_column(source_t* src, size_t offset)
+// first line whose start is past `offset`
+static size_t line_after(const source_t* src, const uint32_t offset)
 {
-    // TODO: implement
-    return 0;
+    size_t low = 0, high = src->line_count;
+    while(low < high){
+        const size_t mid = low + (high - low) / 2;
+        if(src->line_starts[mid] <= offset) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+bool src_update_lines(source_t* src, arena_t* arena, uint32_t offset, uint32_t removed, uint32_t inserted)
+{
+    if(!src || !src->content || !src->content->data) return false;
+    if(!src->line_starts) return true;
+    if((size_t)offset + inserted > src->content->length) return false;
+
+    // a line starts after every newline, so the removed newlines started
+    // lines (offset, offset + removed] and the inserted ones start new lines there
+    const size_t first = line_after(src, offset);
+    const size_t last = line_after(src, offset + removed);
+    const char* text = src->content->data + offset;
+    const size_t added = count_lines(text, inserted) - 1;
+
+    const size_t count = src->line_count - (last - first) + added;
+    if(count > src->line_capacity){
+        const size_t capacity = count > src->line_capacity * 2 ? count : src->line_capacity * 2;
+        uint32_t* grown = arena_resize(arena, src->line_starts, src->line_capacity * sizeof(uint32_t),
+                                       capacity * sizeof(uint32_t), alignof(uint32_t));
+        if(!grown) return false;
+        src->line_starts = grown;
+        src->line_capacity = capacity;
+    }
+
+    uint32_t* starts = src->line_starts;
+    const uint32_t shift = inserted - removed; // wraps for a shrinking edit, the sum still comes out right
+    memmove(starts + first + added, starts + last, (src->line_count - last) * sizeof(uint32_t));
+    for(size_t i = first + added; i < count; i++) starts[i] += shift;
+
+    size_t line = first;
+    const char* end = text + inserted;
+    for(const char* p = memchr(text, '\n', inserted); p; p = memchr(p + 1, '\n', (size_t)(end - p - 1))){
+        starts[line++] = (uint32_t)(p - src->content->data + 1);
+    }
+
+    src->line_count = count;
+    return true;
+}
+
+size_t src_get_line(const source_t* src, size_t offset)
+{
+    if(!src || !src->content || !src->content->data) return 0;
+    if(offset > src->content->length) offset = src->content->length;
+
+    // without the index fall back to counting
+    if(!src->line_starts){
+        return count_lines(src->content->data, offset);
+    }
+
+    // last line starting at or before `offset`
+    size_t low = 0, high = src->line_count;
+    while(high - low > 1){
+        const size_t mid = low + (high - low) / 2;
+        if(src->line_starts[mid] <= offset) low = mid;
+        else high = mid;
+    }
+    return low + 1;
 }
 
-bool src_get_line_range(source_t* src, size_t line, size_t* start, size_t* end)
+size_t src_get_column(const source_t* src, size_t offset)
 {
+    if(!src || !src->content || !src->content->data) return 0;
+    if(offset > src->content->length) offset = src->content->length;
+
+    size_t start = 0, end = 0;
+    if(!src_get_line_range(src, src_get_line(src, offset), &start, &end)) return 0;
+    return offset - start + 1;
+}
+
+// byte range of `line` (1-based) without its '\n'
+bool src_get_line_range(const source_t* src, size_t line, size_t* start, size_t* end)
+{
+    if(!src || !src->content || !src->content->data || line == 0) return false;
+
+    const char* content = src->content->data;
+    const size_t length = src->content->length;
+
+    size_t first = 0;
+    if(src->line_starts){
+        if(line > src->line_count) return false;
+        first = src->line_starts[line - 1];
+    }
+    else {
+        for(size_t i = 1; i < line; i++){
+            const char* next = memchr(content + first, '\n', length - first);
+            if(!next) return false;
+            first = (size_t)(next - content) + 1;
+        }
+    }
+
+    const char* newline = memchr(content + first, '\n', length - first);
+    if(start) *start = first;
+    if(end) *end = newline ? (size_t)(newline - content) : length;
     return true;
 }
 
 location_t new_location(void)
 {
-    return (location_t){1,1,0,0};
+    return (location_t){0, 0};
 }
 
 location_t loc_copy(location_t loc, size_t len)
 {
-    return (location_t){loc.line, loc.column + len, loc.offset, len};
+    return (location_t){loc.offset + (uint32_t)len, (uint32_t)len};
 }
@@ -1,9 +1,568 @@
 #include <assert.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "compiler/context.h"
 #include "compiler/frontend/lexer.h"
 #include "../utils/benchmark.h"
 
+#define BENCH_SIZE (8 * 1024 * 1024)
+#define BENCH_RUNS 5
+#define EDIT_LINES 50000
+#define EDIT_COUNT 1000
+
+static const char* snippet =
+    "# sample module\n"
+    "import std, math\n"
+    "\n"
+    "#[ block comment\n"
+    "   spanning lines ]#\n"
+    "struct Point {\n"
+    "    var x: float = 0.0\n"
+    "    var y: float = 0.0\n"
+    "}\n"
+    "\n"
+    "func distance(a: Point, b: Point): float {\n"
+    "    var dx: float = a.x - b.x\n"
+    "    var dy: float = a.y - b.y\n"
+    "    return dx * dx + dy * dy    # squared\n"
+    "}\n"
+    "\n"
+    "func main(): int {\n"
+    "    const name: str = \"bread \\\"crumbs\\\"\\n\"\n"
+    "    for i in 0..10 {\n"
+    "        if(i % 2 == 0 && i != 4){\n"
+    "            print(\"even number, keep going\")\n"
+    "        }\n"
+    "        elif(i >= 7) { break }\n"
+    "    }\n"
+    "    return 0x1F + 0b101 - 42\n"
+    "}\n\n";
+
+static size_t lex_all(compiler_context_t* ctx)
+{
+    lexer_t* lexer = new_lexer(ctx);
+    assert(lexer);
+
+    size_t count = 0;
+    token_t token;
+    do {
+        token = next_token(lexer);
+        count++;
+    } while(token.category != CAT_SERVICE || token.type != SERV_EOF);
+
+    return count;
+}
+
+// lexes `text` as the only token and returns its decoded value
+static constant_t lex_constant(compiler_context_t* ctx, const char* text, const int type)
+{
+    string_t content = new_string(&ctx->memory.perm_strings, text);
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+
+    lexer_t* lexer = new_lexer(ctx);
+    const token_t token = next_token(lexer);
+    assert(token.category == CAT_LITERAL && token.type == type);
+    assert(next_token(lexer).type == SERV_EOF);
+
+    ctx->src_manager.current = NULL;
+    return get_constant(&ctx->literals, token.constant);
+}
+
+static void test_literals(void)
+{
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    assert(lex_constant(ctx, "0", LIT_NUMBER).integer == 0);
+    assert(lex_constant(ctx, "42", LIT_NUMBER).integer == 42);
+    assert(lex_constant(ctx, "18446744073709551615", LIT_NUMBER).integer == UINT64_MAX);
+    assert(lex_constant(ctx, "0x1F", LIT_HEX).integer == 0x1F);
+    assert(lex_constant(ctx, "0xffffFFFFffffFFFF", LIT_HEX).integer == UINT64_MAX);
+    assert(lex_constant(ctx, "0b101", LIT_BIN).integer == 5);
+    assert(lex_constant(ctx, "0o777", LIT_OCT).integer == 0777);
+
+    const constant_t real = lex_constant(ctx, "3.25", LIT_FLOAT);
+    assert(real.kind == CONST_FLOAT && real.real == 3.25);
+    assert(lex_constant(ctx, "0.1", LIT_FLOAT).real == 0.1);
+    assert(lex_constant(ctx, "0.000000000000000000000000001", LIT_FLOAT).real == 1e-27);
+    assert(lex_constant(ctx, "123456789012345678901234567890.5", LIT_FLOAT).real == 123456789012345678901234567890.5);
+
+    // long literals don't read the locale's decimal point
+    if(setlocale(LC_NUMERIC, "de_DE.UTF-8")){
+        assert(lex_constant(ctx, "123456789012345678901234567890.5", LIT_FLOAT).real == 123456789012345678901234567890.5);
+        setlocale(LC_NUMERIC, "C");
+    }
+
+    // each distinct value is stored once
+    const size_t count = ctx->literals.count;
+    lex_constant(ctx, "0x2a", LIT_HEX);
+    assert(ctx->literals.count == count);
+    assert(ctx->reports->count == 0);
+
+    // values past 64 bits are reported
+    string_t content = new_string(&ctx->memory.perm_strings, "18446744073709551616 0x10000000000000000");
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+    lexer_t* lexer = new_lexer(ctx);
+    assert(next_token(lexer).type == SERV_ILLEGAL);
+    assert(next_token(lexer).type == SERV_ILLEGAL);
+    assert(ctx->reports->count == 2);
+
+    free_compiler_context(ctx);
+}
+
+static bool buffers_equal(const token_buffer_t* a, const token_buffer_t* b)
+{
+    if(a->count != b->count) return false;
+    for(size_t i = 0; i < a->count; i++){
+        if(a->categories[i] != b->categories[i] || a->types[i] != b->types[i]) return false;
+        if(a->atoms[i] != b->atoms[i]) return false;
+        if(a->offsets[i] != b->offsets[i] || a->lengths[i] != b->lengths[i]) return false;
+    }
+    return true;
+}
+
+static const report_t* next_checked_report(report_iter_t* it, const size_t end)
+{
+    const report_t* report = NULL;
+    do report = it->index < end ? report_next(it) : NULL;
+    while(report && report->code == ERR_UNMAT_PAREN);
+    return report;
+}
+
+// Reports [0, split) of the table against [split, count). Paren balance
+// reports past the rescanned tokens depend on every paren before them, and
+// a relex doesn't revisit them. The rest must match.
+static bool reports_equal(const report_table_t* table, const size_t split)
+{
+    report_iter_t ia = report_iter(table);
+    report_iter_t ib = report_iter(table);
+    while(ib.index < split && report_next(&ib));
+
+    while(true){
+        const report_t* ra = next_checked_report(&ia, split);
+        const report_t* rb = next_checked_report(&ib, table->count);
+        if(!ra || !rb) return ra == rb;
+        if(ra->code != rb->code || ra->loc.offset != rb->loc.offset || ra->loc.length != rb->loc.length) return false;
+    }
+}
+
+static bool lines_equal(const source_t* src, arena_t* arena)
+{
+    source_t fresh = {.content = src->content};
+    if(!src_index_lines(&fresh, arena) || fresh.line_count != src->line_count) return false;
+    return memcmp(fresh.line_starts, src->line_starts, src->line_count * sizeof(uint32_t)) == 0;
+}
+
+// paren balance the lexer had before token `count`
+static size_t paren_balance(const token_buffer_t* buffer, const size_t count)
+{
+    size_t balance = 0;
+    for(size_t i = 0; i < count; i++){
+        if(buffer->categories[i] != CAT_PAREN) continue;
+        if(buffer->types[i] == PAR_LPAREN || buffer->types[i] == PAR_LBRACE || buffer->types[i] == PAR_LBRACKET) balance++;
+        else if(balance > 0) balance--;
+    }
+    return balance;
+}
+
+// replaces `removed` bytes at `offset` of a malloc'd, NUL-terminated text
+static void apply_edit(string_t* content, size_t offset, size_t removed, const char* text)
+{
+    const size_t inserted = strlen(text);
+    char* data = (char*)content->data;
+    memmove(data + offset + inserted, data + offset + removed, content->length - offset - removed + 1);
+    memcpy(data + offset, text, inserted);
+    content->length = content->length - removed + inserted;
+}
+
+static void test_relex(void)
+{
+    // fragments that open and close strings and comments, split and join tokens
+    static const char* fragments[] = {
+        "", "x", " ", "\n", "\"", "'", "#", "#[", "]#", "(", "}", "1", ".", ".5", "..", "=", "&", "0x", "abc def",
+    };
+    const size_t fragment_count = sizeof(fragments) / sizeof(fragments[0]);
+
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    const size_t capacity = strlen(snippet) * 4 + 1;
+    char* text = malloc(capacity);
+    assert(text);
+    strcpy(text, snippet);
+
+    string_t content = {.data = text, .length = strlen(text)};
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+
+    lexer_t* lexer = new_lexer(ctx);
+    token_buffer_t* buffer = new_token_buffer(lexer);
+    assert(buffer);
+
+    // "1." only becomes a float once a digit follows, two tokens before the edit
+    apply_edit(&content, 0, content.length, "var a = 1.x");
+    assert(relex_token_buffer(buffer, lexer, 0, (uint32_t)strlen(snippet), (uint32_t)content.length, NULL));
+    apply_edit(&content, 10, 1, "5");
+
+    token_span_t span;
+    assert(relex_token_buffer(buffer, lexer, 10, 1, 1, &span));
+    assert(span.first == 3 && span.removed == 3 && span.inserted == 1);
+    assert(buffer->count == 5 && buffer->types[3] == LIT_FLOAT);
+
+    // typing before a stray character keeps its one report on it
+    apply_edit(&content, 0, content.length, "var a = 1\nvar b = $\n");
+    assert(relex_token_buffer(buffer, lexer, 0, 11, (uint32_t)content.length, NULL));
+    assert(ctx->reports->count == 1);
+    for(size_t i = 0; i < 100; i++){
+        apply_edit(&content, 18 + i, 0, i % 4 == 3 ? " " : "x");
+        assert(relex_token_buffer(buffer, lexer, (uint32_t)(18 + i), 0, 1, NULL));
+    }
+    report_iter_t it = report_iter(ctx->reports);
+    const report_t* stray = report_next(&it);
+    assert(ctx->reports->count == 1 && stray->code == ERR_ILLEG_CHAR && stray->loc.offset == 118);
+    assert(src_get_line(&src, 118) == 2);
+
+    // erasing it takes the report away
+    apply_edit(&content, 118, 1, "");
+    assert(relex_token_buffer(buffer, lexer, 118, 1, 0, NULL));
+    assert(ctx->reports->count == 0);
+
+    apply_edit(&content, 0, content.length, snippet);
+    assert(relex_token_buffer(buffer, lexer, 0, 119, (uint32_t)content.length, NULL));
+    assert(ctx->reports->count == 0);
+
+    uint32_t seed = 12345;
+    for(int i = 0; i < 2000; i++){
+        seed = seed * 1103515245 + 12345;
+        const size_t offset = (seed >> 8) % (content.length + 1);
+        seed = seed * 1103515245 + 12345;
+        size_t removed = (seed >> 8) % 4;
+        if(offset + removed > content.length) removed = content.length - offset;
+        const char* fragment = fragments[(seed >> 16) % fragment_count];
+        if(content.length - removed + strlen(fragment) >= capacity) continue;
+
+        apply_edit(&content, offset, removed, fragment);
+
+        assert(relex_token_buffer(buffer, lexer, (uint32_t)offset, (uint32_t)removed, (uint32_t)strlen(fragment), &span));
+        assert(buffer->balance_index == span.first && buffer->balance == paren_balance(buffer, span.first));
+
+        // the result is what lexing the new content from scratch gives
+        // and its reports, which are taken back again
+        const arena_mark_t mark = arena_mark(ctx->reports->arena);
+        const size_t relexed = ctx->reports->count;
+        token_buffer_t* fresh = new_token_buffer(new_lexer(ctx));
+        assert(fresh && buffers_equal(buffer, fresh));
+        assert(reports_equal(ctx->reports, relexed));
+        assert(lines_equal(&src, ctx->memory.phase_arena));
+        free_token_buffer(fresh);
+        arena_rewind(ctx->reports->arena, mark);
+        ctx->reports->count = relexed;
+    }
+
+    free_token_buffer(buffer);
+    ctx->src_manager.current = NULL;
+    free_compiler_context(ctx);
+    free(text);
+}
+
+// types and erases a word in the middle of a 50k-line file, relexing after
+// every keystroke, then relexes the same edits from scratch for comparison
+static void bench_relex(void)
+{
+    size_t snippet_lines = 0;
+    for(const char* p = snippet; *p; p++) snippet_lines += *p == '\n';
+
+    const size_t snippet_length = strlen(snippet);
+    const size_t copies = EDIT_LINES / snippet_lines + 1;
+    const size_t length = copies * snippet_length;
+
+    char* text = malloc(length + EDIT_COUNT + 1);
+    assert(text);
+    for(size_t i = 0; i < copies; i++){
+        memcpy(text + i * snippet_length, snippet, snippet_length);
+    }
+    text[length] = '\0';
+
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content = {.data = text, .length = length};
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+    ctx->options.dump_tokens = false; // a DEBUG build would time the dump
+
+    lexer_t* lexer = new_lexer(ctx);
+    token_buffer_t* buffer = new_token_buffer(lexer);
+    assert(buffer);
+
+    // inside "dx * dx" of the copy in the middle of the file
+    const size_t at = (copies / 2) * snippet_length + (size_t)(strstr(snippet, "dx * dx") - snippet) + 1;
+
+    bm_reset();
+    for(int run = 0; run < BENCH_RUNS; run++){
+        bm_start();
+        for(size_t i = 0; i < EDIT_COUNT; i++){
+            const bool typing = i < EDIT_COUNT / 2;
+            const size_t offset = typing ? at + i : at + EDIT_COUNT - i - 1;
+            if(typing) apply_edit(&content, offset, 0, "x");
+            else apply_edit(&content, offset, 1, "");
+
+            token_span_t span;
+            assert(relex_token_buffer(buffer, lexer, (uint32_t)offset, typing ? 0 : 1, typing ? 1 : 0, &span));
+            assert(span.removed == span.inserted && span.removed <= 2);
+        }
+        bm_stop();
+    }
+    assert(content.length == length);
+
+    token_buffer_t* fresh = new_token_buffer(new_lexer(ctx));
+    assert(fresh && buffers_equal(buffer, fresh));
+    free_token_buffer(fresh);
+
+    char title[64];
+    snprintf(title, sizeof(title), "Relex per keystroke (%d lines, %d edits)", EDIT_LINES, EDIT_COUNT);
+    bm_print(title);
+
+    // the same file lexed whole, which is what every keystroke used to cost
+    bm_reset();
+    for(int run = 0; run < BENCH_RUNS; run++){
+        arena_mark_t mark = arena_mark(ctx->memory.phase_arena);
+        bm_start();
+        fresh = new_token_buffer(new_lexer(ctx));
+        bm_stop();
+        assert(fresh);
+        free_token_buffer(fresh);
+        arena_rewind(ctx->memory.phase_arena, mark);
+    }
+    snprintf(title, sizeof(title), "Full relex (%d lines, 1 edit)", EDIT_LINES);
+    bm_print(title);
+
+    free_token_buffer(buffer);
+    ctx->src_manager.current = NULL;
+    free_compiler_context(ctx);
+    free(text);
+}
+
+// same tokens, spellings, values and reports from two contexts
+static bool buffers_match(compiler_context_t* ctx_a, const token_buffer_t* a, compiler_context_t* ctx_b, const token_buffer_t* b)
+{
+    if(a->count != b->count) return false;
+    for(size_t i = 0; i < a->count; i++){
+        const token_t x = buffer_token(a, i);
+        const token_t y = buffer_token(b, i);
+        if(x.category != y.category || x.type != y.type || x.offset != y.offset || x.length != y.length) return false;
+
+        if(is_number_literal(x)){
+            const constant_t cx = get_constant(&ctx_a->literals, x.constant);
+            const constant_t cy = get_constant(&ctx_b->literals, y.constant);
+            if(cx.kind != cy.kind || cx.integer != cy.integer) return false;
+        }
+        else if(!string_equal(sp_atom_str(&ctx_a->memory.perm_strings, x.atom), sp_atom_str(&ctx_b->memory.perm_strings, y.atom))){
+            return false;
+        }
+    }
+
+    if(ctx_a->reports->count != ctx_b->reports->count) return false;
+    report_iter_t it_a = report_iter(ctx_a->reports);
+    report_iter_t it_b = report_iter(ctx_b->reports);
+    for(const report_t* r = report_next(&it_a); r; r = report_next(&it_a)){
+        const report_t* q = report_next(&it_b);
+        if(r->code != q->code || r->loc.offset != q->loc.offset || r->loc.length != q->loc.length) return false;
+    }
+    return true;
+}
+
+// lexes `text` sequentially and on 4 threads and compares the results
+static void check_parallel(const char* text, const size_t length)
+{
+    compiler_context_t* seq_ctx = new_compiler_context();
+    compiler_context_t* par_ctx = new_compiler_context();
+    assert(seq_ctx && par_ctx);
+
+    string_t content = {.data = text, .length = length};
+    source_t seq_src = {.content = &content};
+    source_t par_src = {.content = &content};
+    seq_ctx->src_manager.current = &seq_src;
+    par_ctx->src_manager.current = &par_src;
+
+    token_buffer_t* sequential = new_token_buffer(new_lexer(seq_ctx));
+    token_buffer_t* parallel = new_token_buffer_parallel(par_ctx, 4);
+    assert(sequential && parallel);
+    assert(buffers_match(seq_ctx, sequential, par_ctx, parallel));
+
+    free_token_buffer(sequential);
+    free_token_buffer(parallel);
+    seq_ctx->src_manager.current = NULL;
+    par_ctx->src_manager.current = NULL;
+    free_compiler_context(seq_ctx);
+    free_compiler_context(par_ctx);
+}
+
+// chunk cuts that fall inside a block comment and a string spanning many
+// lines, stray bytes and unbalanced parens, all reported as they are
+// sequentially
+static void test_parallel(void)
+{
+    static const char* lines = "var a = b + 0x1F # c\n    call(d, 1.5) @ e)\n";
+    const size_t line_length = strlen(lines);
+    const size_t copies = LEXER_CHUNK_MIN * 5 / line_length;
+
+    char* text = malloc(copies * (line_length + 1) + 64);
+    assert(text);
+
+    size_t length = 0;
+    for(size_t i = 0; i < copies; i++){
+        if(i == copies / 4) length += (size_t)sprintf(text + length, "#[ ");
+        if(i == copies / 2) length += (size_t)sprintf(text + length, " ]# (\"");
+        if(i == copies * 3 / 4) length += (size_t)sprintf(text + length, "\" ");
+        memcpy(text + length, lines, line_length);
+        length += line_length;
+    }
+    text[length] = '\0';
+
+    check_parallel(text, length);
+
+    // short block comments all over, chunks that start inside one line up
+    // with the real tokens again after its end
+    length = 0;
+    for(size_t i = 0; i < copies; i++){
+        if(i % 50 == 0) length += (size_t)sprintf(text + length, "#[ ");
+        if(i % 50 == 40) length += (size_t)sprintf(text + length, " ]# ");
+        memcpy(text + length, lines, line_length);
+        length += line_length;
+    }
+    text[length] = '\0';
+
+    check_parallel(text, length);
+
+    // no newline to cut at, one chunk
+    memset(text, 'x', length);
+    check_parallel(text, length);
+
+    free(text);
+}
+
+// lexes `text` from memory, mapped from a file and read back as a stream,
+// and compares the results
+static void check_loaded(const char* text, const size_t length)
+{
+    static const char* path = "lexing_source.brc";
+
+    FILE* file = fopen(path, "wb");
+    assert(file);
+    assert(fwrite(text, 1, length, file) == length);
+    fclose(file);
+
+    compiler_context_t* ctx = new_compiler_context();
+    compiler_context_t* map_ctx = new_compiler_context();
+    compiler_context_t* stream_ctx = new_compiler_context();
+    assert(ctx && map_ctx && stream_ctx);
+
+    string_t content = {.data = text, .length = length};
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+
+    source_t* mapped = load_source_from_file(path);
+    assert(mapped && mapped->loaded && mapped->content->length == length);
+    map_ctx->src_manager.current = mapped;
+
+    source_t* streamed = load_source_from_stream(fopen(path, "rb"), path);
+    assert(streamed && streamed->loaded == (length < SRC_STREAM_CHUNK));
+    stream_ctx->src_manager.current = streamed;
+
+    token_buffer_t* expected = new_token_buffer(new_lexer(ctx));
+    token_buffer_t* from_map = new_token_buffer(new_lexer(map_ctx));
+    token_buffer_t* from_stream = new_token_buffer(new_lexer(stream_ctx));
+    assert(expected && from_map && from_stream);
+    assert(buffers_match(ctx, expected, map_ctx, from_map));
+    assert(buffers_match(ctx, expected, stream_ctx, from_stream));
+
+    // the stream is read to the end and indexed
+    assert(streamed->loaded && !streamed->stream && streamed->content->length == length);
+    assert(streamed->line_starts && src_get_line(streamed, length) == src_get_line(&src, length));
+
+    free_token_buffer(expected);
+    free_token_buffer(from_map);
+    free_token_buffer(from_stream);
+    free_source(mapped);
+    free_source(streamed);
+    ctx->src_manager.current = NULL;
+    map_ctx->src_manager.current = NULL;
+    stream_ctx->src_manager.current = NULL;
+    free_compiler_context(ctx);
+    free_compiler_context(map_ctx);
+    free_compiler_context(stream_ctx);
+    remove(path);
+}
+
+// tokens, a string and a block comment cut by the stream chunks, and a file
+// filling whole pages that ends right before the padding
+static void test_sources(void)
+{
+    static const char* lines = "var a = b + 0x1F # c\n    call(d, 1.5) @ e)\n";
+    const size_t line_length = strlen(lines);
+    const size_t copies = SRC_STREAM_CHUNK * 4 / line_length;
+    const size_t long_token = SRC_STREAM_CHUNK * 3 / 2;
+
+    char* text = malloc(copies * (line_length + 1) + long_token * 2 + 64);
+    assert(text);
+
+    size_t length = 0;
+    for(size_t i = 0; i < copies; i++){
+        memcpy(text + length, lines, line_length);
+        length += line_length;
+
+        // one character more every line moves each token over the chunk boundaries
+        text[length++] = i % 3 ? ' ' : '\n';
+
+        if(i == copies / 3){
+            text[length++] = '"';
+            memset(text + length, 's', long_token);
+            length += long_token;
+            text[length++] = '"';
+        }
+        if(i == copies * 2 / 3){
+            length += (size_t)sprintf(text + length, "#[ ");
+            memset(text + length, 'c', long_token);
+            length += long_token;
+            length += (size_t)sprintf(text + length, " ]#");
+        }
+    }
+    text[length] = '\0';
+
+    check_loaded(text, length);
+    check_loaded("", 0);
+
+    // the first chunk ends right after the dot of "1.5"
+    memset(text, ' ', SRC_STREAM_CHUNK + 8);
+    memcpy(text + SRC_STREAM_CHUNK - 2, "1.5 a", 5);
+    text[SRC_STREAM_CHUNK + 8] = '\0';
+    check_loaded(text, SRC_STREAM_CHUNK + 8);
+
+    memset(text, 'x', 4096);
+    text[4096] = '\0';
+    check_loaded(text, 4096);
+    memcpy(text + 4096 - 3, " 1.", 3);
+    check_loaded(text, 4096);
+
+    free(text);
+}
+
+static void print_throughput(const size_t length, const size_t tokens)
+{
+    double best = times[0];
+    for(int i = 1; i < time_count; i++){
+        if(times[i] < best) best = times[i];
+    }
+    printf("\033[1mThroughput: \033[0;90m%.1f MB/s, %.1f M tokens/s\033[0m\n",
+           (double)length / (1024.0 * 1024.0) / best, (double)tokens / 1e6 / best);
+}
+
 int main(void)
 {
     bm_start();
@@ -11,16 +570,109 @@ int main(void)
     compiler_context_t* ctx = new_compiler_context();
     assert(ctx);
 
-    lexer_t* lexer = new_lexer(ctx);
-    assert(lexer);
+    // there is no source yet, so no lexer
+    assert(new_lexer(ctx) == NULL);
 
-    token_t token;
-    do token = next_token(lexer); while(token.category != CAT_SERVICE || token.type != SERV_EOF);
+    string_t content = new_string(&ctx->memory.perm_strings, snippet);
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+
+    const size_t count = lex_all(ctx);
+    assert(count > 1);
+    assert(ctx->reports->count == 0);
+
+    // the buffer holds the same tokens the lexer streams
+    token_buffer_t* buffer = new_token_buffer(new_lexer(ctx));
+    assert(buffer && buffer->count == count);
+
+    lexer_t* lexer = new_lexer(ctx);
+    for(size_t i = 0; i < buffer->count; i++){
+        const token_t token = next_token(lexer);
+        const token_t buffered = buffer_token(buffer, i);
+        assert(token.category == buffered.category && token.type == buffered.type);
+        assert(token.offset == buffered.offset && token.length == buffered.length);
+        assert(token.atom == buffered.atom);
+        assert(lexer->loc.offset == buffer_loc(buffer, i).offset);
+    }
+    assert(buffer_token(buffer, buffer->count + 10).type == SERV_EOF);
+    free_token_buffer(buffer);
 
     free_compiler_context(ctx);
 
+    test_literals();
+    test_relex();
+    test_parallel();
+    test_sources();
+
     bm_stop();
     bm_print("Test lexer");
 
+    // throughput over a large source made of the snippet
+    const size_t snippet_length = strlen(snippet);
+    const size_t copies = BENCH_SIZE / snippet_length;
+    const size_t length = copies * snippet_length;
+
+    char* text = malloc(length + 1);
+    assert(text);
+    for(size_t i = 0; i < copies; i++){
+        memcpy(text + i * snippet_length, snippet, snippet_length);
+    }
+    text[length] = '\0';
+
+    ctx = new_compiler_context();
+    assert(ctx);
+
+    content = new_string_n(&ctx->memory.perm_strings, text, length);
+    src.content = &content;
+    ctx->src_manager.current = &src;
+    ctx->options.dump_tokens = false; // a DEBUG build would time the dump
+
+    bm_reset();
+    size_t tokens = 0;
+    for(int i = 0; i < BENCH_RUNS; i++){
+        arena_mark_t mark = arena_mark(ctx->memory.phase_arena);
+        bm_start();
+        tokens = lex_all(ctx);
+        bm_stop();
+        arena_rewind(ctx->memory.phase_arena, mark);
+    }
+    assert(tokens == (count - 1) * copies + 1);
+
+    bm_print("Lexer throughput (8MB)");
+    print_throughput(length, tokens);
+
+    bm_reset();
+    for(int i = 0; i < BENCH_RUNS; i++){
+        arena_mark_t mark = arena_mark(ctx->memory.phase_arena);
+        bm_start();
+        buffer = new_token_buffer(new_lexer(ctx));
+        bm_stop();
+        assert(buffer && buffer->count == tokens);
+        free_token_buffer(buffer);
+        arena_rewind(ctx->memory.phase_arena, mark);
+    }
+
+    bm_print("Token buffer (8MB)");
+    print_throughput(length, tokens);
+
+    bm_reset();
+    for(int i = 0; i < BENCH_RUNS; i++){
+        arena_mark_t mark = arena_mark(ctx->memory.phase_arena);
+        bm_start();
+        buffer = new_token_buffer_parallel(ctx, 4);
+        bm_stop();
+        assert(buffer && buffer->count == tokens);
+        free_token_buffer(buffer);
+        arena_rewind(ctx->memory.phase_arena, mark);
+    }
+
+    bm_print("Parallel token buffer (8MB, 4 threads)");
+    print_throughput(length, tokens);
+
+    free_compiler_context(ctx);
+    free(text);
+
+    bench_relex();
+
     return 0;
 }
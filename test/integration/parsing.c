@@ -1,15 +1,592 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "core/ds/arena.h"
 #include "core/lang/diagnostic.h"
 #include "core/lang/filesystem.h"
 #include "core/lang/source.h"
 #include "compiler/frontend/parser.h"
+#include "compiler/frontend/ast/traversal.h"
+#include "compiler/frontend/ast/visitor.h"
 #include "../utils/benchmark.h"
 
+#define BENCH_SIZE (4 * 1024 * 1024)
+#define BENCH_RUNS 5
+
+static const char* snippet =
+    "import std.math\n"
+    "type Point: struct {\n"
+    "    var x: float = 0.0\n"
+    "    var y: float\n"
+    "}\n"
+    "func add(a: int, b: int): int {\n"
+    "    var sum = a + b * 2\n"
+    "    if(sum > 10){ return sum }\n"
+    "    elif(sum > 5){ return 5 }\n"
+    "    return add(sum, 1)\n"
+    "}\n";
+
+static ast_t* parse_text(compiler_context_t* ctx, source_t* src, string_t* content, const char* text)
+{
+    *content = new_string(&ctx->memory.perm_strings, text);
+    src->content = content;
+    ctx->src_manager.current = src;
+    return parse_program(new_parser(ctx, new_lexer(ctx)));
+}
+
+static const char* name_of(const ast_t* ast, const atom_t atom)
+{
+    return sp_atom_str(ast->names, atom).data;
+}
+
+static const node_t* list_item(const ast_t* ast, const node_list_t list, const uint32_t i)
+{
+    assert(i < list.count);
+    return ast_node(ast, ast_list(ast, list)[i]);
+}
+
+// the whole tree is one array, children are ids into it
+static void test_flat_ast(void)
+{
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content;
+    source_t src = {0};
+    const ast_t* ast = parse_text(ctx, &src, &content, snippet);
+    assert(ast && ctx->ast == ast);
+    assert(ctx->reports->count == 0);
+    assert(sizeof(node_t) == 32);
+
+    const node_t* root = ast_node(ast, ast->root);
+    assert(root->kind == NODE_BLOCK && root->block.statement.count == 3);
+
+    const node_t* import = list_item(ast, root->block.statement, 0);
+    assert(import->kind == NODE_IMPORT && import->import_decl.modules.count == 2);
+    assert(strcmp(name_of(ast, ast_list(ast, import->import_decl.modules)[0]), "std") == 0);
+    assert(strcmp(name_of(ast, ast_list(ast, import->import_decl.modules)[1]), "math") == 0);
+
+    const node_t* type = list_item(ast, root->block.statement, 1);
+    assert(type->kind == NODE_TYPE && strcmp(name_of(ast, type->type_decl.name), "Point") == 0);
+    const node_t* point = ast_node(ast, type->type_decl.body);
+    assert(point->kind == NODE_STRUCT && point->struct_decl.member.count == 2);
+    const node_t* x = list_item(ast, point->struct_decl.member, 0);
+    assert(x->kind == NODE_VARIABLE && strcmp(name_of(ast, x->var_decl.name), "x") == 0);
+    assert(ast_node(ast, x->var_decl.value)->kind == NODE_LITERAL);
+    const node_t* y = list_item(ast, point->struct_decl.member, 1);
+    assert(y->var_decl.value == NODE_NONE);
+
+    const node_t* func = list_item(ast, root->block.statement, 2);
+    assert(func->kind == NODE_FUNC && strcmp(name_of(ast, func->func_decl.name), "add") == 0);
+    assert(func->func_decl.param_decl.count == 2 && func->func_decl.return_type == DT_INT);
+    assert(strcmp(name_of(ast, list_item(ast, func->func_decl.param_decl, 1)->var_decl.name), "b") == 0);
+
+    const node_t* body = ast_node(ast, func->func_decl.body);
+    assert(body->kind == NODE_BLOCK && body->block.statement.count == 3);
+
+    // `a + b * 2` keeps its precedence
+    const node_t* sum = list_item(ast, body->block.statement, 0);
+    const node_t* plus = ast_node(ast, sum->var_decl.value);
+    assert(plus->kind == NODE_BINOP && plus->binop.operator == OPER_PLUS);
+    assert(ast_node(ast, plus->binop.left)->kind == NODE_REFERENCE);
+    const node_t* product = ast_node(ast, plus->binop.right);
+    assert(product->kind == NODE_BINOP && product->binop.operator == OPER_ASTERISK);
+    const node_t* two = ast_node(ast, product->binop.right);
+    assert(two->lit.constant != CONST_NONE && get_constant(&ctx->literals, two->lit.constant).integer == 2);
+
+    // the elif hangs off the if, statements are created before their parts
+    const node_t* branch = list_item(ast, body->block.statement, 1);
+    assert(branch->kind == NODE_IF && branch->if_stmt.elif_blocks && !branch->if_stmt.else_block);
+    assert(ast_node(ast, branch->if_stmt.elif_blocks)->kind == NODE_IF);
+    assert(branch->if_stmt.condition > ast_list(ast, body->block.statement)[1]);
+
+    const node_t* ret = list_item(ast, body->block.statement, 2);
+    const node_t* call = ast_node(ast, ret->return_stmt.body);
+    assert(call->kind == NODE_CALL && call->func_call.args.count == 2);
+    assert(strcmp(name_of(ast, call->func_call.name), "add") == 0);
+
+    free_compiler_context(ctx);
+}
+
+// items left on the scratch stack by a failed list don't end up in the list around it
+static void test_failed_items(void)
+{
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content;
+    source_t src = {0};
+    const ast_t* ast = parse_text(ctx, &src, &content, "func f() { var a = [1, 2, 3 const b = [4, 5] }\n");
+    assert(ast && ctx->reports->count > 0);
+
+    const node_t* root = ast_node(ast, ast->root);
+    assert(root->block.statement.count == 1);
+    const node_t* body = ast_node(ast, list_item(ast, root->block.statement, 0)->func_decl.body);
+    assert(body->block.statement.count == 1);
+
+    const node_t* b = list_item(ast, body->block.statement, 0);
+    assert(b->kind == NODE_VARIABLE && strcmp(name_of(ast, b->var_decl.name), "b") == 0);
+    const node_t* array = ast_node(ast, b->var_decl.value);
+    assert(array->kind == NODE_ARRAY && array->array_decl.elements.count == 2);
+    assert(get_constant(&ctx->literals, list_item(ast, array->array_decl.elements, 0)->lit.constant).integer == 4);
+
+    // nodes of the failed array are dropped from the kind lists
+    assert(ast->kinds[NODE_ARRAY].count == 1 && ast->kinds[NODE_ARRAY].elems[0] == b->var_decl.value);
+    assert(ast->kinds[NODE_LITERAL].count == 2);
+
+    free_compiler_context(ctx);
+}
+
+// children come right before their parent, a subtree is one run of entries
+static void test_post_order(void)
+{
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content;
+    source_t src = {0};
+    const ast_t* ast = parse_text(ctx, &src, &content, snippet);
+    assert(ast && ctx->reports->count == 0);
+
+    ast_order_t order = {0};
+    assert(linearize_ast(ast, ast->root, &order));
+    assert(order.count == ast->count);
+    assert(order.entries[order.count - 1].node == ast->root && order.entries[order.count - 1].first == 0);
+
+    for(uint32_t i = 0; i < order.count; i++){
+        const ast_entry_t entry = order.entries[i];
+        assert(order.position[entry.node - 1] == i);
+        for(uint32_t c = 0; c < node_child_count(ast, entry.node); c++){
+            const node_id_t child = node_child(ast, entry.node, c);
+            if(!child) continue;
+            assert(order.position[child - 1] < i && order.entries[order.position[child - 1]].first >= entry.first);
+        }
+    }
+
+    // `a + b * 2`
+    const node_t* func = list_item(ast, ast_node(ast, ast->root)->block.statement, 2);
+    const node_t* sum = list_item(ast, ast_node(ast, func->func_decl.body)->block.statement, 0);
+    const int kinds[] = {NODE_REFERENCE, NODE_REFERENCE, NODE_LITERAL, NODE_BINOP, NODE_BINOP};
+    ast_iter_t iter = ast_subtree(&order, sum->var_decl.value);
+    size_t n = 0;
+    for(const ast_entry_t* entry; (entry = ast_iter_next(&iter)); n++){
+        assert(n < 5 && ast_node(ast, entry->node)->kind == kinds[n]);
+    }
+    assert(n == 5);
+    assert(!ast_iter_next(&iter));
+
+    free_ast_order(&order);
+    free_compiler_context(ctx);
+}
+
+typedef struct {
+    char trace[64];
+    size_t length;
+    size_t calls;
+} visit_state_t;
+
+static enum visit_action trace_pre(ast_visitor_t* visitor, const ast_t* ast, node_id_t node)
+{
+    visit_state_t* state = visitor->state;
+    state->trace[state->length++] = ast_node(ast, node)->kind == NODE_BINOP ? '(' : 'x';
+    return VISIT_CONTINUE;
+}
+
+static enum visit_action trace_post(ast_visitor_t* visitor, const ast_t* ast, node_id_t node)
+{
+    (void)ast;
+    (void)node;
+    visit_state_t* state = visitor->state;
+    state->trace[state->length++] = ')';
+    return VISIT_CONTINUE;
+}
+
+static enum visit_action skip_body(ast_visitor_t* visitor, const ast_t* ast, node_id_t node)
+{
+    (void)visitor;
+    (void)ast;
+    (void)node;
+    return VISIT_SKIP;
+}
+
+static enum visit_action stop_at_call(ast_visitor_t* visitor, const ast_t* ast, node_id_t node)
+{
+    assert(ast_node(ast, node)->kind == NODE_CALL);
+    ((visit_state_t*)visitor->state)->calls++;
+    return VISIT_STOP;
+}
+
+static enum visit_action count_call(ast_visitor_t* visitor, const ast_t* ast, node_id_t node)
+{
+    assert(ast_node(ast, node)->kind == NODE_CALL);
+    ((visit_state_t*)visitor->state)->calls++;
+    return VISIT_CONTINUE;
+}
+
+// hooks by kind, pre before post, skipped subtrees and stops
+static void test_visitor(void)
+{
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content;
+    source_t src = {0};
+    const ast_t* ast = parse_text(ctx, &src, &content, snippet);
+    assert(ast && ctx->reports->count == 0);
+
+    visit_state_t state = {0};
+    ast_visitor_t* visitor = new_ast_visitor(ctx->memory.phase_arena, &state);
+    assert(visitor);
+
+    // `a + b * 2`
+    const node_t* func = list_item(ast, ast_node(ast, ast->root)->block.statement, 2);
+    const node_t* sum = list_item(ast, ast_node(ast, func->func_decl.body)->block.statement, 0);
+    visitor->pre[NODE_BINOP] = visitor->pre[NODE_REFERENCE] = visitor->pre[NODE_LITERAL] = trace_pre;
+    visitor->post[NODE_BINOP] = trace_post;
+    assert(ast_visit(visitor, ast, sum->var_decl.value));
+    assert(strncmp(state.trace, "(x(xx))", state.length) == 0 && state.length == 7);
+
+    // the parameters and the body are left out, the struct members aren't
+    state.length = 0;
+    visitor->pre[NODE_FUNC] = skip_body;
+    visitor->pre[NODE_VARIABLE] = trace_pre;
+    assert(ast_visit(visitor, ast, ast->root));
+    assert(strncmp(state.trace, "xxx", state.length) == 0 && state.length == 3);
+
+    visitor->pre[NODE_FUNC] = NULL;
+    visitor->pre[NODE_CALL] = stop_at_call;
+    assert(!ast_visit(visitor, ast, ast->root));
+    assert(state.calls == 1 && visitor->stack.count == 0);
+
+    // only the nodes of one kind, the tree isn't walked
+    state.calls = 0;
+    visitor->pre[NODE_CALL] = count_call;
+    assert(ast_visit_kind(visitor, ast, NODE_CALL));
+    assert(state.calls == 1);
+    assert(ast->kinds[NODE_FUNC].count == 1 && ast->kinds[NODE_BINOP].count == 4);
+
+    free_ast_visitor(visitor);
+    free_compiler_context(ctx);
+}
+
+static char* repeat(const char* head, const char* part, const size_t count, const char* tail)
+{
+    const size_t part_length = strlen(part);
+    char* text = malloc(strlen(head) + part_length * count + strlen(tail) + 1);
+    assert(text);
+
+    strcpy(text, head);
+    char* p = text + strlen(head);
+    for(size_t i = 0; i < count; i++, p += part_length) memcpy(p, part, part_length);
+    strcpy(p, tail);
+    return text;
+}
+
+// too deep nesting ends the parse with one report, long chains don't recurse
+static void test_deep_nesting(void)
+{
+    const char* deep[] = {"(", "- ", "x = ", "{ ", "[", "f("};
+    for(size_t i = 0; i < sizeof(deep) / sizeof(deep[0]); i++){
+        compiler_context_t* ctx = new_compiler_context();
+        assert(ctx);
+
+        string_t content;
+        source_t src = {0};
+        char* text = repeat("var a = 1\nvar b = ", deep[i], 100000, "1\n");
+        const ast_t* ast = parse_text(ctx, &src, &content, text);
+        assert(ast);
+
+        // the lexer may report the unclosed parentheses as well
+        size_t too_deep = 0, parser_reports = 0;
+        report_iter_t it = report_iter(ctx->reports);
+        for(const report_t* report; (report = report_next(&it));){
+            too_deep += report->code == ERR_NEST_DEPTH;
+            parser_reports += report->code >= ERR_UNEXP_TOKEN;
+        }
+        assert(too_deep == 1 && parser_reports == 1);
+
+        // statements before it are kept
+        const node_t* root = ast_node(ast, ast->root);
+        assert(root->block.statement.count == 1);
+        assert(strcmp(name_of(ast, list_item(ast, root->block.statement, 0)->var_decl.name), "a") == 0);
+
+        free(text);
+        free_compiler_context(ctx);
+    }
+
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content;
+    source_t src = {0};
+    char* text = repeat("var a = x", " + x", 100000, "\n");
+    const ast_t* ast = parse_text(ctx, &src, &content, text);
+    assert(ast && ctx->reports->count == 0);
+
+    ast_order_t order = {0};
+    assert(linearize_ast(ast, ast->root, &order));
+    assert(order.count == ast->count);
+    assert(ast_node(ast, order.entries[order.count - 2].node)->kind == NODE_VARIABLE);
+
+    free_ast_order(&order);
+    free(text);
+    free_compiler_context(ctx);
+}
+
+// precedence and associativity, parenthesized and prefixed operands go on
+// into the operators after them
+static void test_expressions(void)
+{
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content;
+    source_t src = {0};
+    const ast_t* ast = parse_text(ctx, &src, &content,
+        "(a + b) * 2;\n"
+        "-x + 2;\n"
+        "a = b = c - d - e;\n"
+        "!a == b && c < d;\n"
+        "-x++");
+    assert(ast && ctx->reports->count == 0);
+
+    const node_t* root = ast_node(ast, ast->root);
+    assert(root->block.statement.count == 5);
+
+    const node_t* mul = list_item(ast, root->block.statement, 0);
+    assert(mul->kind == NODE_BINOP && mul->binop.operator == OPER_ASTERISK);
+    assert(ast_node(ast, mul->binop.left)->binop.operator == OPER_PLUS);
+
+    const node_t* add = list_item(ast, root->block.statement, 1);
+    assert(add->kind == NODE_BINOP && add->binop.operator == OPER_PLUS);
+    assert(ast_node(ast, add->binop.left)->kind == NODE_UNARYOP);
+
+    // assignment is right associative, subtraction left
+    const node_t* assign = list_item(ast, root->block.statement, 2);
+    assert(assign->binop.operator == OPER_ASSIGN);
+    const node_t* inner = ast_node(ast, assign->binop.right);
+    assert(inner->binop.operator == OPER_ASSIGN);
+    const node_t* sub = ast_node(ast, inner->binop.right);
+    assert(sub->binop.operator == OPER_MINUS && ast_node(ast, sub->binop.left)->binop.operator == OPER_MINUS);
+
+    const node_t* and = list_item(ast, root->block.statement, 3);
+    assert(and->binop.operator == OPER_AND);
+    assert(ast_node(ast, and->binop.left)->binop.operator == OPER_EQ);
+    assert(ast_node(ast, ast_node(ast, and->binop.left)->binop.left)->unaryop.operator == OPER_NOT);
+    assert(ast_node(ast, and->binop.right)->binop.operator == OPER_LANGLE);
+
+    // postfix binds tighter than prefix, and the last token ends it
+    const node_t* neg = list_item(ast, root->block.statement, 4);
+    assert(neg->kind == NODE_UNARYOP && !neg->unaryop.is_postfix);
+    assert(ast_node(ast, neg->unaryop.right)->unaryop.is_postfix);
+
+    // an operator as the last token
+    ast = parse_text(ctx, &src, &content, "var a = 1\nx = 1 +");
+    assert(ast && ast_node(ast, ast->root)->block.statement.count == 1);
+    report_iter_t it = report_iter(ctx->reports);
+    for(const report_t* report; (report = report_next(&it));) assert(report->code == ERR_EXPEC_EXPR);
+
+    free_compiler_context(ctx);
+}
+
+// the atom a node is named by, ATOM_NONE for kinds without one
+static atom_t node_name(const node_t* node)
+{
+    switch(node->kind){
+        case NODE_LITERAL:   return node->lit.value;
+        case NODE_CALL:      return node->func_call.name;
+        case NODE_ASSIGN:    return node->var_assign.name;
+        case NODE_REFERENCE: return node->var_ref.name;
+        case NODE_PARAM:     return node->param_decl.name;
+        case NODE_VARIABLE:  return node->var_decl.name;
+        case NODE_FUNC:      return node->func_decl.name;
+        case NODE_TYPE:      return node->type_decl.name;
+        default:             return ATOM_NONE;
+    }
+}
+
+static bool trees_match(const compiler_context_t* ctx_a, const compiler_context_t* ctx_b)
+{
+    const ast_t* a = ctx_a->ast;
+    const ast_t* b = ctx_b->ast;
+    if(a->count != b->count || a->root != b->root) return false;
+
+    for(node_id_t id = 1; id <= a->count; id++){
+        const node_t* x = ast_node(a, id);
+        const node_t* y = ast_node(b, id);
+        if(x->kind != y->kind || x->loc.offset != y->loc.offset || x->loc.length != y->loc.length) return false;
+
+        const atom_t name_x = node_name(x), name_y = node_name(y);
+        if((name_x == ATOM_NONE) != (name_y == ATOM_NONE)) return false;
+        if(name_x != ATOM_NONE && strcmp(name_of(a, name_x), name_of(b, name_y)) != 0) return false;
+
+        const uint32_t children = node_child_count(a, id);
+        if(children != node_child_count(b, id)) return false;
+        for(uint32_t i = 0; i < children; i++){
+            if(node_child(a, id, i) != node_child(b, id, i)) return false;
+        }
+    }
+
+    for(size_t kind = 0; kind < NUM_NODE_KINDS; kind++){
+        if(a->kinds[kind].count != b->kinds[kind].count) return false;
+        for(size_t i = 0; i < a->kinds[kind].count; i++){
+            if(a->kinds[kind].elems[i] != b->kinds[kind].elems[i]) return false;
+        }
+    }
+
+    if(ctx_a->reports->count != ctx_b->reports->count) return false;
+    report_iter_t it_a = report_iter(ctx_a->reports);
+    report_iter_t it_b = report_iter(ctx_b->reports);
+    for(const report_t* r = report_next(&it_a); r; r = report_next(&it_a)){
+        const report_t* q = report_next(&it_b);
+        if(r->code != q->code || r->loc.offset != q->loc.offset) return false;
+    }
+    return true;
+}
+
+// parses `text` sequentially and on 4 threads and compares the results
+static void check_parallel(const char* text)
+{
+    compiler_context_t* seq_ctx = new_compiler_context();
+    compiler_context_t* par_ctx = new_compiler_context();
+    assert(seq_ctx && par_ctx);
+
+    string_t content = {.data = text, .length = strlen(text)};
+    source_t seq_src = {.content = &content};
+    source_t par_src = {.content = &content};
+    seq_ctx->src_manager.current = &seq_src;
+    par_ctx->src_manager.current = &par_src;
+
+    token_buffer_t* seq_tokens = new_token_buffer(new_lexer(seq_ctx));
+    token_buffer_t* par_tokens = new_token_buffer(new_lexer(par_ctx));
+    assert(seq_tokens && par_tokens && par_tokens->count > PARSER_SPAN_MIN * 2);
+
+    assert(parse_program(new_buffered_parser(seq_ctx, seq_tokens)));
+    assert(parse_program_parallel(new_buffered_parser(par_ctx, par_tokens), 4));
+    assert(trees_match(seq_ctx, par_ctx));
+
+    free_token_buffer(seq_tokens);
+    free_token_buffer(par_tokens);
+    seq_ctx->src_manager.current = NULL;
+    par_ctx->src_manager.current = NULL;
+    free_compiler_context(seq_ctx);
+    free_compiler_context(par_ctx);
+}
+
+// spans joined into one tree with their errors, and a file parsed
+// sequentially again because one span ended the parse early
+static void test_parallel(void)
+{
+    const size_t funcs = 8000;
+    char* text = malloc(funcs * 160);
+    assert(text);
+
+    size_t length = 0;
+    for(size_t i = 0; i < funcs; i++){
+        length += (size_t)sprintf(text + length,
+            "func f%zu(a: int, b: int): int {\n"
+            "    var s = a + b * %zu\n"
+            "    if(s > 10){ return s }\n"
+            "    return f%zu(s, 1.5)\n"
+            "}\n", i, i, i / 2);
+        if(i % 7 == 0) length += (size_t)sprintf(text + length, "type P%zu: struct { var x: float = 0.0 }\n", i);
+    }
+    check_parallel(text);
+
+    // missing parens and stray closing braces
+    length = 0;
+    for(size_t i = 0; i < funcs * 2; i++){
+        length += (size_t)sprintf(text + length, "func g%zu(a: int {\n    var = ) }\n", i);
+        if(i % 3 == 0) length += (size_t)sprintf(text + length, "if(a){ b = 1 }}\n");
+    }
+    check_parallel(text);
+
+    // too deep nesting halfway skips the rest of the input
+    length = 0;
+    for(size_t i = 0; i < funcs * 3; i++){
+        length += (size_t)sprintf(text + length, "func h%zu() { return %zu }\n", i, i);
+        if(i == funcs){
+            memset(text + length, '(', PARSER_MAX_DEPTH * 2);
+            memset(text + length + PARSER_MAX_DEPTH * 2, ')', PARSER_MAX_DEPTH * 2);
+            length += PARSER_MAX_DEPTH * 4;
+            text[length++] = '\n';
+        }
+    }
+    text[length] = '\0';
+    check_parallel(text);
+
+    free(text);
+}
+
+// parse throughput over a buffer of long expressions
+static void bench_expressions(void)
+{
+    static const char* line = "x = (a + b) * c - d / 2 + f(y, z * 3) - -w % 7 < n && !m || k++ >= 1\n";
+    const size_t line_length = strlen(line);
+    const size_t copies = BENCH_SIZE / line_length;
+
+    char* text = malloc(copies * line_length + 1);
+    assert(text);
+    for(size_t i = 0; i < copies; i++) memcpy(text + i * line_length, line, line_length);
+    text[copies * line_length] = '\0';
+
+    compiler_context_t* ctx = new_compiler_context();
+    assert(ctx);
+
+    string_t content = {.data = text, .length = copies * line_length};
+    source_t src = {.content = &content};
+    ctx->src_manager.current = &src;
+    ctx->options.dump_tokens = false; // 4MB of tokens, only the parse is measured
+
+    token_buffer_t* buffer = new_token_buffer(new_lexer(ctx));
+    assert(buffer);
+
+    // the tree is gone after the rewind, its size is kept for the throughput
+    size_t nodes = 0;
+
+    bm_reset();
+    for(int i = 0; i < BENCH_RUNS; i++){
+        arena_mark_t mark = arena_mark(ctx->memory.phase_arena);
+        bm_start();
+        const ast_t* ast = parse_program(new_buffered_parser(ctx, buffer));
+        bm_stop();
+        assert(ast && ast_node(ast, ast->root)->block.statement.count == copies);
+        assert(ctx->reports->count == 0);
+        nodes = ast->count;
+        arena_rewind(ctx->memory.phase_arena, mark);
+    }
+
+    double best = times[0];
+    for(int i = 1; i < time_count; i++){
+        if(times[i] < best) best = times[i];
+    }
+    bm_print("Expression parsing (4MB)");
+    printf("\033[1mThroughput: \033[0;90m%.1f MB/s, %.1f M tokens/s, %.1f M nodes/s\033[0m\n",
+           (double)content.length / (1024.0 * 1024.0) / best, (double)buffer->count / 1e6 / best,
+           (double)nodes / 1e6 / best);
+
+    free_token_buffer(buffer);
+    ctx->src_manager.current = NULL;
+    free_compiler_context(ctx);
+    free(text);
+}
+
 int main(void)
 {
     bm_start();
 
+    test_flat_ast();
+    test_failed_items();
+    test_post_order();
+    test_visitor();
+    test_deep_nesting();
+    test_expressions();
+    test_parallel();
+
     bm_stop();
     bm_print("Test parser");
+
+    bench_expressions();
     return 0;
 }
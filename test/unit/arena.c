@@ -5,6 +5,9 @@
 #include "core/ds/arena.h"
 #include "../utils/benchmark.h"
 
+#define BULK_COUNT 1000000
+#define NODE_SIZE  48
+
 int main(void)
 {
     bm_start();
@@ -29,9 +32,153 @@ int main(void)
     printf("Number: %d\n", *num1);
     printf("String: %s\n", str1);
 
+    // rewind releases everything allocated after the mark, including extra blocks
+    size_t used = arena_used(arena);
+    arena_mark_t mark = arena_mark(arena);
+    for(int i = 0; i < 64; i++){
+        assert(arena_alloc_default(arena, 128) != NULL);
+    }
+    assert(arena->current != mark.block);
+    arena_rewind(arena, mark);
+    assert(arena_used(arena) == used);
+    assert(arena->current == mark.block);
+    assert(*num1 == 42);
+
+    // released blocks are reused instead of growing the chain
+    size_t capacity = arena_capacity(arena);
+    for(int i = 0; i < 64; i++){
+        assert(arena_alloc_default(arena, 128) != NULL);
+    }
+    assert(arena_capacity(arena) == capacity);
+
     free_arena(arena);
 
+    // nested scratch arenas never alias each other
+    arena_scratch_t outer = arena_scratch_begin(NULL);
+    arena_scratch_t inner = arena_scratch_begin(outer.arena);
+    assert(outer.arena && inner.arena && outer.arena != inner.arena);
+    assert(arena_alloc_default(inner.arena, 64) != NULL);
+    arena_scratch_end(inner);
+    assert(arena_used(inner.arena) == inner.mark.offset);
+    arena_scratch_end(outer);
+    free_scratch_arenas();
+
     bm_stop();
     bm_print("Arena tests");
+
+    arena = new_arena(ARENA_DEF_SIZE);
+    char* zeroed = arena_alloc_zeroed(arena, 32, alignof(char));
+    for(int i = 0; i < 32; i++) assert(zeroed[i] == 0);
+    char* copy = arena_push_bytes(arena, "Hello", 6);
+    assert(copy && strcmp(copy, "Hello") == 0);
+
+    // the last allocation resizes in place, older ones are copied
+    char* top = arena_alloc_uninit(arena, 16, alignof(char));
+    memcpy(top, "resize", 7);
+    assert(arena_is_top(arena, top, 16));
+    assert(arena_resize(arena, top, 16, 64, alignof(char)) == top);
+    assert(arena_resize(arena, top, 64, 8, alignof(char)) == top);
+    assert(arena_is_top(arena, top, 8));
+    char* moved = arena_resize(arena, copy, 6, 32, alignof(char));
+    assert(moved != copy && strcmp(moved, "Hello") == 0);
+    free_arena(arena);
+
+    // freed blocks go to the process-wide cache and come back on the next arena
+    free_arena_cache();
+    arena = new_arena(ARENA_TEMP_SIZE);
+    unsigned char* block_data = arena->head->data;
+    free_arena(arena);
+    assert(arena_cache_size() == ARENA_TEMP_SIZE);
+    arena = new_arena(ARENA_TEMP_SIZE);
+    assert(arena->head->data == block_data);
+    assert(arena_cache_size() == 0);
+    free_arena(arena);
+    arena = new_arena(ARENA_DEF_SIZE);  // too small to take the cached block
+    assert(arena_cache_size() == ARENA_TEMP_SIZE);
+    free_arena(arena);
+    free_arena_cache();
+    assert(arena_cache_size() == 0);
+
+    // virtual memory arena: one contiguous block, committed on demand
+    arena = new_vm_arena(ARENA_VM_RESERVE, false);
+    assert(arena != NULL);
+    assert(arena_capacity(arena) == ARENA_VM_COMMIT);
+    char* first = arena_alloc_uninit(arena, 16, alignof(char));
+    char* big = arena_alloc_uninit(arena, 3 * ARENA_VM_COMMIT, alignof(char));
+    assert(big == first + 16);
+    memset(big, 0xab, 3 * ARENA_VM_COMMIT);
+    assert(arena->head->next == NULL);
+    assert(arena_used(arena) == 16 + 3 * ARENA_VM_COMMIT);
+    assert(arena_capacity(arena) == 4 * ARENA_VM_COMMIT);
+
+    arena_clear(arena);
+    assert(arena_used(arena) == 0);
+    char* again = arena_alloc_uninit(arena, 2 * ARENA_VM_COMMIT, alignof(char));
+    assert(again == first);
+    assert(again[ARENA_VM_COMMIT + 1] == 0);  // released pages read back as zero
+    assert(arena_capacity(arena) == 4 * ARENA_VM_COMMIT);
+    free_arena(arena);
+
+    arena = new_vm_arena(ARENA_VM_RESERVE, true);
+    assert(arena != NULL && arena_capacity(arena) == ARENA_VM_HUGE);
+    free_arena(arena);
+
+    // allocation rate of node-sized objects, zeroed vs uninitialised
+    bm_reset();
+    bm_start();
+    arena = new_arena(ARENA_PERM_SIZE);
+    for(int i = 0; i < BULK_COUNT; i++){
+        assert(arena_alloc_zeroed(arena, NODE_SIZE, alignof(void*)) != NULL);
+    }
+    free_arena(arena);
+    bm_stop();
+    bm_print("Arena zeroed allocations (1M x 48 bytes)");
+
+    bm_reset();
+    bm_start();
+    arena = new_arena(ARENA_PERM_SIZE);
+    for(int i = 0; i < BULK_COUNT; i++){
+        assert(arena_alloc_uninit(arena, NODE_SIZE, alignof(void*)) != NULL);
+    }
+    free_arena(arena);
+    bm_stop();
+    bm_print("Arena uninitialised allocations (1M x 48 bytes)");
+
+    // string copies, zero-then-copy vs a single copy
+    static const char ident[] = "some_identifier_name";
+    bm_reset();
+    bm_start();
+    arena = new_arena(ARENA_PERM_SIZE);
+    for(int i = 0; i < BULK_COUNT; i++){
+        char* dst = arena_alloc_zeroed(arena, sizeof(ident), alignof(char));
+        memcpy(dst, ident, sizeof(ident));
+    }
+    free_arena(arena);
+    bm_stop();
+    bm_print("Arena zeroed string copies (1M)");
+
+    bm_reset();
+    bm_start();
+    arena = new_arena(ARENA_PERM_SIZE);
+    for(int i = 0; i < BULK_COUNT; i++){
+        assert(arena_push_bytes(arena, ident, sizeof(ident)) != NULL);
+    }
+    free_arena(arena);
+    bm_stop();
+    bm_print("Arena pushed string copies (1M)");
+
+    // repeated compilations: arenas created and freed in a loop
+    free_arena_cache();
+    bm_reset();
+    bm_start();
+    for(int i = 0; i < 1000; i++){
+        arena = new_arena(ARENA_PERM_SIZE);
+        for(int j = 0; j < 16; j++) arena_alloc_uninit(arena, ARENA_PERM_SIZE / 2, alignof(void*));
+        free_arena(arena);
+    }
+    bm_stop();
+    bm_print("Arena create/fill/free (1000 x 512KB)");
+    free_arena_cache();
+
     return 0;
 }
@@ -1,13 +1,31 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
 #include "core/ds/hashmap.h"
 
 #include "../utils/benchmark.h"
 
+#define BULK_COUNT 100000
+#define HASH_ROUNDS 20
+
+// byte-at-a-time FNV-1a, the previous hash, kept as the benchmark baseline
+static uint32_t fnv1a(const char* str, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < length; i++){
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 int main(void)
 {
     bm_start();
 
     hashmap_t* table = new_hashmap();
-    
+
     char* keys[] = {"apple", "banana", "orange", "grape", "melon"};
     char* values[] = {"red", "yellow", "orange", "purple", "green"};
 
@@ -25,10 +43,92 @@ int main(void)
         }
     }
 
+    hm_delete(table, "banana");
+    assert(hm_lookup(table, "banana") == NULL);
+    assert(hm_lookup(table, "grape") != NULL);
+    assert(table->count == 4);
+
+    size_t visited = 0;
+    hm_iter_t it = hm_iter(table);
+    while(hm_next(&it, NULL, NULL)) visited++;
+    assert(visited == table->count);
+
     free_hashmap(table);
 
+    // atom keys
+    table = new_hashmap();
+    for(atom_t atom = 1; atom <= 64; atom++){
+        hm_insert_atom(table, atom, &keys[atom % 5]);
+    }
+    assert(hm_lookup_atom(table, 7) == &keys[2]);
+    assert(hm_delete_atom(table, 7));
+    assert(hm_lookup_atom(table, 7) == NULL);
+    assert(hm_lookup_atom(table, 65) == NULL);
+    free_hashmap(table);
+
+    // hashing goes by length, the NUL-terminated form must agree
+    assert(hm_hash("banana") == hm_hash_n("banana!", 6));
+    assert(hm_hash_n("ab", 2) != hm_hash_n("ba", 2));
+    assert(hm_hash_n("abcd", 4) != hm_hash_n("abcd", 3));
+    const string_t a = {"melon", 5, hm_hash("melon"), ATOM_NONE};
+    const string_t b = {"melons", 5, hm_hash_n("melons", 5), ATOM_NONE};
+    const string_t c = {"lemon", 5, hm_hash("lemon"), ATOM_NONE};
+    assert(string_equal(a, b) && !string_equal(a, c));
+
     bm_stop();
     bm_print("Test hash table");
 
+    // bulk insert/lookup/delete of generated identifiers
+    static char names[BULK_COUNT][16];
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        snprintf(names[i], sizeof(names[i]), "ident_%zu", i);
+    }
+
+    bm_reset();
+    bm_start();
+
+    table = new_hashmap();
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        hm_insert(table, names[i], names[i]);
+    }
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        assert(hm_lookup(table, names[i]) == names[i]);
+    }
+    for(size_t i = 0; i < BULK_COUNT; i += 2){
+        hm_delete(table, names[i]);
+    }
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        assert((hm_lookup(table, names[i]) != NULL) == (i % 2 == 1));
+    }
+    assert(table->count == BULK_COUNT / 2);
+    free_hashmap(table);
+
+    bm_stop();
+    bm_print("Test hash table (100k identifiers)");
+
+    // hash kernels over identifier-length strings
+    static size_t lengths[BULK_COUNT];
+    for(size_t i = 0; i < BULK_COUNT; i++) lengths[i] = strlen(names[i]);
+
+    volatile uint32_t sink = 0;
+
+    bm_reset();
+    bm_start();
+    for(int r = 0; r < HASH_ROUNDS; r++){
+        for(size_t i = 0; i < BULK_COUNT; i++) sink ^= fnv1a(names[i], lengths[i]);
+    }
+    bm_stop();
+    bm_print("Hash FNV-1a, byte at a time (2M identifiers)");
+
+    bm_reset();
+    bm_start();
+    for(int r = 0; r < HASH_ROUNDS; r++){
+        for(size_t i = 0; i < BULK_COUNT; i++) sink ^= hm_hash_n(names[i], lengths[i]);
+    }
+    bm_stop();
+    bm_print("Hash hm_hash_n, word at a time (2M identifiers)");
+
+    (void)sink;
+
     return 0;
 }
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <assert.h>
+
+#include "core/ds/arena.h"
+#include "core/ds/pool.h"
+
+#include "../utils/benchmark.h"
+
+#define BULK_COUNT 1000000
+
+typedef struct {
+    int id;
+    double weight;
+    void* next;
+} record_t;
+
+POOL_DEFINE(record, record_t)
+
+int main(void)
+{
+    bm_start();
+
+    arena_t* arena = new_arena(ARENA_DEF_SIZE);
+    record_pool_t pool = new_record_pool(arena);
+
+    record_t* records[POOL_SLAB_COUNT * 3];
+    for(size_t i = 0; i < POOL_SLAB_COUNT * 3; i++){
+        records[i] = record_pool_alloc(&pool);
+        assert(records[i] != NULL);
+        assert((size_t)records[i] % alignof(record_t) == 0);
+        records[i]->id = (int)i;
+    }
+    assert(pool.live == POOL_SLAB_COUNT * 3);
+
+    // records of one slab are adjacent
+    assert(records[1] == records[0] + 1);
+
+    // released records come back before the slab grows, last released first
+    record_pool_release(&pool, records[10]);
+    record_pool_release(&pool, records[20]);
+    assert(pool.live == POOL_SLAB_COUNT * 3 - 2);
+    assert(record_pool_alloc(&pool) == records[20]);
+    assert(record_pool_alloc(&pool) == records[10]);
+    assert(records[5]->id == 5);
+
+    size_t used = arena_used(arena);
+    for(size_t i = 0; i < POOL_SLAB_COUNT * 3; i++) record_pool_release(&pool, records[i]);
+    for(size_t i = 0; i < POOL_SLAB_COUNT * 3; i++) records[i] = record_pool_alloc(&pool);
+    assert(arena_used(arena) == used);
+    assert(pool.live == POOL_SLAB_COUNT * 3);
+
+    free_arena(arena);
+
+    bm_stop();
+    bm_print("Test pool");
+
+    // churn: allocate a batch, release it, allocate again
+    static record_t* batch[1024];
+
+    bm_reset();
+    bm_start();
+
+    arena = new_arena(ARENA_PERM_SIZE);
+    pool = new_record_pool(arena);
+    for(size_t i = 0; i < BULK_COUNT / 1024; i++){
+        for(size_t j = 0; j < 1024; j++){
+            batch[j] = record_pool_alloc(&pool);
+            batch[j]->id = (int)j;
+        }
+        for(size_t j = 0; j < 1024; j++) record_pool_release(&pool, batch[j]);
+    }
+    assert(pool.live == 0);
+    printf("Pool arena footprint: %zu bytes\n", arena_used(arena));
+    free_arena(arena);
+
+    bm_stop();
+    bm_print("Pool alloc/release (1M records, 1024 live)");
+
+    bm_reset();
+    bm_start();
+
+    arena = new_arena(ARENA_PERM_SIZE);
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        record_t* record = arena_alloc_uninit(arena, sizeof(record_t), alignof(record_t));
+        record->id = (int)i;
+    }
+    printf("Arena footprint: %zu bytes\n", arena_used(arena));
+    free_arena(arena);
+
+    bm_stop();
+    bm_print("Arena alloc (1M records, no reuse)");
+
+    return 0;
+}
@@ -1,8 +1,13 @@
+#include <stdio.h>
+#include <assert.h>
+
 #include "core/ds/arena.h"
 #include "core/ds/strings.h"
 
 #include "../utils/benchmark.h"
 
+#define BULK_COUNT 100000
+
 int main(void)
 {
     bm_start();
@@ -12,15 +17,49 @@ int main(void)
     string_t str1 = new_string(&pool, "Hello, World!");
     string_t str2 = new_string(&pool, "Hello, World!"); // Should reuse the same string
     string_t str3 = new_string(&pool, "Goodbye!");
+    string_t str4 = new_string_n(&pool, "Goodbye!", 4);  // Prefix is a distinct string
 
     printf("String 1: %s (hash: %u)\n", str1.data, str1.hash);
     printf("String 2: %s (hash: %u)\n", str2.data, str2.hash);
     printf("String 3: %s (hash: %u)\n", str3.data, str3.hash);
 
+    assert(str1.data == str2.data);
+    assert(str1.data != str3.data);
+    assert(str4.length == 4 && str4.data != str3.data);
+    assert(pool.count == 3);
+
+    assert(str1.atom == str2.atom && str1.atom != str3.atom);
+    assert(sp_atom_str(&pool, str3.atom).data == str3.data);
+    assert(sp_lookup_n(&pool, "Goodbye!", 8) == str3.atom);
+    assert(sp_lookup_n(&pool, "Missing", 7) == ATOM_NONE);
+
     free_string_pool(&pool);
 
     bm_stop();
     bm_print("Test string pool");
 
+    // interning generated identifiers, every name seen twice
+    static char names[BULK_COUNT][16];
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        snprintf(names[i], sizeof(names[i]), "ident_%zu", i);
+    }
+
+    bm_reset();
+    bm_start();
+
+    pool = new_string_pool(ARENA_PERM_SIZE);
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        new_string(&pool, names[i]);
+    }
+    for(size_t i = 0; i < BULK_COUNT; i++){
+        string_t s = new_string(&pool, names[i]);
+        assert(s.data == pool.elements[i].data);
+    }
+    assert(pool.count == BULK_COUNT);
+    free_string_pool(&pool);
+
+    bm_stop();
+    bm_print("Test string pool (100k identifiers)");
+
     return 0;
 }
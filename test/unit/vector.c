@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <assert.h>
+
+#include "core/ds/arena.h"
+#include "core/ds/vector.h"
+
+#include "../utils/benchmark.h"
+
+#define BULK_COUNT 1000000
+
+VECTOR_DEFINE(ints, int)
+
+int main(void)
+{
+    bm_start();
+
+    arena_t* arena = new_arena(ARENA_DEF_SIZE);
+    arena_t* perm = new_arena(ARENA_DEF_SIZE);
+
+    // arena vector, nothing else allocated in between so it grows in place
+    ints_t vec = {0};
+    assert(ints_push(arena, &vec, 1));
+    int* first = vec.elems;
+    assert(vec.capacity == VECTOR_DEF_CAPACITY);
+    for(int i = 2; i <= 100; i++) assert(ints_push(arena, &vec, i));
+    assert(vec.count == 100 && vec.capacity == 128);
+    for(int i = 0; i < 100; i++) assert(vec.elems[i] == i + 1);
+
+    // an interleaved allocation forces the next growth to copy
+    ints_t other = {0};
+    assert(ints_push(arena, &other, 7));
+    for(int i = 101; i <= 200; i++) assert(ints_push(arena, &vec, i));
+    assert(vec.elems != first);
+    for(int i = 0; i < 200; i++) assert(vec.elems[i] == i + 1);
+
+    // finalize into another arena at the exact size
+    assert(ints_shrink_to_fit(perm, &vec));
+    assert(vec.count == 200 && vec.capacity == 200);
+    assert(arena_used(perm) == 200 * sizeof(int));
+    for(int i = 0; i < 200; i++) assert(vec.elems[i] == i + 1);
+
+    // trimming the last allocation of an arena gives the tail back
+    ints_t tail = {0};
+    assert(ints_push(arena, &tail, 3));
+    size_t used = arena_used(arena);
+    assert(ints_shrink_to_fit(arena, &tail));
+    assert(tail.capacity == 1 && arena_used(arena) == used - (VECTOR_DEF_CAPACITY - 1) * sizeof(int));
+    ints_free(arena, &tail);
+    assert(tail.elems == NULL && arena_used(arena) == used - VECTOR_DEF_CAPACITY * sizeof(int));
+
+    free_arena(perm);
+    free_arena(arena);
+
+    // heap vector
+    ints_t heap = {0};
+    for(int i = 0; i < 1000; i++) assert(ints_push(NULL, &heap, i));
+    assert(ints_shrink_to_fit(NULL, &heap) && heap.capacity == 1000);
+    assert(heap.elems[999] == 999);
+    ints_free(NULL, &heap);
+    assert(heap.elems == NULL && heap.count == 0);
+
+    bm_stop();
+    bm_print("Test vector");
+
+    bm_reset();
+    bm_start();
+
+    arena = new_arena(ARENA_PERM_SIZE);
+    vec = (ints_t){0};
+    for(int i = 0; i < BULK_COUNT; i++) ints_push(arena, &vec, i);
+    assert(vec.count == BULK_COUNT);
+    printf("Arena footprint: %zu bytes\n", arena_used(arena));
+    free_arena(arena);
+
+    bm_stop();
+    bm_print("Vector push, arena (1M ints)");
+
+    bm_reset();
+    bm_start();
+
+    heap = (ints_t){0};
+    for(int i = 0; i < BULK_COUNT; i++) ints_push(NULL, &heap, i);
+    assert(heap.count == BULK_COUNT);
+    ints_free(NULL, &heap);
+
+    bm_stop();
+    bm_print("Vector push, heap (1M ints)");
+
+    return 0;
+}